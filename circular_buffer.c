@@ -6,9 +6,43 @@
  * @author Jacob Smith
  */
 
+// The library always defines the out of line functions
+#undef CIRCULAR_BUFFER_INLINE
+
 // Header
 #include <circular_buffer/circular_buffer.h>
 
+// Internal
+#include "circular_buffer_internal.h"
+
+// circular buffer consumer
+#include <circular_buffer/consumer.h>
+
+// Function declarations
+/** !
+ * Discard expired elements from a time windowed circular buffer. The caller must hold the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param now               the current time
+ *
+ * @return the quantity of discarded elements
+ */
+static size_t circular_buffer_expire_unlocked ( circular_buffer *const p_circular_buffer, timestamp now );
+
+/** !
+ * Copy values out of a circular buffer without removing them. The caller
+ * must hold the lock, and index + count must not exceed the quantity of
+ * values.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param index             the position of the first value, counting from the oldest
+ * @param pp_data           result
+ * @param count             the quantity of values
+ *
+ * @return void
+ */
+static void circular_buffer_copy_unlocked ( const circular_buffer *const p_circular_buffer, size_t index, void **pp_data, size_t count );
+
 // Function definitions
 int circular_buffer_create ( circular_buffer **const pp_circular_buffer )
 {
@@ -72,16 +106,16 @@ int circular_buffer_construct ( circular_buffer **const pp_circular_buffer, size
 	if ( circular_buffer_create(&p_circular_buffer) == 0 ) goto failed_to_create_circular_buffer;
 
 	// Grow the circular buffer
-	p_circular_buffer = CIRCULAR_BUFFER_REALLOC(p_circular_buffer, sizeof(circular_buffer) * ( size * sizeof(void *) ));
+	p_circular_buffer = CIRCULAR_BUFFER_REALLOC(p_circular_buffer, sizeof(circular_buffer) + CIRCULAR_BUFFER_STORAGE_SIZE(size));
 
 	// Error check
 	if ( p_circular_buffer == (void *) 0 ) goto no_mem;
 
-	// Store the size of the circular buffer
-	p_circular_buffer->length = size;
+	// The entries follow the struct
+	if ( circular_buffer_init(p_circular_buffer, p_circular_buffer + 1, size) == 0 ) goto failed_to_create_mutex;
 
-	// Create a mutex
-    if ( mutex_create(&p_circular_buffer->_lock) == 0 ) goto failed_to_create_mutex;
+	// The circular buffer owns its memory
+	p_circular_buffer->allocated = true;
 
 	// Return a pointer to the caller
 	*pp_circular_buffer = p_circular_buffer;
@@ -143,6 +177,62 @@ int circular_buffer_construct ( circular_buffer **const pp_circular_buffer, size
 	}
 }
 
+int circular_buffer_init ( circular_buffer *const p_circular_buffer, void *const p_storage, size_t size )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_storage         == (void *) 0 ) goto no_storage;
+	if ( size              ==          0 ) goto no_size;
+
+	// Zero set
+	memset(p_circular_buffer, 0, sizeof(circular_buffer));
+
+	// Touch every page of the storage, so the hot path never faults
+	memset(p_storage, 0, CIRCULAR_BUFFER_STORAGE_SIZE(size));
+
+	// Populate the struct
+	p_circular_buffer->length  = size;
+	p_circular_buffer->_p_data = p_storage;
+
+	// Create the lock
+	circular_buffer_lock_init(&p_circular_buffer->_lock, CIRCULAR_BUFFER_LOCK_DEFAULT_SPIN);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_storage:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_storage\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_size:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"size\" must be greater than zero in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
 int circular_buffer_from_contents ( circular_buffer **const pp_circular_buffer, const void *const *pp_contents, size_t size )
 {
 
@@ -204,23 +294,149 @@ int circular_buffer_from_contents ( circular_buffer **const pp_circular_buffer,
 	}
 }
 
-bool circular_buffer_empty ( circular_buffer *const p_circular_buffer )
+int circular_buffer_construct_timed ( circular_buffer **const pp_circular_buffer, size_t size, timestamp ttl )
 {
-	
+
 	// Argument check
-	if ( p_circular_buffer == (void *)0 ) goto no_circular_buffer;
+	if ( pp_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( ttl                <=          0 ) goto no_ttl;
 
-	// Lock
-	mutex_lock(&p_circular_buffer->_lock);
+	// Initialized data
+	circular_buffer *p_circular_buffer = (void *) 0;
+
+	// Construct a circular buffer
+	if ( circular_buffer_construct(&p_circular_buffer, size) == 0 ) goto failed_to_construct_circular_buffer;
+
+	// Allocate a timestamp for each entry
+	p_circular_buffer->_p_timestamps = CIRCULAR_BUFFER_REALLOC(0, size * sizeof(timestamp));
+
+	// Error check
+	if ( p_circular_buffer->_p_timestamps == (void *) 0 ) goto no_mem;
+
+	// Store the lifetime of an element
+	p_circular_buffer->ttl = ttl;
+
+	// Route inline operations to the library
+	p_circular_buffer->features |= CIRCULAR_BUFFER_FEATURE_TIMED;
+
+	// Return a pointer to the caller
+	*pp_circular_buffer = p_circular_buffer;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_ttl:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"ttl\" must be greater than zero in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			failed_to_construct_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Failed to construct circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n",__FUNCTION__);
+				#endif
+
+				// Clean up
+				circular_buffer_destroy(&p_circular_buffer);
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+static void circular_buffer_copy_unlocked ( const circular_buffer *const p_circular_buffer, size_t index, void **pp_data, size_t count )
+{
 
 	// Initialized data
-	bool ret = ( p_circular_buffer->full == false && p_circular_buffer->read == p_circular_buffer->write );
+	size_t start = ( p_circular_buffer->read + index ) % p_circular_buffer->length,
+	       first = p_circular_buffer->length - start;
 
-	// Unlock
-	mutex_unlock(&p_circular_buffer->_lock);
+	// Clamp
+	if ( first > count ) first = count;
+
+	// Copy the values on both sides of the wrap point
+	memcpy(pp_data, &p_circular_buffer->_p_data[start], first * sizeof(void *));
+	memcpy(pp_data + first, p_circular_buffer->_p_data, ( count - first ) * sizeof(void *));
+
+	// Done
+	return;
+}
+
+static size_t circular_buffer_expire_unlocked ( circular_buffer *const p_circular_buffer, timestamp now )
+{
+
+	// Initialized data
+	size_t count   = circular_buffer_count_unlocked(p_circular_buffer),
+	       expired = 0;
+
+	// Advance the read index past each stale element
+	while ( expired < count && now - p_circular_buffer->_p_timestamps[p_circular_buffer->read] >= p_circular_buffer->ttl )
+	{
+
+		// Drop the key
+		if ( p_circular_buffer->_p_coalesce ) circular_buffer_coalesce_forget(p_circular_buffer, p_circular_buffer->read);
+
+		// Return the bytes
+		if ( p_circular_buffer->_p_budget ) circular_buffer_budget_release(p_circular_buffer, p_circular_buffer->read);
+
+		// Update the read index
+		CIRCULAR_BUFFER_STORE(p_circular_buffer->read, ( p_circular_buffer->read + 1 ) % p_circular_buffer->length);
+
+		// Increment the counter
+		expired++;
+	}
+
+	// Clear the full flag
+	if ( expired ) CIRCULAR_BUFFER_STORE(p_circular_buffer->full, false);
+
+	// Backpressure
+	if ( expired ) circular_buffer_watermark_check(p_circular_buffer);
+
+	// Success
+	return expired;
+}
+
+bool circular_buffer_empty ( circular_buffer *const p_circular_buffer )
+{
 	
+	// Argument check
+	if ( p_circular_buffer == (void *)0 ) goto no_circular_buffer;
+
+	// Spilled elements are still in the circular buffer
+	if ( circular_buffer_spill_pending(p_circular_buffer) ) return false;
+
 	// Success
-	return ret;
+	return CIRCULAR_BUFFER_LOAD(p_circular_buffer->full) == false && CIRCULAR_BUFFER_LOAD(p_circular_buffer->read) == CIRCULAR_BUFFER_LOAD(p_circular_buffer->write);
 	
 	// Error handling
 	{
@@ -244,17 +460,8 @@ bool circular_buffer_full ( circular_buffer *const p_circular_buffer )
 	// Argument check
 	if ( p_circular_buffer == (void *)0 ) goto no_circular_buffer;
 
-	// Lock
-	mutex_lock(&p_circular_buffer->_lock);
-
-	// Initialized data
-	bool ret = p_circular_buffer->full;
-
-	// Unlock
-	mutex_unlock(&p_circular_buffer->_lock);
-	
 	// Success
-	return ret;
+	return CIRCULAR_BUFFER_LOAD(p_circular_buffer->full);
 	
 	// Error handling
 	{
@@ -272,46 +479,23 @@ bool circular_buffer_full ( circular_buffer *const p_circular_buffer )
 	}
 }
 
-int circular_buffer_push ( circular_buffer *const p_circular_buffer, void *p_data )
+size_t circular_buffer_size ( circular_buffer *const p_circular_buffer )
 {
 
 	// Argument check
 	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
-	if ( p_data            == (void *) 0 ) goto no_data;
-		
-	// Lock
-	mutex_lock(&p_circular_buffer->_lock);
-
-	// Store the element
-	p_circular_buffer->_p_data[p_circular_buffer->write] = p_data;
 
-	// Update the write index
-	p_circular_buffer->write = ( p_circular_buffer->write + 1 ) % p_circular_buffer->length;
-
-	// Handle overflows
-	if ( p_circular_buffer->full ) goto overflow;
-
-	// Update the full flag
-	p_circular_buffer->full = ( p_circular_buffer->read == p_circular_buffer->write );
+	// Initialized data
+	size_t length = p_circular_buffer->length,
+	       read   = CIRCULAR_BUFFER_LOAD(p_circular_buffer->read),
+	       write  = CIRCULAR_BUFFER_LOAD(p_circular_buffer->write),
+	       spilt  = circular_buffer_spill_pending(p_circular_buffer);
 
-	// Unlock
-	mutex_unlock(&p_circular_buffer->_lock);
+	// Full
+	if ( CIRCULAR_BUFFER_LOAD(p_circular_buffer->full) ) return length + spilt;
 
 	// Success
-	return 1;
-
-	overflow:
-	{
-
-		// Update the read index
-		p_circular_buffer->read = ( p_circular_buffer->read + 1 ) % p_circular_buffer->length;
-
-		// Unlock
-		mutex_unlock(&p_circular_buffer->_lock);
-
-		// Success
-		return 1;
-	}
+	return ( write + length - read ) % length + spilt;
 
 	// Error handling
 	{
@@ -325,10 +509,27 @@ int circular_buffer_push ( circular_buffer *const p_circular_buffer, void *p_dat
 
 				// Error
 				return 0;
+		}
+	}
+}
 
-			no_data:
+size_t circular_buffer_capacity ( circular_buffer *const p_circular_buffer )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+
+	// Success
+	return p_circular_buffer->length;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
 				#ifndef NDEBUG
-					log_error("[circular buffer] Null pointer provided for parameter \"p_data\" in call to function \"%s\"\n", __FUNCTION__);
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
 				#endif
 
 				// Error
@@ -337,38 +538,40 @@ int circular_buffer_push ( circular_buffer *const p_circular_buffer, void *p_dat
 	}
 }
 
-int circular_buffer_peek ( circular_buffer *const p_circular_buffer, void **pp_data )
+size_t circular_buffer_count_since ( circular_buffer *const p_circular_buffer, timestamp t )
 {
 
 	// Argument check
-	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
-	if ( pp_data           == (void *) 0 ) goto no_data;
+	if ( p_circular_buffer                == (void *) 0 ) goto no_circular_buffer;
+	if ( p_circular_buffer->_p_timestamps == (void *) 0 ) goto not_timed;
 
 	// Lock
-	mutex_lock(&p_circular_buffer->_lock);
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
 
-	// State check
-	if ( p_circular_buffer->read == p_circular_buffer->write ) goto circular_buffer_empty;
+	// Initialized data
+	size_t lo = 0,
+	       hi = circular_buffer_count_unlocked(p_circular_buffer),
+	       count = hi;
 
-	// Return data to the caller
-	*pp_data = p_circular_buffer->_p_data[p_circular_buffer->read];
+	// Find the oldest element pushed at or after t
+	while ( lo < hi )
+	{
 
-	// Unlock
-	mutex_unlock(&p_circular_buffer->_lock);
+		// Initialized data
+		size_t mid = lo + ( hi - lo ) / 2;
 
-	// Success
-	return 1;
+		// Search the newer half
+		if ( p_circular_buffer->_p_timestamps[( p_circular_buffer->read + mid ) % p_circular_buffer->length] < t ) lo = mid + 1;
 
-	// Empty
-	circular_buffer_empty:
-	{
+		// Search the older half
+		else hi = mid;
+	}
 
-		// Unlock
-		mutex_unlock(&p_circular_buffer->_lock);
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
 
-		// Error
-		return 0;
-	}
+	// Success
+	return count - lo;
 
 	// Error handling
 	{
@@ -382,10 +585,13 @@ int circular_buffer_peek ( circular_buffer *const p_circular_buffer, void **pp_d
 
 				// Error
 				return 0;
+		}
 
-			no_data:
+		// Circular buffer errors
+		{
+			not_timed:
 				#ifndef NDEBUG
-					log_error("[circular buffer] Null pointer provided for parameter \"pp_data\" in call to function \"%s\"\n", __FUNCTION__);
+					log_error("[circular buffer] Circular buffer is not time windowed in call to function \"%s\"\n", __FUNCTION__);
 				#endif
 
 				// Error
@@ -394,30 +600,14 @@ int circular_buffer_peek ( circular_buffer *const p_circular_buffer, void **pp_d
 	}
 }
 
-int circular_buffer_pop ( circular_buffer *const p_circular_buffer, void **pp_data )
+int circular_buffer_set_spin ( circular_buffer *const p_circular_buffer, unsigned spin )
 {
 
 	// Argument check
 	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
-	if ( pp_data           == (void *) 0 ) goto no_data;
-
-	// Lock
-	mutex_lock(&p_circular_buffer->_lock);
-	
-	// Initialized data
-	void *p_data = p_circular_buffer->_p_data[p_circular_buffer->read];
-
-	// Update the read index
-	p_circular_buffer->read = ( p_circular_buffer->read + 1 ) % p_circular_buffer->length;
 
-	// Clear the full flag
-	p_circular_buffer->full = false;
-
-	// Return a pointer to the caller
-	*pp_data = p_data;
-
-	// Unlock
-	mutex_unlock(&p_circular_buffer->_lock);
+	// Store the spin limit
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->_lock.spin, spin);
 
 	// Success
 	return 1;
@@ -432,41 +622,959 @@ int circular_buffer_pop ( circular_buffer *const p_circular_buffer, void **pp_da
 					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
 				#endif
 
-				// Error
-				return 0;
-
-			no_data:
-				#ifndef NDEBUG
-					log_error("[circular buffer] Null pointer provided for parameter \"pp_data\" in call to function \"%s\"\n", __FUNCTION__);
-				#endif
-
 				// Error
 				return 0;
 		}
 	}
 }
 
-int circular_buffer_destroy ( circular_buffer **const pp_circular_buffer )
+int circular_buffer_push_unlocked ( circular_buffer *const p_circular_buffer, void *p_data, bool *p_signal, size_t *p_count )
 {
 
-	// Argument check
-	if ( pp_circular_buffer == (void *) 0 ) goto no_circular_buffer;
-
 	// Initialized data
-	circular_buffer *p_circular_buffer = *pp_circular_buffer;
-	
-	// Lock
-	mutex_lock(&p_circular_buffer->_lock);
+	struct circular_buffer_budget_s *p_budget = p_circular_buffer->_p_budget;
+	size_t                           size     = 0;
 
-	// No more circular buffer for end user
-	*pp_circular_buffer = 0;
+	// Ask the size callback
+	if ( p_budget && p_budget->pfn_size ) size = p_budget->pfn_size(p_data, p_budget->p_context);
 
-	// Unlock
-	mutex_unlock(&p_circular_buffer->_lock);
+	// Success
+	return circular_buffer_push_sized_unlocked(p_circular_buffer, p_data, size, p_signal, p_count);
+}
+
+int circular_buffer_push_sized_unlocked ( circular_buffer *const p_circular_buffer, void *p_data, size_t size, bool *p_signal, size_t *p_count )
+{
+
+	// Send the element to disk instead of overwriting
+	if ( p_circular_buffer->_p_spill && ( p_circular_buffer->full || p_circular_buffer->_p_spill->count ) )
+	{
+
+		// Trace the spill
+		CIRCULAR_BUFFER_PROBE2(spill, p_circular_buffer, p_circular_buffer->_p_spill->count);
+
+		// Success
+		return circular_buffer_spill_append(p_circular_buffer, p_data);
+	}
+
+	// Success
+	return circular_buffer_insert_unlocked(p_circular_buffer, p_data, size, p_signal, p_count);
+}
+
+int circular_buffer_insert_unlocked ( circular_buffer *const p_circular_buffer, void *p_data, size_t size, bool *p_signal, size_t *p_count )
+{
+
+	// Evict until the element fits under the byte budget
+	if ( p_circular_buffer->_p_budget && circular_buffer_budget_admit(p_circular_buffer, size) == 0 ) return 0;
+
+	// Store the element
+	bool overflow = circular_buffer_store_unlocked(p_circular_buffer, p_data);
+
+	// Detect transitions for the event file descriptor
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_EVENT ) *p_signal |= circular_buffer_event_crossed(p_circular_buffer, overflow);
+
+	// Occupancy for the consumer thread
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_CONSUMER ) *p_count = circular_buffer_count_unlocked(p_circular_buffer);
+
+	// Backpressure
+	circular_buffer_watermark_check(p_circular_buffer);
+
+	// Trace the push
+	CIRCULAR_BUFFER_PROBE3(push, p_circular_buffer, circular_buffer_count_unlocked(p_circular_buffer), p_circular_buffer->length);
+
+	// Success
+	return 1;
+}
+
+int circular_buffer_push ( circular_buffer *const p_circular_buffer, void *p_data )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_data            == (void *) 0 ) goto no_data;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+		
+	// Publish to the combiner instead of taking the lock
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_COMBINING ) return circular_buffer_combining_push(p_circular_buffer, p_data);
+
+	// Initialized data
+	bool   signal = false;
+	size_t count  = 0;
+	int    ret    = 0;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Store the element
+	ret = circular_buffer_push_unlocked(p_circular_buffer, p_data, &signal, &count);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Wake event loops
+	if ( signal ) circular_buffer_event_signal(p_circular_buffer);
+
+	// Wake the consumer thread
+	if ( count ) circular_buffer_consumer_notify(p_circular_buffer, count);
+
+	// Done
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_push_batch ( circular_buffer *const p_circular_buffer, void *const *pp_data, size_t count )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( pp_data           == (void *) 0 ) goto no_data;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+
+	// Initialized data
+	bool   signal = false,
+	       notify = false;
+	size_t pushed = 0;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Store each element
+	for (size_t i = 0; i < count; i++)
+	{
+
+		// Initialized data
+		size_t occupancy = 0;
+
+		// Skip null elements, like circular_buffer_push
+		if ( pp_data[i] == (void *) 0 ) continue;
+
+		// Store the element
+		pushed += (size_t) circular_buffer_push_unlocked(p_circular_buffer, pp_data[i], &signal, &occupancy);
+		if ( occupancy ) notify = true;
+	}
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Wake event loops
+	if ( signal ) circular_buffer_event_signal(p_circular_buffer);
+
+	// Wake the consumer thread. The batch may have filled an empty circular buffer.
+	if ( notify ) circular_buffer_consumer_notify(p_circular_buffer, 1);
+
+	// Success
+	return pushed;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_peek ( circular_buffer *const p_circular_buffer, void **pp_data )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( pp_data           == (void *) 0 ) goto no_data;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+
+	// Read spilled elements back once the circular buffer drains
+	if ( p_circular_buffer->_p_spill ) circular_buffer_spill_refill(p_circular_buffer);
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Discard expired elements, consuming the event if that drained the circular buffer
+	if ( p_circular_buffer->_p_timestamps && circular_buffer_expire_unlocked(p_circular_buffer, timer_high_precision()) ) circular_buffer_event_drained(p_circular_buffer);
+
+	// State check
+	if ( circular_buffer_count_unlocked(p_circular_buffer) == 0 ) goto circular_buffer_empty;
+
+	// Return data to the caller
+	*pp_data = p_circular_buffer->_p_data[p_circular_buffer->read];
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return 1;
+
+	// Empty
+	circular_buffer_empty:
+	{
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_at ( circular_buffer *const p_circular_buffer, size_t index, void **pp_data )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( pp_data           == (void *) 0 ) goto no_data;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+
+	// Read spilled elements back once the circular buffer drains
+	if ( p_circular_buffer->_p_spill ) circular_buffer_spill_refill(p_circular_buffer);
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Discard expired elements, consuming the event if that drained the circular buffer
+	if ( p_circular_buffer->_p_timestamps && circular_buffer_expire_unlocked(p_circular_buffer, timer_high_precision()) ) circular_buffer_event_drained(p_circular_buffer);
+
+	// Bounds check
+	if ( index >= circular_buffer_count_unlocked(p_circular_buffer) ) goto out_of_bounds;
+
+	// Return data to the caller
+	circular_buffer_copy_unlocked(p_circular_buffer, index, pp_data, 1);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return 1;
+
+	// Out of bounds
+	out_of_bounds:
+	{
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_latest ( circular_buffer *const p_circular_buffer, size_t k, void **pp_data )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( pp_data           == (void *) 0 ) goto no_data;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+
+	// Read spilled elements back once the circular buffer drains
+	if ( p_circular_buffer->_p_spill ) circular_buffer_spill_refill(p_circular_buffer);
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Discard expired elements, consuming the event if that drained the circular buffer
+	if ( p_circular_buffer->_p_timestamps && circular_buffer_expire_unlocked(p_circular_buffer, timer_high_precision()) ) circular_buffer_event_drained(p_circular_buffer);
+
+	// Initialized data
+	size_t count = circular_buffer_count_unlocked(p_circular_buffer);
+
+	// Bounds check
+	if ( k >= count ) goto out_of_bounds;
+
+	// Return data to the caller
+	circular_buffer_copy_unlocked(p_circular_buffer, count - 1 - k, pp_data, 1);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return 1;
+
+	// Out of bounds
+	out_of_bounds:
+	{
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_copy_range ( circular_buffer *const p_circular_buffer, size_t index, void **pp_data, size_t count )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( pp_data           == (void *) 0 ) goto no_data;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+
+	// Read spilled elements back once the circular buffer drains
+	if ( p_circular_buffer->_p_spill ) circular_buffer_spill_refill(p_circular_buffer);
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Discard expired elements, consuming the event if that drained the circular buffer
+	if ( p_circular_buffer->_p_timestamps && circular_buffer_expire_unlocked(p_circular_buffer, timer_high_precision()) ) circular_buffer_event_drained(p_circular_buffer);
+
+	// Initialized data
+	size_t available = circular_buffer_count_unlocked(p_circular_buffer);
+
+	// Clamp
+	available = ( index < available ) ? available - index : 0;
+	if ( count > available ) count = available;
+
+	// Return data to the caller
+	if ( count ) circular_buffer_copy_unlocked(p_circular_buffer, index, pp_data, count);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return count;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_find ( circular_buffer *const p_circular_buffer, const void *p_value, size_t *p_index )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+
+	// Read spilled elements back once the circular buffer drains
+	if ( p_circular_buffer->_p_spill ) circular_buffer_spill_refill(p_circular_buffer);
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Discard expired elements, consuming the event if that drained the circular buffer
+	if ( p_circular_buffer->_p_timestamps && circular_buffer_expire_unlocked(p_circular_buffer, timer_high_precision()) ) circular_buffer_event_drained(p_circular_buffer);
+
+	// Initialized data
+	size_t count = circular_buffer_count_unlocked(p_circular_buffer),
+	       first = p_circular_buffer->length - p_circular_buffer->read,
+	       index = 0;
+
+	// Clamp
+	if ( first > count ) first = count;
+
+	// Search the span before the wrap point, then the span after it
+	index = circular_buffer_search_find(&p_circular_buffer->_p_data[p_circular_buffer->read], first, p_value);
+	if ( index == first ) index = first + circular_buffer_search_find(p_circular_buffer->_p_data, count - first, p_value);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Not found
+	if ( index == count ) return 0;
+
+	// Return the position to the caller
+	if ( p_index ) *p_index = index;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_count ( circular_buffer *const p_circular_buffer, const void *p_value )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+
+	// Read spilled elements back once the circular buffer drains
+	if ( p_circular_buffer->_p_spill ) circular_buffer_spill_refill(p_circular_buffer);
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Discard expired elements, consuming the event if that drained the circular buffer
+	if ( p_circular_buffer->_p_timestamps && circular_buffer_expire_unlocked(p_circular_buffer, timer_high_precision()) ) circular_buffer_event_drained(p_circular_buffer);
+
+	// Initialized data
+	size_t count = circular_buffer_count_unlocked(p_circular_buffer),
+	       first = p_circular_buffer->length - p_circular_buffer->read,
+	       ret   = 0;
+
+	// Clamp
+	if ( first > count ) first = count;
+
+	// Count both sides of the wrap point
+	ret = circular_buffer_search_count(&p_circular_buffer->_p_data[p_circular_buffer->read], first, p_value)
+	    + circular_buffer_search_count(p_circular_buffer->_p_data, count - first, p_value);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_pop ( circular_buffer *const p_circular_buffer, void **pp_data )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( pp_data           == (void *) 0 ) goto no_data;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+
+	// Read spilled elements back once the circular buffer drains
+	if ( p_circular_buffer->_p_spill ) circular_buffer_spill_refill(p_circular_buffer);
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Discard expired elements, consuming the event if that drained the circular buffer
+	if ( p_circular_buffer->_p_timestamps && circular_buffer_expire_unlocked(p_circular_buffer, timer_high_precision()) ) circular_buffer_event_drained(p_circular_buffer);
+
+	// State check
+	if ( circular_buffer_count_unlocked(p_circular_buffer) == 0 ) goto circular_buffer_empty;
+	
+	// Initialized data
+	void *p_data = p_circular_buffer->_p_data[p_circular_buffer->read];
+
+	// Record the residence time
+	#ifdef CIRCULAR_BUFFER_LATENCY
+		if ( p_circular_buffer->_p_latency ) circular_buffer_latency_record(p_circular_buffer, p_circular_buffer->read, timer_high_precision());
+	#endif
+
+	// Drop the key
+	if ( p_circular_buffer->_p_coalesce ) circular_buffer_coalesce_forget(p_circular_buffer, p_circular_buffer->read);
+
+	// Return the bytes
+	if ( p_circular_buffer->_p_budget ) circular_buffer_budget_release(p_circular_buffer, p_circular_buffer->read);
+
+	// Update the read index
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->read, ( p_circular_buffer->read + 1 ) % p_circular_buffer->length);
+
+	// Clear the full flag
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->full, false);
+
+	// Backpressure
+	circular_buffer_watermark_check(p_circular_buffer);
+
+	// Consume the event if the circular buffer drained
+	circular_buffer_event_drained(p_circular_buffer);
+
+	// Trace the pop
+	CIRCULAR_BUFFER_PROBE3(pop, p_circular_buffer, circular_buffer_count_unlocked(p_circular_buffer), p_circular_buffer->length);
+
+	// Return a pointer to the caller
+	*pp_data = p_data;
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return 1;
+
+	// Empty
+	circular_buffer_empty:
+	{
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_pop_batch ( circular_buffer *const p_circular_buffer, void **pp_data, size_t max )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( pp_data           == (void *) 0 ) goto no_data;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+
+	// Read spilled elements back once the circular buffer drains
+	if ( p_circular_buffer->_p_spill ) circular_buffer_spill_refill(p_circular_buffer);
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Discard expired elements, consuming the event if that drained the circular buffer
+	if ( p_circular_buffer->_p_timestamps && circular_buffer_expire_unlocked(p_circular_buffer, timer_high_precision()) ) circular_buffer_event_drained(p_circular_buffer);
+
+	// Initialized data
+	size_t count = circular_buffer_count_unlocked(p_circular_buffer),
+	       first = 0;
+
+	// Clamp
+	if ( count > max ) count = max;
+
+	// Empty
+	if ( count == 0 ) goto done;
+
+	// Copy the values on both sides of the wrap point
+	first = p_circular_buffer->length - p_circular_buffer->read;
+	if ( first > count ) first = count;
+	memcpy(pp_data, &p_circular_buffer->_p_data[p_circular_buffer->read], first * sizeof(void *));
+	memcpy(pp_data + first, p_circular_buffer->_p_data, ( count - first ) * sizeof(void *));
+
+	// Record the residence times
+	#ifdef CIRCULAR_BUFFER_LATENCY
+		if ( p_circular_buffer->_p_latency )
+		{
+
+			// Initialized data
+			timestamp now = timer_high_precision();
+
+			// Record each sampled element
+			for (size_t i = 0; i < count; i++)
+				circular_buffer_latency_record(p_circular_buffer, ( p_circular_buffer->read + i ) % p_circular_buffer->length, now);
+		}
+	#endif
+
+	// Drop the keys
+	if ( p_circular_buffer->_p_coalesce )
+		for (size_t i = 0; i < count; i++)
+			circular_buffer_coalesce_forget(p_circular_buffer, ( p_circular_buffer->read + i ) % p_circular_buffer->length);
+
+	// Return the bytes
+	if ( p_circular_buffer->_p_budget )
+		for (size_t i = 0; i < count; i++)
+			circular_buffer_budget_release(p_circular_buffer, ( p_circular_buffer->read + i ) % p_circular_buffer->length);
+
+	// Update the read index
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->read, ( p_circular_buffer->read + count ) % p_circular_buffer->length);
+
+	// Clear the full flag
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->full, false);
+
+	// Backpressure
+	circular_buffer_watermark_check(p_circular_buffer);
+
+	// Consume the event if the circular buffer drained
+	circular_buffer_event_drained(p_circular_buffer);
+
+	// Trace the pop
+	CIRCULAR_BUFFER_PROBE3(pop_batch, p_circular_buffer, count, circular_buffer_count_unlocked(p_circular_buffer));
+
+	done:
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return count;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_expire ( circular_buffer *const p_circular_buffer, timestamp now )
+{
+
+	// Argument check
+	if ( p_circular_buffer                == (void *) 0 ) goto no_circular_buffer;
+	if ( p_circular_buffer->_p_timestamps == (void *) 0 ) goto not_timed;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Discard expired elements
+	size_t ret = circular_buffer_expire_unlocked(p_circular_buffer, now);
+
+	// Consume the event if the circular buffer drained
+	circular_buffer_event_drained(p_circular_buffer);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_timed:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer is not time windowed in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_destroy ( circular_buffer **const pp_circular_buffer )
+{
+
+	// Argument check
+	if ( pp_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+
+	// Initialized data
+	circular_buffer *p_circular_buffer = *pp_circular_buffer;
+
+	// Stop the consumer thread, which drains the circular buffer
+	if ( p_circular_buffer->_p_consumer ) circular_buffer_detach_consumer(p_circular_buffer);
+	
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// No more circular buffer for end user
+	*pp_circular_buffer = 0;
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
 
 	// Empty the circular buffer
 	//
 
+	// Close the spill log
+	if ( p_circular_buffer->_p_spill ) circular_buffer_spill_destroy(p_circular_buffer);
+
+	// Close the event file descriptor
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_EVENT ) circular_buffer_event_destroy(p_circular_buffer);
+
+	// Free the timestamps
+	if ( p_circular_buffer->_p_timestamps ) p_circular_buffer->_p_timestamps = CIRCULAR_BUFFER_REALLOC(p_circular_buffer->_p_timestamps, 0);
+
+	// Free the latency histogram
+	if ( p_circular_buffer->_p_latency ) circular_buffer_latency_destroy(p_circular_buffer);
+
+	// Free the flat combiner
+	if ( p_circular_buffer->_p_combining ) circular_buffer_combining_destroy(p_circular_buffer);
+
+	// Free the coalescing index
+	if ( p_circular_buffer->_p_coalesce ) circular_buffer_coalesce_destroy(p_circular_buffer);
+
+	// Free the byte budget
+	if ( p_circular_buffer->_p_budget ) circular_buffer_budget_destroy(p_circular_buffer);
+
+	// Free the spare block of drains
+	if ( p_circular_buffer->_p_drain ) circular_buffer_drain_destroy(p_circular_buffer);
+
+	// Caller provided storage is left to the caller
+	if ( p_circular_buffer->allocated == false ) return 1;
+
 	// Free the memory
 	p_circular_buffer = CIRCULAR_BUFFER_REALLOC(p_circular_buffer, 0);
 		
@@ -0,0 +1,843 @@
+/** !
+ * Circular buffer sliding window aggregate implementation
+ *
+ * @file circular_buffer_aggregate.c
+ *
+ * @author Jacob Smith
+ */
+
+// Header
+#include <circular_buffer/aggregate.h>
+
+// Standard library
+#include <stdint.h>
+#include <math.h>
+
+// Structure definitions
+struct circular_buffer_aggregate_entry_s
+{
+	size_t sequence;
+	double value;
+};
+
+struct circular_buffer_aggregate_deque_s
+{
+	size_t head, count;
+	struct circular_buffer_aggregate_entry_s *_p_entries;
+};
+
+struct circular_buffer_aggregate_s
+{
+	circular_buffer          *p_circular_buffer;
+	fn_circular_buffer_value *pfn_value;
+	circular_buffer_combiner  combiner;
+	bool                      has_combiner;
+	size_t                    length, pushed, popped;
+	double                    sum, compensation, custom;
+	double                   *_p_values;
+	struct circular_buffer_aggregate_deque_s min, max;
+	mutex                     _lock;
+};
+
+// Function declarations
+/** !
+ * Append a value to the back of a monotonic deque, discarding every
+ * entry that can never again be the extreme of the window
+ *
+ * @param p_deque  the deque
+ * @param length   the capacity of the deque
+ * @param sequence the sequence number of the value
+ * @param value    the value
+ * @param minimum  true for a min deque, false for a max deque
+ *
+ * @return void
+ */
+static void circular_buffer_aggregate_deque_push ( struct circular_buffer_aggregate_deque_s *p_deque, size_t length, size_t sequence, double value, bool minimum );
+
+/** !
+ * Remove the oldest element's contribution from a monotonic deque
+ *
+ * @param p_deque  the deque
+ * @param length   the capacity of the deque
+ * @param sequence the sequence number of the element leaving the window
+ *
+ * @return void
+ */
+static void circular_buffer_aggregate_deque_retract ( struct circular_buffer_aggregate_deque_s *p_deque, size_t length, size_t sequence );
+
+/** !
+ * Add a value to the running sum, carrying the low order bits lost to
+ * rounding in a compensation term (Neumaier summation)
+ *
+ * @param p_circular_buffer_aggregate the circular buffer aggregate
+ * @param value                       the value to add
+ *
+ * @return void
+ */
+static void circular_buffer_aggregate_accumulate ( circular_buffer_aggregate *p_circular_buffer_aggregate, double value );
+
+/** !
+ * Remove the oldest element's contribution from every aggregate
+ *
+ * @param p_circular_buffer_aggregate the circular buffer aggregate
+ *
+ * @return void
+ */
+static void circular_buffer_aggregate_retract ( circular_buffer_aggregate *p_circular_buffer_aggregate );
+
+// Function definitions
+int circular_buffer_aggregate_construct ( circular_buffer_aggregate **const pp_circular_buffer_aggregate, size_t size, fn_circular_buffer_value *pfn_value, const circular_buffer_combiner *p_combiner )
+{
+
+	// Argument check
+	if ( pp_circular_buffer_aggregate == (void *) 0 ) goto no_circular_buffer_aggregate;
+	if ( size                         ==          0 ) goto no_size;
+	if ( p_combiner )
+	{
+		if ( p_combiner->pfn_combine == (void *) 0 ) goto no_combiner;
+		if ( p_combiner->pfn_retract == (void *) 0 ) goto no_combiner;
+	}
+
+	// Initialized data
+	circular_buffer_aggregate *p_circular_buffer_aggregate = CIRCULAR_BUFFER_REALLOC(0, sizeof(circular_buffer_aggregate));
+
+	// Error check
+	if ( p_circular_buffer_aggregate == (void *) 0 ) goto no_mem;
+
+	// Zero set
+	memset(p_circular_buffer_aggregate, 0, sizeof(circular_buffer_aggregate));
+
+	// Allocate the value history and the monotonic deques
+	p_circular_buffer_aggregate->_p_values      = CIRCULAR_BUFFER_REALLOC(0, size * sizeof(double));
+	p_circular_buffer_aggregate->min._p_entries = CIRCULAR_BUFFER_REALLOC(0, size * sizeof(struct circular_buffer_aggregate_entry_s));
+	p_circular_buffer_aggregate->max._p_entries = CIRCULAR_BUFFER_REALLOC(0, size * sizeof(struct circular_buffer_aggregate_entry_s));
+
+	// Error check
+	if ( p_circular_buffer_aggregate->_p_values      == (void *) 0 ) goto failed_to_allocate_state;
+	if ( p_circular_buffer_aggregate->min._p_entries == (void *) 0 ) goto failed_to_allocate_state;
+	if ( p_circular_buffer_aggregate->max._p_entries == (void *) 0 ) goto failed_to_allocate_state;
+
+	// Construct the underlying circular buffer
+	if ( circular_buffer_construct(&p_circular_buffer_aggregate->p_circular_buffer, size) == 0 ) goto failed_to_construct_circular_buffer;
+
+	// Create a mutex
+	if ( mutex_create(&p_circular_buffer_aggregate->_lock) == 0 ) goto failed_to_create_mutex;
+
+	// Populate the struct
+	p_circular_buffer_aggregate->length    = size;
+	p_circular_buffer_aggregate->pfn_value = pfn_value;
+
+	// Store the combiner
+	if ( p_combiner )
+	{
+		p_circular_buffer_aggregate->combiner     = *p_combiner;
+		p_circular_buffer_aggregate->custom       = p_combiner->identity;
+		p_circular_buffer_aggregate->has_combiner = true;
+	}
+
+	// Return a pointer to the caller
+	*pp_circular_buffer_aggregate = p_circular_buffer_aggregate;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer_aggregate:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_circular_buffer_aggregate\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_size:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"size\" must be greater than zero in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_combiner:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Combiner must provide both \"pfn_combine\" and \"pfn_retract\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			failed_to_construct_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Failed to construct circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free the aggregate state
+				p_circular_buffer_aggregate->_p_values      = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate->_p_values, 0);
+				p_circular_buffer_aggregate->min._p_entries = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate->min._p_entries, 0);
+				p_circular_buffer_aggregate->max._p_entries = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate->max._p_entries, 0);
+				p_circular_buffer_aggregate                 = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate, 0);
+
+				// Error
+				return 0;
+
+			failed_to_create_mutex:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Failed to create mutex in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Destroy the circular buffer
+				circular_buffer_destroy(&p_circular_buffer_aggregate->p_circular_buffer);
+
+				// Free the aggregate state
+				p_circular_buffer_aggregate->_p_values      = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate->_p_values, 0);
+				p_circular_buffer_aggregate->min._p_entries = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate->min._p_entries, 0);
+				p_circular_buffer_aggregate->max._p_entries = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate->max._p_entries, 0);
+				p_circular_buffer_aggregate                 = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate, 0);
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			failed_to_allocate_state:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free the aggregate state
+				p_circular_buffer_aggregate->_p_values      = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate->_p_values, 0);
+				p_circular_buffer_aggregate->min._p_entries = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate->min._p_entries, 0);
+				p_circular_buffer_aggregate->max._p_entries = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate->max._p_entries, 0);
+				p_circular_buffer_aggregate                 = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate, 0);
+
+				// Error
+				return 0;
+
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_aggregate_count ( circular_buffer_aggregate *const p_circular_buffer_aggregate, size_t *p_count )
+{
+
+	// Argument check
+	if ( p_circular_buffer_aggregate == (void *) 0 ) goto no_circular_buffer_aggregate;
+	if ( p_count                     == (void *) 0 ) goto no_result;
+
+	// Lock
+	mutex_lock(&p_circular_buffer_aggregate->_lock);
+
+	// Return the count to the caller
+	*p_count = p_circular_buffer_aggregate->pushed - p_circular_buffer_aggregate->popped;
+
+	// Unlock
+	mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer_aggregate:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer_aggregate\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_result:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_count\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_aggregate_sum ( circular_buffer_aggregate *const p_circular_buffer_aggregate, double *p_result )
+{
+
+	// Argument check
+	if ( p_circular_buffer_aggregate == (void *) 0 ) goto no_circular_buffer_aggregate;
+	if ( p_result                    == (void *) 0 ) goto no_result;
+
+	// Lock
+	mutex_lock(&p_circular_buffer_aggregate->_lock);
+
+	// Return the sum to the caller
+	*p_result = p_circular_buffer_aggregate->sum + p_circular_buffer_aggregate->compensation;
+
+	// Unlock
+	mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer_aggregate:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer_aggregate\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_result:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_result\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_aggregate_mean ( circular_buffer_aggregate *const p_circular_buffer_aggregate, double *p_result )
+{
+
+	// Argument check
+	if ( p_circular_buffer_aggregate == (void *) 0 ) goto no_circular_buffer_aggregate;
+	if ( p_result                    == (void *) 0 ) goto no_result;
+
+	// Lock
+	mutex_lock(&p_circular_buffer_aggregate->_lock);
+
+	// Initialized data
+	size_t count = p_circular_buffer_aggregate->pushed - p_circular_buffer_aggregate->popped;
+
+	// State check
+	if ( count == 0 ) goto window_empty;
+
+	// Return the mean to the caller
+	*p_result = ( p_circular_buffer_aggregate->sum + p_circular_buffer_aggregate->compensation ) / (double) count;
+
+	// Unlock
+	mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+	// Success
+	return 1;
+
+	// Empty
+	window_empty:
+	{
+
+		// Unlock
+		mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer_aggregate:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer_aggregate\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_result:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_result\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_aggregate_min ( circular_buffer_aggregate *const p_circular_buffer_aggregate, double *p_result )
+{
+
+	// Argument check
+	if ( p_circular_buffer_aggregate == (void *) 0 ) goto no_circular_buffer_aggregate;
+	if ( p_result                    == (void *) 0 ) goto no_result;
+
+	// Lock
+	mutex_lock(&p_circular_buffer_aggregate->_lock);
+
+	// State check
+	if ( p_circular_buffer_aggregate->min.count == 0 ) goto window_empty;
+
+	// The front of the min deque is the smallest value in the window
+	*p_result = p_circular_buffer_aggregate->min._p_entries[p_circular_buffer_aggregate->min.head].value;
+
+	// Unlock
+	mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+	// Success
+	return 1;
+
+	// Empty
+	window_empty:
+	{
+
+		// Unlock
+		mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer_aggregate:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer_aggregate\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_result:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_result\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_aggregate_max ( circular_buffer_aggregate *const p_circular_buffer_aggregate, double *p_result )
+{
+
+	// Argument check
+	if ( p_circular_buffer_aggregate == (void *) 0 ) goto no_circular_buffer_aggregate;
+	if ( p_result                    == (void *) 0 ) goto no_result;
+
+	// Lock
+	mutex_lock(&p_circular_buffer_aggregate->_lock);
+
+	// State check
+	if ( p_circular_buffer_aggregate->max.count == 0 ) goto window_empty;
+
+	// The front of the max deque is the largest value in the window
+	*p_result = p_circular_buffer_aggregate->max._p_entries[p_circular_buffer_aggregate->max.head].value;
+
+	// Unlock
+	mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+	// Success
+	return 1;
+
+	// Empty
+	window_empty:
+	{
+
+		// Unlock
+		mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer_aggregate:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer_aggregate\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_result:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_result\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_aggregate_custom ( circular_buffer_aggregate *const p_circular_buffer_aggregate, double *p_result )
+{
+
+	// Argument check
+	if ( p_circular_buffer_aggregate               == (void *) 0 ) goto no_circular_buffer_aggregate;
+	if ( p_result                                  == (void *) 0 ) goto no_result;
+	if ( p_circular_buffer_aggregate->has_combiner ==      false ) goto no_combiner;
+
+	// Lock
+	mutex_lock(&p_circular_buffer_aggregate->_lock);
+
+	// Return the combined value to the caller
+	*p_result = p_circular_buffer_aggregate->custom;
+
+	// Unlock
+	mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer_aggregate:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer_aggregate\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_result:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_result\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_combiner:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Aggregate was constructed without a combiner in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+static void circular_buffer_aggregate_deque_push ( struct circular_buffer_aggregate_deque_s *p_deque, size_t length, size_t sequence, double value, bool minimum )
+{
+
+	// Discard entries from the back that the new value dominates
+	while ( p_deque->count )
+	{
+
+		// Initialized data
+		double back = p_deque->_p_entries[( p_deque->head + p_deque->count - 1 ) % length].value;
+
+		// Done
+		if ( minimum ? ( back < value ) : ( back > value ) ) break;
+
+		// Discard the back entry
+		p_deque->count--;
+	}
+
+	// Append the new entry
+	p_deque->_p_entries[( p_deque->head + p_deque->count ) % length] = (struct circular_buffer_aggregate_entry_s)
+	{
+		.sequence = sequence,
+		.value    = value
+	};
+
+	// Update the count
+	p_deque->count++;
+
+	// Done
+	return;
+}
+
+static void circular_buffer_aggregate_deque_retract ( struct circular_buffer_aggregate_deque_s *p_deque, size_t length, size_t sequence )
+{
+
+	// The oldest element is only present if nothing newer dominated it
+	if ( p_deque->count == 0 || p_deque->_p_entries[p_deque->head].sequence != sequence ) return;
+
+	// Discard the front entry
+	p_deque->head = ( p_deque->head + 1 ) % length;
+	p_deque->count--;
+
+	// Done
+	return;
+}
+
+static void circular_buffer_aggregate_accumulate ( circular_buffer_aggregate *p_circular_buffer_aggregate, double value )
+{
+
+	// Initialized data
+	double sum   = p_circular_buffer_aggregate->sum,
+	       total = sum + value;
+
+	// Recover the bits of the smaller operand that did not survive the add
+	if ( fabs(sum) >= fabs(value) ) p_circular_buffer_aggregate->compensation += ( sum - total ) + value;
+	else                            p_circular_buffer_aggregate->compensation += ( value - total ) + sum;
+
+	// Update the running sum
+	p_circular_buffer_aggregate->sum = total;
+
+	// Done
+	return;
+}
+
+static void circular_buffer_aggregate_retract ( circular_buffer_aggregate *p_circular_buffer_aggregate )
+{
+
+	// Initialized data
+	size_t length   = p_circular_buffer_aggregate->length,
+	       sequence = p_circular_buffer_aggregate->popped;
+	double value    = p_circular_buffer_aggregate->_p_values[sequence % length];
+
+	// Retract the oldest value from the running sum
+	circular_buffer_aggregate_accumulate(p_circular_buffer_aggregate, -value);
+
+	// Retract the oldest value from the user defined combiner
+	if ( p_circular_buffer_aggregate->has_combiner )
+		p_circular_buffer_aggregate->custom = p_circular_buffer_aggregate->combiner.pfn_retract(p_circular_buffer_aggregate->custom, value);
+
+	// Retract the oldest value from the monotonic deques
+	circular_buffer_aggregate_deque_retract(&p_circular_buffer_aggregate->min, length, sequence);
+	circular_buffer_aggregate_deque_retract(&p_circular_buffer_aggregate->max, length, sequence);
+
+	// The oldest element has left the window
+	p_circular_buffer_aggregate->popped++;
+
+	// An empty window has an exact sum
+	if ( p_circular_buffer_aggregate->popped == p_circular_buffer_aggregate->pushed )
+		p_circular_buffer_aggregate->sum = p_circular_buffer_aggregate->compensation = 0;
+
+	// Done
+	return;
+}
+
+int circular_buffer_aggregate_push ( circular_buffer_aggregate *const p_circular_buffer_aggregate, void *p_element )
+{
+
+	// Argument check
+	if ( p_circular_buffer_aggregate == (void *) 0 ) goto no_circular_buffer_aggregate;
+	if ( p_element                   == (void *) 0 ) goto no_element;
+
+	// Initialized data
+	size_t length   = p_circular_buffer_aggregate->length;
+	double value    = ( p_circular_buffer_aggregate->pfn_value ) ? p_circular_buffer_aggregate->pfn_value(p_element) : (double) (intptr_t) p_element;
+
+	// Lock
+	mutex_lock(&p_circular_buffer_aggregate->_lock);
+
+	// Add the element to the circular buffer
+	if ( circular_buffer_push(p_circular_buffer_aggregate->p_circular_buffer, p_element) == 0 ) goto failed_to_push;
+
+	// The circular buffer overwrote its oldest element
+	if ( p_circular_buffer_aggregate->pushed - p_circular_buffer_aggregate->popped == length )
+		circular_buffer_aggregate_retract(p_circular_buffer_aggregate);
+
+	// Initialized data
+	size_t sequence = p_circular_buffer_aggregate->pushed;
+
+	// Store the value for retraction
+	p_circular_buffer_aggregate->_p_values[sequence % length] = value;
+
+	// Accumulate
+	circular_buffer_aggregate_accumulate(p_circular_buffer_aggregate, value);
+
+	// Combine
+	if ( p_circular_buffer_aggregate->has_combiner )
+		p_circular_buffer_aggregate->custom = p_circular_buffer_aggregate->combiner.pfn_combine(p_circular_buffer_aggregate->custom, value);
+
+	// Update the monotonic deques
+	circular_buffer_aggregate_deque_push(&p_circular_buffer_aggregate->min, length, sequence, value, true);
+	circular_buffer_aggregate_deque_push(&p_circular_buffer_aggregate->max, length, sequence, value, false);
+
+	// The element has entered the window
+	p_circular_buffer_aggregate->pushed++;
+
+	// Unlock
+	mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer_aggregate:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer_aggregate\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_element:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_element\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			failed_to_push:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Failed to push element in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Unlock
+				mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_aggregate_pop ( circular_buffer_aggregate *const p_circular_buffer_aggregate, void **pp_element )
+{
+
+	// Argument check
+	if ( p_circular_buffer_aggregate == (void *) 0 ) goto no_circular_buffer_aggregate;
+	if ( pp_element                  == (void *) 0 ) goto no_element;
+
+	// Lock
+	mutex_lock(&p_circular_buffer_aggregate->_lock);
+
+	// State check
+	if ( p_circular_buffer_aggregate->pushed == p_circular_buffer_aggregate->popped ) goto window_empty;
+
+	// Remove the element from the circular buffer
+	if ( circular_buffer_pop(p_circular_buffer_aggregate->p_circular_buffer, pp_element) == 0 ) goto failed_to_pop;
+
+	// Retract the element from the window
+	circular_buffer_aggregate_retract(p_circular_buffer_aggregate);
+
+	// Unlock
+	mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+	// Success
+	return 1;
+
+	// Empty
+	window_empty:
+	{
+
+		// Unlock
+		mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer_aggregate:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer_aggregate\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_element:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_element\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			failed_to_pop:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Failed to pop element in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Unlock
+				mutex_unlock(&p_circular_buffer_aggregate->_lock);
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_aggregate_destroy ( circular_buffer_aggregate **const pp_circular_buffer_aggregate )
+{
+
+	// Argument check
+	if ( pp_circular_buffer_aggregate == (void *) 0 ) goto no_circular_buffer_aggregate;
+
+	// Initialized data
+	circular_buffer_aggregate *p_circular_buffer_aggregate = *pp_circular_buffer_aggregate;
+
+	// Fast exit
+	if ( p_circular_buffer_aggregate == (void *) 0 ) return 1;
+
+	// No more circular buffer aggregate for end user
+	*pp_circular_buffer_aggregate = 0;
+
+	// Destroy the underlying circular buffer
+	circular_buffer_destroy(&p_circular_buffer_aggregate->p_circular_buffer);
+
+	// Destroy the mutex
+	mutex_destroy(&p_circular_buffer_aggregate->_lock);
+
+	// Free the memory
+	p_circular_buffer_aggregate->_p_values      = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate->_p_values, 0);
+	p_circular_buffer_aggregate->min._p_entries = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate->min._p_entries, 0);
+	p_circular_buffer_aggregate->max._p_entries = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate->max._p_entries, 0);
+	p_circular_buffer_aggregate                 = CIRCULAR_BUFFER_REALLOC(p_circular_buffer_aggregate, 0);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer_aggregate:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_circular_buffer_aggregate\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
@@ -0,0 +1,538 @@
+/** !
+ * Circular buffer benchmark program
+ *
+ * @file circular_buffer_bench.c
+ *
+ * @author Jacob Smith
+ */
+
+// Feature test macros
+#define _POSIX_C_SOURCE 200809L
+
+// Standard library
+#include <stdio.h>
+#include <stdlib.h>
+
+// Platform dependent includes
+#include <pthread.h>
+
+// log module
+#include <log/log.h>
+
+// sync module
+#include <sync/sync.h>
+
+// circular buffer module
+#include <circular_buffer/circular_buffer.h>
+#include <circular_buffer/combining.h>
+#include <circular_buffer/producer.h>
+#include <circular_buffer/executor.h>
+
+// Preprocessor definitions
+#define BENCH_OPERATIONS 1000000
+#define BENCH_SIZE       1024
+#define BENCH_DEPTH      17
+
+// Structure definitions
+struct bench_s
+{
+	circular_buffer   *p_circular_buffer;
+	size_t             operations, staged;
+	pthread_barrier_t  start;
+};
+
+struct bench_mutex_s
+{
+	struct bench_s  bench;
+	mutex           lock;
+	size_t          read, write, count;
+	void           *_p_data[BENCH_SIZE];
+};
+
+struct bench_tasks_s
+{
+	circular_buffer          *p_circular_buffer;
+	circular_buffer_executor *p_executor;
+	size_t                    total, done;
+};
+
+// Function declarations
+/** !
+ * Push and pop on a shared circular buffer
+ *
+ * @param p_parameter the benchmark
+ *
+ * @return null
+ */
+void *bench_push_pop ( void *p_parameter );
+
+/** !
+ * Push and pop on a shared ring guarded by a mutex from the sync module,
+ * the way the circular buffer was locked before it had its own lock
+ *
+ * @param p_parameter the benchmark
+ *
+ * @return null
+ */
+void *bench_push_pop_mutex ( void *p_parameter );
+
+/** !
+ * Push to a shared circular buffer, directly or through a producer handle
+ *
+ * @param p_parameter the benchmark
+ *
+ * @return null
+ */
+void *bench_push ( void *p_parameter );
+
+/** !
+ * Run a worker on a quantity of threads and time them
+ *
+ * @param p_bench    the benchmark
+ * @param threads    the quantity of threads
+ * @param pfn_worker the worker
+ *
+ * @return nanoseconds per operation
+ */
+double bench_run ( struct bench_s *p_bench, size_t threads, void *(*pfn_worker)( void *p_parameter ) );
+
+/** !
+ * Time pushes from a quantity of threads
+ *
+ * @param threads the quantity of threads
+ * @param staged  the size of each thread's producer handle, or 0 to push directly
+ *
+ * @return nanoseconds per push
+ */
+double bench_producer ( size_t threads, size_t staged );
+
+/** !
+ * Time push and pop pairs from a quantity of threads
+ *
+ * @param threads   the quantity of threads
+ * @param spin      the spin limit of the circular buffer lock
+ * @param combining true for a flat combining circular buffer
+ *
+ * @return nanoseconds per push and pop pair
+ */
+double bench_lock ( size_t threads, unsigned spin, bool combining );
+
+/** !
+ * Time push and pop pairs on a mutex guarded ring from a quantity of
+ * threads, as a baseline for the circular buffer lock
+ *
+ * @param threads the quantity of threads
+ *
+ * @return nanoseconds per push and pop pair
+ */
+double bench_mutex ( size_t threads );
+
+/** !
+ * Time a full scan of a circular buffer
+ *
+ * @param size  the quantity of elements
+ * @param count true to count a value, false to look for a missing value
+ *
+ * @return microseconds per scan
+ */
+double bench_search ( size_t size, bool count );
+
+/** !
+ * Run a task of a binary tree, submitting its two subtasks to an executor
+ *
+ * @param p_task    the depth of the task
+ * @param p_context the benchmark
+ *
+ * @return void
+ */
+void bench_tree_task ( void *p_task, void *p_context );
+
+/** !
+ * Run tasks of a binary tree from a shared circular buffer, pushing
+ * subtasks back to it
+ *
+ * @param p_parameter the benchmark
+ *
+ * @return null
+ */
+void *bench_tree_shared ( void *p_parameter );
+
+/** !
+ * Time a binary tree of tasks that each submit two subtasks
+ *
+ * @param threads  the quantity of worker threads
+ * @param executor true for a work stealing executor, false for a shared circular buffer
+ *
+ * @return nanoseconds per task
+ */
+double bench_tasks ( size_t threads, bool executor );
+
+// Entry point
+int main ( int argc, const char *argv[] )
+{
+
+	// Supress compiler warnings
+	(void) argc;
+	(void) argv;
+
+	// Initialized data
+	const size_t   _threads[] = { 2, 4, 8, 16 };
+	const unsigned _spins[]   = { 0, 32, CIRCULAR_BUFFER_LOCK_DEFAULT_SPIN, 1024 };
+
+	// Header
+	log_info("Lock: ns per push and pop pair, by spin limit and push path\n");
+	printf("threads       mutex");
+	for (size_t j = 0; j < sizeof(_spins) / sizeof(*_spins); j++) printf("  spin %-5u", _spins[j]);
+	printf("   combining\n");
+
+	// Each thread count
+	for (size_t i = 0; i < sizeof(_threads) / sizeof(*_threads); i++)
+	{
+
+		// Row
+		printf("%7zu", _threads[i]);
+
+		// Baseline
+		printf("  %10.1f", bench_mutex(_threads[i]));
+
+		// Each spin limit
+		for (size_t j = 0; j < sizeof(_spins) / sizeof(*_spins); j++)
+			printf("  %10.1f", bench_lock(_threads[i], _spins[j], false));
+
+		// Flat combining
+		printf("  %10.1f\n", bench_lock(_threads[i], CIRCULAR_BUFFER_LOCK_DEFAULT_SPIN, true));
+	}
+
+	// Header
+	log_info("\nProducer handles: ns per push, by stage size\n");
+	printf("threads     direct    stage 8   stage 32  stage 128\n");
+
+	// Each thread count
+	for (size_t i = 0; i < sizeof(_threads) / sizeof(*_threads); i++)
+		printf("%7zu  %9.1f  %9.1f  %9.1f  %9.1f\n", _threads[i], bench_producer(_threads[i], 0), bench_producer(_threads[i], 8), bench_producer(_threads[i], 32), bench_producer(_threads[i], 128));
+
+	// Header
+	log_info("\nSearch: us per full scan\n");
+	printf("   size       find      count\n");
+
+	// Each size
+	for (size_t size = 1024; size <= 65536; size *= 4)
+		printf("%7zu  %9.2f  %9.2f\n", size, bench_search(size, false), bench_search(size, true));
+
+	// Header
+	log_info("\nTasks: ns per task, for a tree of %d tasks that each submit two subtasks\n", ( 1 << BENCH_DEPTH ) - 1);
+	printf("threads     shared   stealing\n");
+
+	// Each thread count
+	for (size_t i = 0; i < sizeof(_threads) / sizeof(*_threads); i++)
+		printf("%7zu  %9.1f  %9.1f\n", _threads[i], bench_tasks(_threads[i], false), bench_tasks(_threads[i], true));
+
+	// Success
+	return EXIT_SUCCESS;
+}
+
+void *bench_push_pop ( void *p_parameter )
+{
+
+	// Initialized data
+	struct bench_s *p_bench = p_parameter;
+	void           *p_value = (void *) 0;
+
+	// Start together
+	pthread_barrier_wait(&p_bench->start);
+
+	// Push and pop
+	for (size_t i = 0; i < p_bench->operations; i++)
+	{
+		circular_buffer_push(p_bench->p_circular_buffer, (void *) ( i + 1 ));
+		circular_buffer_pop(p_bench->p_circular_buffer, &p_value);
+	}
+
+	// Done
+	return (void *) 0;
+}
+
+void *bench_push_pop_mutex ( void *p_parameter )
+{
+
+	// Initialized data
+	struct bench_mutex_s *p_bench = p_parameter;
+	void                 *p_value = (void *) 0;
+
+	// Start together
+	pthread_barrier_wait(&p_bench->bench.start);
+
+	// Push and pop
+	for (size_t i = 0; i < p_bench->bench.operations; i++)
+	{
+
+		// Push, overwriting the oldest value when full
+		mutex_lock(&p_bench->lock);
+		p_bench->_p_data[p_bench->write] = (void *) ( i + 1 );
+		p_bench->write = ( p_bench->write + 1 ) % BENCH_SIZE;
+		if ( p_bench->count == BENCH_SIZE ) p_bench->read = p_bench->write;
+		else                                p_bench->count++;
+		mutex_unlock(&p_bench->lock);
+
+		// Pop
+		mutex_lock(&p_bench->lock);
+		if ( p_bench->count )
+		{
+			p_value        = p_bench->_p_data[p_bench->read];
+			p_bench->read  = ( p_bench->read + 1 ) % BENCH_SIZE;
+			p_bench->count--;
+		}
+		mutex_unlock(&p_bench->lock);
+	}
+
+	// Supress compiler warnings
+	(void) p_value;
+
+	// Done
+	return (void *) 0;
+}
+
+void *bench_push ( void *p_parameter )
+{
+
+	// Initialized data
+	struct bench_s           *p_bench    = p_parameter;
+	circular_buffer_producer *p_producer = (void *) 0;
+
+	// Open a producer handle
+	if ( p_bench->staged ) circular_buffer_producer_open(&p_producer, p_bench->p_circular_buffer, p_bench->staged, 0);
+
+	// Start together
+	pthread_barrier_wait(&p_bench->start);
+
+	// Push
+	for (size_t i = 0; i < p_bench->operations; i++)
+	{
+		if ( p_producer ) circular_buffer_producer_push(p_producer, (void *) ( i + 1 ));
+		else              circular_buffer_push(p_bench->p_circular_buffer, (void *) ( i + 1 ));
+	}
+
+	// Flush and close the producer handle
+	if ( p_producer ) circular_buffer_producer_close(&p_producer);
+
+	// Done
+	return (void *) 0;
+}
+
+double bench_run ( struct bench_s *p_bench, size_t threads, void *(*pfn_worker)( void *p_parameter ) )
+{
+
+	// Initialized data
+	pthread_t *_p_threads = malloc(threads * sizeof(pthread_t));
+	timestamp  t0         = 0,
+	           t1         = 0;
+
+	// Start the threads
+	pthread_barrier_init(&p_bench->start, (void *) 0, (unsigned) threads + 1);
+	for (size_t i = 0; i < threads; i++) pthread_create(&_p_threads[i], (void *) 0, pfn_worker, p_bench);
+
+	// Time the threads
+	pthread_barrier_wait(&p_bench->start);
+	t0 = timer_high_precision();
+	for (size_t i = 0; i < threads; i++) pthread_join(_p_threads[i], (void *) 0);
+	t1 = timer_high_precision();
+
+	// Clean up
+	pthread_barrier_destroy(&p_bench->start);
+	free(_p_threads);
+
+	// Success
+	return (double) ( t1 - t0 ) * 1000000000.0 / (double) timer_seconds_divisor() / (double) ( p_bench->operations * threads );
+}
+
+double bench_producer ( size_t threads, size_t staged )
+{
+
+	// Initialized data
+	struct bench_s _bench = { .operations = BENCH_OPERATIONS / threads, .staged = staged };
+	double         ret    = 0;
+
+	// Construct a circular buffer
+	circular_buffer_construct(&_bench.p_circular_buffer, BENCH_SIZE);
+
+	// Time the threads
+	ret = bench_run(&_bench, threads, bench_push);
+
+	// Clean up
+	circular_buffer_destroy(&_bench.p_circular_buffer);
+
+	// Success
+	return ret;
+}
+
+double bench_lock ( size_t threads, unsigned spin, bool combining )
+{
+
+	// Initialized data
+	struct bench_s _bench = { .operations = BENCH_OPERATIONS / threads };
+	double         ret    = 0;
+
+	// Construct a circular buffer with the spin limit
+	if ( combining ) circular_buffer_construct_combining(&_bench.p_circular_buffer, BENCH_SIZE, 0);
+	else             circular_buffer_construct(&_bench.p_circular_buffer, BENCH_SIZE);
+	circular_buffer_set_spin(_bench.p_circular_buffer, spin);
+
+	// Time the threads
+	ret = bench_run(&_bench, threads, bench_push_pop);
+
+	// Clean up
+	circular_buffer_destroy(&_bench.p_circular_buffer);
+
+	// Success
+	return ret;
+}
+
+double bench_mutex ( size_t threads )
+{
+
+	// Initialized data
+	struct bench_mutex_s _bench = { .bench.operations = BENCH_OPERATIONS / threads };
+	double               ret    = 0;
+
+	// Construct the mutex
+	mutex_create(&_bench.lock);
+
+	// Time the threads. The benchmark is the first member, so workers get the whole ring.
+	ret = bench_run(&_bench.bench, threads, bench_push_pop_mutex);
+
+	// Clean up
+	mutex_destroy(&_bench.lock);
+
+	// Success
+	return ret;
+}
+
+double bench_search ( size_t size, bool count )
+{
+
+	// Initialized data
+	circular_buffer *p_circular_buffer = (void *) 0;
+	size_t           scans             = BENCH_OPERATIONS / size,
+	                 found             = 0;
+	timestamp        t0                = 0,
+	                 t1                = 0;
+
+	// Fill a circular buffer past its wrap point
+	circular_buffer_construct(&p_circular_buffer, size);
+	for (size_t i = 0; i < size + size / 2; i++) circular_buffer_push(p_circular_buffer, (void *) ( i + 1 ));
+
+	// Scan
+	t0 = timer_high_precision();
+	for (size_t i = 0; i < scans; i++)
+	{
+		if ( count ) found += circular_buffer_count(p_circular_buffer, (void *) ( i + 1 ));
+		else         found += (size_t) circular_buffer_find(p_circular_buffer, (void *) 0x1, (void *) 0);
+	}
+	t1 = timer_high_precision();
+
+	// Clean up
+	circular_buffer_destroy(&p_circular_buffer);
+
+	// Keep the scans
+	if ( found == (size_t) -1 ) log_info("%zu\n", found);
+
+	// Success
+	return (double) ( t1 - t0 ) * 1000000.0 / (double) timer_seconds_divisor() / (double) scans;
+}
+
+void bench_tree_task ( void *p_task, void *p_context )
+{
+
+	// Initialized data
+	struct bench_tasks_s *p_bench = p_context;
+	size_t                depth   = (size_t) p_task;
+
+	// Submit the subtasks
+	if ( depth > 1 )
+	{
+		circular_buffer_executor_submit(p_bench->p_executor, (void *) ( depth - 1 ));
+		circular_buffer_executor_submit(p_bench->p_executor, (void *) ( depth - 1 ));
+	}
+
+	// Done
+	return;
+}
+
+void *bench_tree_shared ( void *p_parameter )
+{
+
+	// Initialized data
+	struct bench_tasks_s *p_bench = p_parameter;
+	void                 *p_task  = (void *) 0;
+
+	// Run tasks until the whole tree has run
+	while ( __atomic_load_n(&p_bench->done, __ATOMIC_RELAXED) < p_bench->total )
+	{
+
+		// Take a task
+		if ( circular_buffer_pop(p_bench->p_circular_buffer, &p_task) == 0 ) continue;
+
+		// Submit the subtasks
+		if ( (size_t) p_task > 1 )
+		{
+			circular_buffer_push(p_bench->p_circular_buffer, (void *) ( (size_t) p_task - 1 ));
+			circular_buffer_push(p_bench->p_circular_buffer, (void *) ( (size_t) p_task - 1 ));
+		}
+
+		// Count the task
+		__atomic_fetch_add(&p_bench->done, 1, __ATOMIC_RELAXED);
+	}
+
+	// Done
+	return (void *) 0;
+}
+
+double bench_tasks ( size_t threads, bool executor )
+{
+
+	// Initialized data
+	struct bench_tasks_s  _bench     = { .total = ( (size_t) 1 << BENCH_DEPTH ) - 1 };
+	pthread_t            *_p_threads = (void *) 0;
+	timestamp             t0         = 0,
+	                      t1         = 0;
+
+	// Work stealing executor
+	if ( executor )
+	{
+
+		// Start the workers
+		circular_buffer_executor_construct(&_bench.p_executor, threads, BENCH_SIZE, bench_tree_task, &_bench);
+
+		// Run the tree
+		t0 = timer_high_precision();
+		circular_buffer_executor_submit(_bench.p_executor, (void *) BENCH_DEPTH);
+		circular_buffer_executor_wait(_bench.p_executor);
+		t1 = timer_high_precision();
+
+		// Clean up
+		circular_buffer_executor_destroy(&_bench.p_executor);
+	}
+
+	// Shared circular buffer, large enough that the widest level of the tree is never overwritten
+	else
+	{
+
+		// Construct a circular buffer
+		circular_buffer_construct(&_bench.p_circular_buffer, (size_t) 1 << BENCH_DEPTH);
+		_p_threads = malloc(threads * sizeof(pthread_t));
+
+		// Run the tree
+		t0 = timer_high_precision();
+		circular_buffer_push(_bench.p_circular_buffer, (void *) BENCH_DEPTH);
+		for (size_t i = 0; i < threads; i++) pthread_create(&_p_threads[i], (void *) 0, bench_tree_shared, &_bench);
+		for (size_t i = 0; i < threads; i++) pthread_join(_p_threads[i], (void *) 0);
+		t1 = timer_high_precision();
+
+		// Clean up
+		circular_buffer_destroy(&_bench.p_circular_buffer);
+		free(_p_threads);
+	}
+
+	// Success
+	return (double) ( t1 - t0 ) * 1000000000.0 / (double) timer_seconds_divisor() / (double) _bench.total;
+}
@@ -0,0 +1,324 @@
+/** !
+ * Byte budgeted circular buffer implementation
+ *
+ * @file circular_buffer_budget.c
+ *
+ * @author Jacob Smith
+ */
+
+// Header
+#include <circular_buffer/budget.h>
+
+// Internal
+#include "circular_buffer_internal.h"
+
+// Function definitions
+int circular_buffer_construct_budgeted ( circular_buffer **const pp_circular_buffer, size_t size, size_t budget, fn_circular_buffer_size *pfn_size, fn_circular_buffer_evict *pfn_evict, void *p_context )
+{
+
+	// Argument check
+	if ( pp_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( size               ==          0 ) goto no_size;
+	if ( budget             ==          0 ) goto no_budget;
+
+	// Initialized data
+	circular_buffer                 *p_circular_buffer = (void *) 0;
+	struct circular_buffer_budget_s *p_budget          = (void *) 0;
+
+	// Allocate memory for the budget and the size of each entry
+	p_budget = CIRCULAR_BUFFER_REALLOC(0, sizeof(struct circular_buffer_budget_s) + size * sizeof(size_t));
+
+	// Error check
+	if ( p_budget == (void *) 0 ) goto no_mem;
+
+	// Populate the struct
+	*p_budget = (struct circular_buffer_budget_s)
+	{
+		.budget    = budget,
+		.bytes     = 0,
+		.evicted   = 0,
+		.pfn_size  = pfn_size,
+		.pfn_evict = pfn_evict,
+		.p_context = p_context
+	};
+
+	// Construct the circular buffer
+	if ( circular_buffer_construct(&p_circular_buffer, size) == 0 ) goto failed_to_construct_circular_buffer;
+
+	// Attach the budget
+	p_circular_buffer->_p_budget  = p_budget;
+	p_circular_buffer->features  |= CIRCULAR_BUFFER_FEATURE_BUDGET;
+
+	// Return a pointer to the caller
+	*pp_circular_buffer = p_circular_buffer;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_size:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"size\" must be greater than zero in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_budget:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"budget\" must be greater than zero in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			failed_to_construct_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Failed to construct circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free the budget
+				p_budget = CIRCULAR_BUFFER_REALLOC(p_budget, 0);
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_budget_used ( circular_buffer *const p_circular_buffer )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_circular_buffer->_p_budget == (void *) 0 ) goto not_budgeted;
+
+	// Success
+	return CIRCULAR_BUFFER_LOAD(p_circular_buffer->_p_budget->bytes);
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_budgeted:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer has no byte budget in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_budget_evicted ( circular_buffer *const p_circular_buffer )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_circular_buffer->_p_budget == (void *) 0 ) goto not_budgeted;
+
+	// Success
+	return CIRCULAR_BUFFER_LOAD(p_circular_buffer->_p_budget->evicted);
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_budgeted:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer has no byte budget in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_push_sized ( circular_buffer *const p_circular_buffer, void *p_data, size_t size )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_data            == (void *) 0 ) goto no_data;
+	if ( p_circular_buffer->_p_budget == (void *) 0 ) goto not_budgeted;
+
+	// Initialized data
+	bool   signal = false;
+	size_t count  = 0;
+	int    ret    = 0;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Store the element
+	ret = circular_buffer_push_sized_unlocked(p_circular_buffer, p_data, size, &signal, &count);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Wake event loops
+	if ( signal ) circular_buffer_event_signal(p_circular_buffer);
+
+	// Wake the consumer thread
+	if ( count ) circular_buffer_consumer_notify(p_circular_buffer, count);
+
+	// Done
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_budgeted:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer has no byte budget in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_budget_admit ( circular_buffer *const p_circular_buffer, size_t size )
+{
+
+	// Initialized data
+	struct circular_buffer_budget_s *p_budget = p_circular_buffer->_p_budget;
+
+	// The element could never fit
+	if ( size > p_budget->budget ) goto too_large;
+
+	// Evict the oldest elements until the element fits. The running total
+	// is 0 once the circular buffer is empty, so this always terminates.
+	while ( p_circular_buffer->full || p_budget->bytes + size > p_budget->budget )
+	{
+
+		// Initialized data
+		void   *p_data  = p_circular_buffer->_p_data[p_circular_buffer->read];
+		size_t  evicted = p_budget->_p_sizes[p_circular_buffer->read];
+
+		// Return the bytes
+		circular_buffer_budget_release(p_circular_buffer, p_circular_buffer->read);
+
+		// Update the read index
+		CIRCULAR_BUFFER_STORE(p_circular_buffer->read, ( p_circular_buffer->read + 1 ) % p_circular_buffer->length);
+
+		// Clear the full flag
+		CIRCULAR_BUFFER_STORE(p_circular_buffer->full, false);
+
+		// Count the eviction
+		CIRCULAR_BUFFER_STORE(p_budget->evicted, p_budget->evicted + 1);
+
+		// Trace the eviction
+		CIRCULAR_BUFFER_PROBE4(evict, p_circular_buffer, p_data, evicted, p_budget->bytes);
+
+		// Hand the element back to the caller
+		if ( p_budget->pfn_evict ) p_budget->pfn_evict(p_circular_buffer, p_data, evicted, p_budget->p_context);
+	}
+
+	// Charge the entry the element is about to occupy
+	p_budget->_p_sizes[p_circular_buffer->write] = size;
+	CIRCULAR_BUFFER_STORE(p_budget->bytes, p_budget->bytes + size);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Circular buffer errors
+		{
+			too_large:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Element of %zu bytes exceeds the byte budget of %zu bytes in call to function \"%s\"\n", size, p_budget->budget, __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+void circular_buffer_budget_destroy ( circular_buffer *const p_circular_buffer )
+{
+
+	// Free the budget
+	p_circular_buffer->_p_budget  = CIRCULAR_BUFFER_REALLOC(p_circular_buffer->_p_budget, 0);
+	p_circular_buffer->features  &= ~CIRCULAR_BUFFER_FEATURE_BUDGET;
+
+	// Done
+	return;
+}
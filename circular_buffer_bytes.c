@@ -0,0 +1,784 @@
+/** !
+ * Byte circular buffer implementation
+ *
+ * @file circular_buffer_bytes.c
+ *
+ * @author Jacob Smith
+ */
+
+// Header
+#include <circular_buffer/bytes.h>
+
+// Internal
+#include "circular_buffer_internal.h"
+
+// Platform dependent includes
+#ifndef _WIN64
+	#include <errno.h>
+	#include <sys/uio.h>
+	#include <unistd.h>
+#endif
+
+// Structure definitions
+struct circular_buffer_span_s
+{
+	unsigned char *p_data;
+	size_t         size;
+};
+
+// Function declarations
+/** !
+ * Split the unread or free bytes into the span before the wrap point and
+ * the span after it. The caller must hold the lock.
+ *
+ * @param p_circular_buffer the byte circular buffer
+ * @param free              true for free bytes, false for unread bytes
+ * @param max               the maximum quantity of bytes in both spans
+ * @param _spans            result
+ *
+ * @return the quantity of bytes in both spans
+ */
+static size_t circular_buffer_bytes_spans ( const circular_buffer *const p_circular_buffer, bool free, size_t max, struct circular_buffer_span_s _spans[2] );
+
+/** !
+ * Commit bytes written into the free space. The caller must hold the lock.
+ *
+ * @param p_circular_buffer the byte circular buffer
+ * @param size              the quantity of bytes
+ *
+ * @return void
+ */
+static void circular_buffer_bytes_produce ( circular_buffer *const p_circular_buffer, size_t size );
+
+/** !
+ * Release bytes that have been read. The caller must hold the lock.
+ *
+ * @param p_circular_buffer the byte circular buffer
+ * @param size              the quantity of bytes
+ *
+ * @return void
+ */
+static void circular_buffer_bytes_consume ( circular_buffer *const p_circular_buffer, size_t size );
+
+// Function definitions
+int circular_buffer_construct_bytes ( circular_buffer **const pp_circular_buffer, size_t size )
+{
+
+	// Argument check
+	if ( pp_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( size               ==          0 ) goto no_size;
+
+	// Initialized data
+	circular_buffer *p_circular_buffer = CIRCULAR_BUFFER_REALLOC(0, sizeof(circular_buffer) + size);
+
+	// Error check
+	if ( p_circular_buffer == (void *) 0 ) goto no_mem;
+
+	// Zero set
+	memset(p_circular_buffer, 0, sizeof(circular_buffer));
+
+	// Populate the struct
+	p_circular_buffer->length    = size;
+	p_circular_buffer->allocated = true;
+	p_circular_buffer->features  = CIRCULAR_BUFFER_FEATURE_BYTES;
+	p_circular_buffer->_p_data   = (void *) ( p_circular_buffer + 1 );
+
+	// Create the lock
+	circular_buffer_lock_init(&p_circular_buffer->_lock, CIRCULAR_BUFFER_LOCK_DEFAULT_SPIN);
+
+	// Return a pointer to the caller
+	*pp_circular_buffer = p_circular_buffer;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_size:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"size\" must be greater than zero in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+static size_t circular_buffer_bytes_spans ( const circular_buffer *const p_circular_buffer, bool free, size_t max, struct circular_buffer_span_s _spans[2] )
+{
+
+	// Initialized data
+	unsigned char *p_base = (unsigned char *) p_circular_buffer->_p_data;
+	size_t         used   = circular_buffer_count_unlocked(p_circular_buffer),
+	               start  = ( free ) ? p_circular_buffer->write : p_circular_buffer->read,
+	               size   = ( free ) ? p_circular_buffer->length - used : used;
+
+	// Clamp
+	if ( size > max ) size = max;
+
+	// The span before the wrap point
+	_spans[0].p_data = p_base + start;
+	_spans[0].size   = ( size < p_circular_buffer->length - start ) ? size : p_circular_buffer->length - start;
+
+	// The span after the wrap point
+	_spans[1].p_data = p_base;
+	_spans[1].size   = size - _spans[0].size;
+
+	// Success
+	return size;
+}
+
+static void circular_buffer_bytes_produce ( circular_buffer *const p_circular_buffer, size_t size )
+{
+
+	// Done
+	if ( size == 0 ) return;
+
+	// Initialized data
+	size_t used = circular_buffer_count_unlocked(p_circular_buffer) + size;
+
+	// Update the write index
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->write, ( p_circular_buffer->write + size ) % p_circular_buffer->length);
+
+	// Update the full flag
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->full, used == p_circular_buffer->length);
+
+	// Backpressure
+	circular_buffer_watermark_check(p_circular_buffer);
+
+	// Trace the write
+	CIRCULAR_BUFFER_PROBE3(write, p_circular_buffer, size, used);
+
+	// Done
+	return;
+}
+
+static void circular_buffer_bytes_consume ( circular_buffer *const p_circular_buffer, size_t size )
+{
+
+	// Done
+	if ( size == 0 ) return;
+
+	// Update the read index
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->read, ( p_circular_buffer->read + size ) % p_circular_buffer->length);
+
+	// Clear the full flag
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->full, false);
+
+	// Backpressure
+	circular_buffer_watermark_check(p_circular_buffer);
+
+	// Trace the read
+	CIRCULAR_BUFFER_PROBE3(read, p_circular_buffer, size, circular_buffer_count_unlocked(p_circular_buffer));
+
+	// Done
+	return;
+}
+
+size_t circular_buffer_bytes_used ( circular_buffer *const p_circular_buffer )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) == 0 ) goto not_bytes;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Initialized data
+	size_t ret = circular_buffer_count_unlocked(p_circular_buffer);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_bytes:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer is not a byte circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_bytes_free ( circular_buffer *const p_circular_buffer )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) == 0 ) goto not_bytes;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Initialized data
+	size_t ret = p_circular_buffer->length - circular_buffer_count_unlocked(p_circular_buffer);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_bytes:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer is not a byte circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_bytes_find ( circular_buffer *const p_circular_buffer, unsigned char value, size_t *p_index )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) == 0 ) goto not_bytes;
+
+	// Initialized data
+	struct circular_buffer_span_s  _spans[2] = { 0 };
+	const unsigned char           *p_found   = (void *) 0;
+	size_t                         index     = 0;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Find the unread bytes
+	circular_buffer_bytes_spans(p_circular_buffer, false, p_circular_buffer->length, _spans);
+
+	// Search the span before the wrap point, then the span after it
+	if      ( ( p_found = memchr(_spans[0].p_data, value, _spans[0].size) ) ) index = (size_t) ( p_found - _spans[0].p_data );
+	else if ( ( p_found = memchr(_spans[1].p_data, value, _spans[1].size) ) ) index = _spans[0].size + (size_t) ( p_found - _spans[1].p_data );
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Not found
+	if ( p_found == (void *) 0 ) return 0;
+
+	// Return the position to the caller
+	if ( p_index ) *p_index = index;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_bytes:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer is not a byte circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_bytes_count ( circular_buffer *const p_circular_buffer, unsigned char value )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) == 0 ) goto not_bytes;
+
+	// Initialized data
+	struct circular_buffer_span_s _spans[2] = { 0 };
+	size_t                        ret       = 0;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Find the unread bytes
+	circular_buffer_bytes_spans(p_circular_buffer, false, p_circular_buffer->length, _spans);
+
+	// Count both sides of the wrap point
+	ret = circular_buffer_search_count_bytes(_spans[0].p_data, _spans[0].size, value)
+	    + circular_buffer_search_count_bytes(_spans[1].p_data, _spans[1].size, value);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_bytes:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer is not a byte circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_write ( circular_buffer *const p_circular_buffer, const void *p_data, size_t size )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_data            == (void *) 0 ) goto no_data;
+	if ( ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) == 0 ) goto not_bytes;
+
+	// Initialized data
+	struct circular_buffer_span_s _spans[2] = { 0 };
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Find the free space
+	size = circular_buffer_bytes_spans(p_circular_buffer, true, size, _spans);
+
+	// Copy the bytes on both sides of the wrap point
+	memcpy(_spans[0].p_data, p_data, _spans[0].size);
+	memcpy(_spans[1].p_data, (const unsigned char *) p_data + _spans[0].size, _spans[1].size);
+
+	// Commit
+	circular_buffer_bytes_produce(p_circular_buffer, size);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return size;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_bytes:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer is not a byte circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_write_all ( circular_buffer *const p_circular_buffer, const void *p_data, size_t size )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_data            == (void *) 0 ) goto no_data;
+	if ( ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) == 0 ) goto not_bytes;
+
+	// Initialized data
+	struct circular_buffer_span_s _spans[2] = { 0 };
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Find the free space
+	if ( circular_buffer_bytes_spans(p_circular_buffer, true, size, _spans) != size ) goto no_room;
+
+	// Copy the bytes on both sides of the wrap point
+	memcpy(_spans[0].p_data, p_data, _spans[0].size);
+	memcpy(_spans[1].p_data, (const unsigned char *) p_data + _spans[0].size, _spans[1].size);
+
+	// Commit
+	circular_buffer_bytes_produce(p_circular_buffer, size);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_bytes:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer is not a byte circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_room:
+
+				// Unlock
+				circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_read ( circular_buffer *const p_circular_buffer, void *p_data, size_t size )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_data            == (void *) 0 ) goto no_data;
+	if ( ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) == 0 ) goto not_bytes;
+
+	// Initialized data
+	struct circular_buffer_span_s _spans[2] = { 0 };
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Find the unread bytes
+	size = circular_buffer_bytes_spans(p_circular_buffer, false, size, _spans);
+
+	// Copy the bytes on both sides of the wrap point
+	memcpy(p_data, _spans[0].p_data, _spans[0].size);
+	memcpy((unsigned char *) p_data + _spans[0].size, _spans[1].p_data, _spans[1].size);
+
+	// Commit
+	circular_buffer_bytes_consume(p_circular_buffer, size);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return size;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_bytes:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer is not a byte circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+#ifndef _WIN64
+
+ssize_t circular_buffer_read_fd ( circular_buffer *const p_circular_buffer, int fd, size_t max )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( fd                <           0 ) goto no_fd;
+	if ( ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) == 0 ) goto not_bytes;
+
+	// Initialized data
+	struct circular_buffer_span_s _spans[2] = { 0 };
+	struct iovec                  _iov[2]   = { 0 };
+	ssize_t                       ret       = 0;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Find the free space
+	size_t size = circular_buffer_bytes_spans(p_circular_buffer, true, max, _spans);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// State check
+	if ( size == 0 ) goto no_space;
+
+	// Fill both sides of the wrap point in one system call
+	_iov[0] = (struct iovec) { .iov_base = _spans[0].p_data, .iov_len = _spans[0].size };
+	_iov[1] = (struct iovec) { .iov_base = _spans[1].p_data, .iov_len = _spans[1].size };
+	ret     = readv(fd, _iov, ( _spans[1].size ) ? 2 : 1);
+
+	// Error check
+	if ( ret <= 0 ) return ret;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Commit
+	circular_buffer_bytes_produce(p_circular_buffer, (size_t) ret);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return -1;
+
+			no_fd:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"fd\" must be a valid file descriptor in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return -1;
+		}
+
+		// Circular buffer errors
+		{
+			not_bytes:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer is not a byte circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return -1;
+
+			no_space:
+
+				// Nothing was asked for
+				if ( max == 0 ) return 0;
+
+				// The buffer is full
+				errno = ENOBUFS;
+
+				// Error
+				return -1;
+		}
+	}
+}
+
+ssize_t circular_buffer_write_fd ( circular_buffer *const p_circular_buffer, int fd, size_t max )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( fd                <           0 ) goto no_fd;
+	if ( ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) == 0 ) goto not_bytes;
+
+	// Initialized data
+	struct circular_buffer_span_s _spans[2] = { 0 };
+	struct iovec                  _iov[2]   = { 0 };
+	ssize_t                       ret       = 0;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Find the unread bytes
+	size_t size = circular_buffer_bytes_spans(p_circular_buffer, false, max, _spans);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Done
+	if ( size == 0 ) return 0;
+
+	// Drain both sides of the wrap point in one system call
+	_iov[0] = (struct iovec) { .iov_base = _spans[0].p_data, .iov_len = _spans[0].size };
+	_iov[1] = (struct iovec) { .iov_base = _spans[1].p_data, .iov_len = _spans[1].size };
+	ret     = writev(fd, _iov, ( _spans[1].size ) ? 2 : 1);
+
+	// Error check
+	if ( ret <= 0 ) return ret;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Commit
+	circular_buffer_bytes_consume(p_circular_buffer, (size_t) ret);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return -1;
+
+			no_fd:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"fd\" must be a valid file descriptor in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return -1;
+		}
+
+		// Circular buffer errors
+		{
+			not_bytes:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer is not a byte circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return -1;
+		}
+	}
+}
+
+#endif
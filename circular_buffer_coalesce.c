@@ -0,0 +1,368 @@
+/** !
+ * Coalescing circular buffer implementation
+ *
+ * @file circular_buffer_coalesce.c
+ *
+ * @author Jacob Smith
+ */
+
+// Header
+#include <circular_buffer/coalesce.h>
+
+// Internal
+#include "circular_buffer_internal.h"
+
+// Function declarations
+/** !
+ * Hash a key to its home entry in the coalescing index
+ *
+ * @param p_coalesce the coalescing index
+ * @param key        the key
+ *
+ * @return the home entry
+ */
+static inline size_t circular_buffer_coalesce_home ( const struct circular_buffer_coalesce_s *const p_coalesce, uint64_t key );
+
+/** !
+ * Find the entry of a key in the coalescing index, or the empty entry where
+ * it belongs. The caller must hold the lock.
+ *
+ * @param p_coalesce the coalescing index
+ * @param key        the key
+ *
+ * @return the entry
+ */
+static size_t circular_buffer_coalesce_find ( const struct circular_buffer_coalesce_s *const p_coalesce, uint64_t key );
+
+// Function definitions
+int circular_buffer_construct_coalescing ( circular_buffer **const pp_circular_buffer, size_t size )
+{
+
+	// Argument check
+	if ( pp_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( size               ==          0 ) goto no_size;
+
+	// Initialized data
+	circular_buffer                   *p_circular_buffer = (void *) 0;
+	struct circular_buffer_coalesce_s *p_coalesce        = (void *) 0;
+	size_t                             entries           = 1;
+
+	// Keep the index at most half full
+	while ( entries < 2 * size ) entries <<= 1;
+
+	// Allocate memory for the keys and the index
+	p_coalesce = CIRCULAR_BUFFER_REALLOC(0, sizeof(struct circular_buffer_coalesce_s) + size * sizeof(uint64_t) + entries * sizeof(size_t));
+
+	// Error check
+	if ( p_coalesce == (void *) 0 ) goto no_mem;
+
+	// Populate the struct
+	*p_coalesce = (struct circular_buffer_coalesce_s)
+	{
+		.mask      = entries - 1,
+		.coalesced = 0,
+		._p_keys   = (uint64_t *) ( p_coalesce + 1 ),
+		._p_index  = (size_t *) ( (uint64_t *) ( p_coalesce + 1 ) + size )
+	};
+
+	// Zero means an empty entry
+	memset(p_coalesce->_p_index, 0, entries * sizeof(size_t));
+
+	// Construct the circular buffer
+	if ( circular_buffer_construct(&p_circular_buffer, size) == 0 ) goto failed_to_construct_circular_buffer;
+
+	// Attach the index
+	p_circular_buffer->_p_coalesce  = p_coalesce;
+	p_circular_buffer->features    |= CIRCULAR_BUFFER_FEATURE_COALESCE;
+
+	// Return a pointer to the caller
+	*pp_circular_buffer = p_circular_buffer;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_size:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"size\" must be greater than zero in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			failed_to_construct_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Failed to construct circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free the index
+				p_coalesce = CIRCULAR_BUFFER_REALLOC(p_coalesce, 0);
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_coalesced ( circular_buffer *const p_circular_buffer )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_circular_buffer->_p_coalesce == (void *) 0 ) goto not_coalescing;
+
+	// Success
+	return CIRCULAR_BUFFER_LOAD(p_circular_buffer->_p_coalesce->coalesced);
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_coalescing:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer is not coalescing in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_push_keyed ( circular_buffer *const p_circular_buffer, uint64_t key, void *p_data, void **pp_replaced )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_data            == (void *) 0 ) goto no_data;
+	if ( p_circular_buffer->_p_coalesce == (void *) 0 ) goto not_coalescing;
+
+	// Initialized data
+	struct circular_buffer_coalesce_s *p_coalesce = p_circular_buffer->_p_coalesce;
+	size_t                             entry      = 0,
+	                                   index      = 0,
+	                                   count      = 0;
+	bool                               signal     = false,
+	                                   spill      = false;
+	int                                ret        = 0;
+
+	// Nothing is replaced yet
+	if ( pp_replaced ) *pp_replaced = (void *) 0;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Find the key
+	entry = circular_buffer_coalesce_find(p_coalesce, key);
+
+	// The key is pending, so replace its element in place
+	if ( p_coalesce->_p_index[entry] )
+	{
+
+		// Initialized data
+		void **pp_slot = &p_circular_buffer->_p_data[p_coalesce->_p_index[entry] - 1];
+
+		// Hand the displaced element back to the caller
+		if ( pp_replaced ) *pp_replaced = *pp_slot;
+
+		// Replace the element
+		*pp_slot = p_data;
+
+		// Count the coalesced push
+		CIRCULAR_BUFFER_STORE(p_coalesce->coalesced, p_coalesce->coalesced + 1);
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Success
+		return 1;
+	}
+
+	// Where the element lands, unless it goes to the spill tier
+	index = p_circular_buffer->write;
+	spill = p_circular_buffer->_p_spill && ( p_circular_buffer->full || p_circular_buffer->_p_spill->count );
+
+	// Store the element. This may overwrite the oldest element and move its key.
+	ret = circular_buffer_push_unlocked(p_circular_buffer, p_data, &signal, &count);
+
+	// Index the key
+	if ( ret && spill == false )
+	{
+
+		// The overwrite may have shifted the entry
+		entry = circular_buffer_coalesce_find(p_coalesce, key);
+
+		// Store the key
+		p_coalesce->_p_keys[index]  = key;
+		p_coalesce->_p_index[entry] = index + 1;
+	}
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Wake event loops
+	if ( signal ) circular_buffer_event_signal(p_circular_buffer);
+
+	// Wake the consumer thread
+	if ( count ) circular_buffer_consumer_notify(p_circular_buffer, count);
+
+	// Done
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_coalescing:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer is not coalescing in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+void circular_buffer_coalesce_forget ( circular_buffer *const p_circular_buffer, size_t index )
+{
+
+	// Initialized data
+	struct circular_buffer_coalesce_s *p_coalesce = p_circular_buffer->_p_coalesce;
+	size_t                             hole       = circular_buffer_coalesce_find(p_coalesce, p_coalesce->_p_keys[index]),
+	                                   next       = hole;
+
+	// The element was pushed without a key, or its key now belongs to another element
+	if ( p_coalesce->_p_index[hole] != index + 1 ) return;
+
+	// Remove the entry, then move back any later entry in the probe run that
+	// would otherwise be cut off from its home entry
+	for (;;)
+	{
+
+		// Empty the hole
+		p_coalesce->_p_index[hole] = 0;
+
+		// Scan the rest of the probe run
+		for (;;)
+		{
+
+			// Initialized data
+			size_t home = 0;
+
+			// Next entry
+			next = ( next + 1 ) & p_coalesce->mask;
+
+			// The probe run ended
+			if ( p_coalesce->_p_index[next] == 0 ) return;
+
+			// The home of the entry
+			home = circular_buffer_coalesce_home(p_coalesce, p_coalesce->_p_keys[p_coalesce->_p_index[next] - 1]);
+
+			// The entry can stay if its home is cyclically in ( hole, next ]
+			if ( ( hole <= next ) ? ( hole < home && home <= next ) : ( hole < home || home <= next ) ) continue;
+
+			// Move the entry into the hole
+			p_coalesce->_p_index[hole] = p_coalesce->_p_index[next];
+			hole                       = next;
+
+			// Empty the new hole
+			break;
+		}
+	}
+}
+
+void circular_buffer_coalesce_destroy ( circular_buffer *const p_circular_buffer )
+{
+
+	// Free the index
+	p_circular_buffer->_p_coalesce  = CIRCULAR_BUFFER_REALLOC(p_circular_buffer->_p_coalesce, 0);
+	p_circular_buffer->features    &= ~CIRCULAR_BUFFER_FEATURE_COALESCE;
+
+	// Done
+	return;
+}
+
+static inline size_t circular_buffer_coalesce_home ( const struct circular_buffer_coalesce_s *const p_coalesce, uint64_t key )
+{
+
+	// Mix the bits, so that keys which differ only in high bits spread out
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+
+	// Success
+	return (size_t) key & p_coalesce->mask;
+}
+
+static size_t circular_buffer_coalesce_find ( const struct circular_buffer_coalesce_s *const p_coalesce, uint64_t key )
+{
+
+	// Initialized data
+	size_t entry = circular_buffer_coalesce_home(p_coalesce, key);
+
+	// Probe until the key or an empty entry
+	while ( p_coalesce->_p_index[entry] && p_coalesce->_p_keys[p_coalesce->_p_index[entry] - 1] != key )
+		entry = ( entry + 1 ) & p_coalesce->mask;
+
+	// Success
+	return entry;
+}
@@ -0,0 +1,298 @@
+/** !
+ * Flat combining circular buffer implementation
+ *
+ * @file circular_buffer_combining.c
+ *
+ * @author Jacob Smith
+ */
+
+// Header
+#include <circular_buffer/combining.h>
+
+// Internal
+#include "circular_buffer_internal.h"
+
+// Enumeration definitions
+enum circular_buffer_combining_state_e
+{
+	CIRCULAR_BUFFER_COMBINING_FREE    = 0,
+	CIRCULAR_BUFFER_COMBINING_CLAIMED = 1,
+	CIRCULAR_BUFFER_COMBINING_PENDING = 2,
+	CIRCULAR_BUFFER_COMBINING_DONE    = 3
+};
+
+// Structure definitions
+struct circular_buffer_combining_slot_s
+{
+	unsigned  state;
+	int       result;
+	void     *p_data;
+	unsigned char _padding[64 - 2 * sizeof(unsigned) - sizeof(void *)];
+};
+
+struct circular_buffer_combining_s
+{
+	size_t                                  slots;
+	struct circular_buffer_combining_slot_s _slots[];
+};
+
+// Data
+static _Thread_local size_t thread_number      = 0;
+static size_t               next_thread_number = 0;
+
+// Function declarations
+/** !
+ * Apply every published push. The caller must hold the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param p_signal          set if the event file descriptor should be signaled
+ * @param p_notify          set if the consumer thread should be notified
+ *
+ * @return void
+ */
+static void circular_buffer_combining_apply ( circular_buffer *const p_circular_buffer, bool *p_signal, bool *p_notify );
+
+/** !
+ * Take the lock, apply every published push, and wake event loops and the
+ * consumer thread
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param locked            true if the caller already holds the lock
+ *
+ * @return void
+ */
+static void circular_buffer_combining_pass ( circular_buffer *const p_circular_buffer, bool locked );
+
+// Function definitions
+int circular_buffer_construct_combining ( circular_buffer **const pp_circular_buffer, size_t size, size_t slots )
+{
+
+	// Argument check
+	if ( pp_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( size               ==          0 ) goto no_size;
+
+	// Initialized data
+	circular_buffer                    *p_circular_buffer = (void *) 0;
+	struct circular_buffer_combining_s *p_combining       = (void *) 0;
+
+	// Default
+	if ( slots == 0 ) slots = CIRCULAR_BUFFER_COMBINING_DEFAULT_SLOTS;
+
+	// Allocate memory for the publication slots
+	p_combining = CIRCULAR_BUFFER_REALLOC(0, sizeof(struct circular_buffer_combining_s) + slots * sizeof(struct circular_buffer_combining_slot_s));
+
+	// Error check
+	if ( p_combining == (void *) 0 ) goto no_mem;
+
+	// Zero set
+	memset(p_combining, 0, sizeof(struct circular_buffer_combining_s) + slots * sizeof(struct circular_buffer_combining_slot_s));
+
+	// Store the quantity of slots
+	p_combining->slots = slots;
+
+	// Construct the circular buffer
+	if ( circular_buffer_construct(&p_circular_buffer, size) == 0 ) goto failed_to_construct_circular_buffer;
+
+	// Attach the slots
+	p_circular_buffer->_p_combining  = p_combining;
+	p_circular_buffer->features     |= CIRCULAR_BUFFER_FEATURE_COMBINING;
+
+	// Return a pointer to the caller
+	*pp_circular_buffer = p_circular_buffer;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_size:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"size\" must be greater than zero in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			failed_to_construct_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Failed to construct circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free the slots
+				p_combining = CIRCULAR_BUFFER_REALLOC(p_combining, 0);
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_combining_push ( circular_buffer *const p_circular_buffer, void *p_data )
+{
+
+	// Initialized data
+	struct circular_buffer_combining_s      *p_combining = p_circular_buffer->_p_combining;
+	struct circular_buffer_combining_slot_s *p_slot      = (void *) 0;
+	unsigned                                 expected    = CIRCULAR_BUFFER_COMBINING_FREE,
+	                                         spin        = __atomic_load_n(&p_circular_buffer->_lock.spin, __ATOMIC_RELAXED);
+	int                                      ret         = 0;
+
+	// Number this thread on first use
+	if ( thread_number == 0 ) thread_number = __atomic_add_fetch(&next_thread_number, 1, __ATOMIC_RELAXED);
+
+	// This thread's slot
+	p_slot = &p_combining->_slots[( thread_number - 1 ) % p_combining->slots];
+
+	// Another thread is using the slot, so take the lock directly
+	if ( __atomic_compare_exchange_n(&p_slot->state, &expected, CIRCULAR_BUFFER_COMBINING_CLAIMED, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) == false )
+	{
+
+		// Initialized data
+		bool   signal = false;
+		size_t count  = 0;
+
+		// Lock
+		circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+		// Store the element
+		ret = circular_buffer_push_unlocked(p_circular_buffer, p_data, &signal, &count);
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Wake event loops
+		if ( signal ) circular_buffer_event_signal(p_circular_buffer);
+
+		// Wake the consumer thread
+		if ( count ) circular_buffer_consumer_notify(p_circular_buffer, count);
+
+		// Done
+		return ret;
+	}
+
+	// Publish the push
+	p_slot->p_data = p_data;
+	__atomic_store_n(&p_slot->state, CIRCULAR_BUFFER_COMBINING_PENDING, __ATOMIC_RELEASE);
+
+	// Wait for a combiner, or become one
+	for (unsigned i = 0; __atomic_load_n(&p_slot->state, __ATOMIC_ACQUIRE) != CIRCULAR_BUFFER_COMBINING_DONE; i++)
+	{
+
+		// The lock is free, so apply every published push
+		if ( __atomic_load_n(&p_circular_buffer->_lock.state, __ATOMIC_RELAXED) == 0 && circular_buffer_lock_try(&p_circular_buffer->_lock) )
+		{
+			circular_buffer_combining_pass(p_circular_buffer, true);
+			continue;
+		}
+
+		// The combiner is slow, so wait for the lock
+		if ( i >= spin )
+		{
+			circular_buffer_combining_pass(p_circular_buffer, false);
+			continue;
+		}
+
+		// Back off
+		CIRCULAR_BUFFER_PAUSE();
+	}
+
+	// Collect the result
+	ret = p_slot->result;
+
+	// Release the slot
+	__atomic_store_n(&p_slot->state, CIRCULAR_BUFFER_COMBINING_FREE, __ATOMIC_RELEASE);
+
+	// Done
+	return ret;
+}
+
+void circular_buffer_combining_destroy ( circular_buffer *const p_circular_buffer )
+{
+
+	// Free the slots
+	p_circular_buffer->_p_combining  = CIRCULAR_BUFFER_REALLOC(p_circular_buffer->_p_combining, 0);
+	p_circular_buffer->features     &= ~CIRCULAR_BUFFER_FEATURE_COMBINING;
+
+	// Done
+	return;
+}
+
+static void circular_buffer_combining_apply ( circular_buffer *const p_circular_buffer, bool *p_signal, bool *p_notify )
+{
+
+	// Initialized data
+	struct circular_buffer_combining_s *p_combining = p_circular_buffer->_p_combining;
+
+	// Each slot
+	for (size_t i = 0; i < p_combining->slots; i++)
+	{
+
+		// Initialized data
+		struct circular_buffer_combining_slot_s *p_slot = &p_combining->_slots[i];
+		size_t                                   count  = 0;
+
+		// Skip slots without a published push
+		if ( __atomic_load_n(&p_slot->state, __ATOMIC_ACQUIRE) != CIRCULAR_BUFFER_COMBINING_PENDING ) continue;
+
+		// Apply the push
+		p_slot->result = circular_buffer_push_unlocked(p_circular_buffer, p_slot->p_data, p_signal, &count);
+		if ( count ) *p_notify = true;
+
+		// Hand the result back to the producer
+		__atomic_store_n(&p_slot->state, CIRCULAR_BUFFER_COMBINING_DONE, __ATOMIC_RELEASE);
+	}
+
+	// Done
+	return;
+}
+
+static void circular_buffer_combining_pass ( circular_buffer *const p_circular_buffer, bool locked )
+{
+
+	// Initialized data
+	bool signal = false,
+	     notify = false;
+
+	// Lock
+	if ( locked == false ) circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Apply every published push
+	circular_buffer_combining_apply(p_circular_buffer, &signal, &notify);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Wake event loops
+	if ( signal ) circular_buffer_event_signal(p_circular_buffer);
+
+	// Wake the consumer thread. The pass may have filled an empty circular buffer.
+	if ( notify ) circular_buffer_consumer_notify(p_circular_buffer, 1);
+
+	// Done
+	return;
+}
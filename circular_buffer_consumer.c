@@ -0,0 +1,418 @@
+/** !
+ * Circular buffer consumer thread implementation
+ *
+ * @file circular_buffer_consumer.c
+ *
+ * @author Jacob Smith
+ */
+
+// Feature test macros
+#define _POSIX_C_SOURCE 200809L
+
+// Header
+#include <circular_buffer/consumer.h>
+
+// Internal
+#include "circular_buffer_internal.h"
+
+// Platform dependent includes
+#ifndef _WIN64
+	#include <pthread.h>
+	#include <time.h>
+#endif
+
+// Structure definitions
+#ifndef _WIN64
+struct circular_buffer_consumer_s
+{
+	pthread_t                     thread;
+	pthread_mutex_t               lock;
+	pthread_cond_t                wake;
+	bool                          stop;
+	size_t                        max_batch;
+	timestamp                     max_linger;
+	fn_circular_buffer_consumer  *pfn_consumer;
+	void                         *p_context;
+	void                         *_p_batch[];
+};
+#endif
+
+// Function declarations
+#ifndef _WIN64
+/** !
+ * Get the quantity of elements in a circular buffer
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return the quantity of elements
+ */
+static size_t circular_buffer_consumer_count ( circular_buffer *const p_circular_buffer );
+
+/** !
+ * Drain the circular buffer in batches until it is empty or the consumer
+ * is asked to stop
+ *
+ * @param p_parameter the circular buffer
+ *
+ * @return null
+ */
+static void *circular_buffer_consumer_thread ( void *p_parameter );
+#endif
+
+// Function definitions
+int circular_buffer_attach_consumer ( circular_buffer *const p_circular_buffer, fn_circular_buffer_consumer *pfn_consumer, const circular_buffer_consumer_options *p_options )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( pfn_consumer      == (void *) 0 ) goto no_consumer;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+	if ( p_circular_buffer->_p_consumer ) goto already_attached;
+
+	#ifndef _WIN64
+	{
+
+		// Initialized data
+		size_t                              max_batch   = ( p_options && p_options->max_batch  ) ? p_options->max_batch  : CIRCULAR_BUFFER_CONSUMER_DEFAULT_BATCH;
+		timestamp                           max_linger  = ( p_options && p_options->max_linger ) ? p_options->max_linger : timer_seconds_divisor() / 1000;
+		struct circular_buffer_consumer_s  *p_consumer  = (void *) 0;
+		pthread_condattr_t                  attributes;
+
+		// A batch can never exceed the circular buffer
+		if ( max_batch > p_circular_buffer->length ) max_batch = p_circular_buffer->length;
+
+		// Allocate memory for the consumer and its batch
+		p_consumer = CIRCULAR_BUFFER_REALLOC(0, sizeof(struct circular_buffer_consumer_s) + max_batch * sizeof(void *));
+
+		// Error check
+		if ( p_consumer == (void *) 0 ) goto no_mem;
+
+		// Populate the consumer
+		*p_consumer = (struct circular_buffer_consumer_s)
+		{
+			.stop         = false,
+			.max_batch    = max_batch,
+			.max_linger   = max_linger,
+			.pfn_consumer = pfn_consumer,
+			.p_context    = p_options ? p_options->p_context : (void *) 0
+		};
+
+		// Linger deadlines are measured on the monotonic clock
+		pthread_condattr_init(&attributes);
+		pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+
+		// Create the lock and the condition variable
+		pthread_mutex_init(&p_consumer->lock, (void *) 0);
+		pthread_cond_init(&p_consumer->wake, &attributes);
+		pthread_condattr_destroy(&attributes);
+
+		// Lock
+		circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+		// Route pushes through the consumer
+		p_circular_buffer->_p_consumer  = p_consumer;
+		p_circular_buffer->features    |= CIRCULAR_BUFFER_FEATURE_CONSUMER;
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Start the consumer thread
+		if ( pthread_create(&p_consumer->thread, (void *) 0, circular_buffer_consumer_thread, p_circular_buffer) ) goto failed_to_create_thread;
+
+		// Success
+		return 1;
+
+		// Error handling
+		{
+
+			// Standard library errors
+			{
+				no_mem:
+					#ifndef NDEBUG
+						log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+					#endif
+
+					// Error
+					return 0;
+
+				failed_to_create_thread:
+					#ifndef NDEBUG
+						log_error("[Standard Library] Failed to create thread in call to function \"%s\"\n", __FUNCTION__);
+					#endif
+
+					// Lock
+					circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+					// Detach the consumer
+					p_circular_buffer->_p_consumer  = (void *) 0;
+					p_circular_buffer->features    &= ~CIRCULAR_BUFFER_FEATURE_CONSUMER;
+
+					// Unlock
+					circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+					// Release the consumer
+					pthread_cond_destroy(&p_consumer->wake);
+					pthread_mutex_destroy(&p_consumer->lock);
+					p_consumer = CIRCULAR_BUFFER_REALLOC(p_consumer, 0);
+
+					// Error
+					return 0;
+			}
+		}
+	}
+	#else
+		(void) p_options;
+
+		// Error
+		goto no_threads;
+	#endif
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_consumer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pfn_consumer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			already_attached:
+				#ifndef NDEBUG
+					log_error("[circular buffer] A consumer is already attached in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			#ifdef _WIN64
+				no_threads:
+					#ifndef NDEBUG
+						log_error("[circular buffer] Consumer threads are not supported on this platform in call to function \"%s\"\n", __FUNCTION__);
+					#endif
+
+					// Error
+					return 0;
+			#endif
+		}
+	}
+}
+
+int circular_buffer_detach_consumer ( circular_buffer *const p_circular_buffer )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_circular_buffer->_p_consumer == (void *) 0 ) goto no_consumer;
+
+	#ifndef _WIN64
+	{
+
+		// Initialized data
+		struct circular_buffer_consumer_s *p_consumer = p_circular_buffer->_p_consumer;
+
+		// The consumer thread can not join itself
+		if ( pthread_equal(pthread_self(), p_consumer->thread) ) goto called_from_consumer;
+
+		// Lock
+		pthread_mutex_lock(&p_consumer->lock);
+
+		// Ask the consumer thread to drain and exit
+		p_consumer->stop = true;
+		pthread_cond_signal(&p_consumer->wake);
+
+		// Unlock
+		pthread_mutex_unlock(&p_consumer->lock);
+
+		// Wait for the consumer thread
+		pthread_join(p_consumer->thread, (void *) 0);
+
+		// Lock
+		circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+		// Detach the consumer
+		p_circular_buffer->_p_consumer  = (void *) 0;
+		p_circular_buffer->features    &= ~CIRCULAR_BUFFER_FEATURE_CONSUMER;
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Release the consumer
+		pthread_cond_destroy(&p_consumer->wake);
+		pthread_mutex_destroy(&p_consumer->lock);
+		p_consumer = CIRCULAR_BUFFER_REALLOC(p_consumer, 0);
+
+		// Success
+		return 1;
+
+		// Error handling
+		{
+
+			// Circular buffer errors
+			{
+				called_from_consumer:
+					#ifndef NDEBUG
+						log_error("[circular buffer] Can not detach a consumer from its own callback in call to function \"%s\"\n", __FUNCTION__);
+					#endif
+
+					// Error
+					return 0;
+			}
+		}
+	}
+	#endif
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			no_consumer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] No consumer is attached in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+void circular_buffer_consumer_notify ( circular_buffer *const p_circular_buffer, size_t count )
+{
+
+	#ifndef _WIN64
+	{
+
+		// Initialized data
+		struct circular_buffer_consumer_s *p_consumer = p_circular_buffer->_p_consumer;
+
+		// The consumer thread only waits for the first element and for a full batch
+		if ( count != 1 && count != p_consumer->max_batch ) return;
+
+		// Lock
+		pthread_mutex_lock(&p_consumer->lock);
+
+		// Wake the consumer thread
+		pthread_cond_signal(&p_consumer->wake);
+
+		// Unlock
+		pthread_mutex_unlock(&p_consumer->lock);
+	}
+	#else
+		(void) p_circular_buffer;
+		(void) count;
+	#endif
+
+	// Done
+	return;
+}
+
+#ifndef _WIN64
+static size_t circular_buffer_consumer_count ( circular_buffer *const p_circular_buffer )
+{
+
+	// Initialized data
+	size_t ret = 0;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Count the elements, including any waiting in the spill tier
+	ret = circular_buffer_count_unlocked(p_circular_buffer);
+	if ( p_circular_buffer->_p_spill ) ret += p_circular_buffer->_p_spill->count;
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return ret;
+}
+
+static void *circular_buffer_consumer_thread ( void *p_parameter )
+{
+
+	// Initialized data
+	circular_buffer                   *p_circular_buffer = p_parameter;
+	struct circular_buffer_consumer_s *p_consumer        = p_circular_buffer->_p_consumer;
+	size_t                             count             = 0;
+	struct timespec                    deadline          = { 0 };
+	long long                          linger_ns         = (long long) ( (double) p_consumer->max_linger * 1000000000.0 / (double) timer_seconds_divisor() );
+
+	// Lock
+	pthread_mutex_lock(&p_consumer->lock);
+
+	// Until asked to stop
+	while ( p_consumer->stop == false )
+	{
+
+		// Sleep while the circular buffer is empty. Producers signal under
+		// this lock, so a push between the check and the wait is not lost.
+		while ( p_consumer->stop == false && circular_buffer_consumer_count(p_circular_buffer) == 0 )
+			pthread_cond_wait(&p_consumer->wake, &p_consumer->lock);
+
+		// Compute the linger deadline
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		deadline.tv_sec  += (time_t) ( linger_ns / 1000000000 );
+		deadline.tv_nsec += (long)   ( linger_ns % 1000000000 );
+		if ( deadline.tv_nsec >= 1000000000 ) deadline.tv_sec++, deadline.tv_nsec -= 1000000000;
+
+		// Linger until a full batch is available or the deadline passes
+		while ( p_consumer->stop == false && circular_buffer_consumer_count(p_circular_buffer) < p_consumer->max_batch )
+			if ( pthread_cond_timedwait(&p_consumer->wake, &p_consumer->lock, &deadline) ) break;
+
+		// Unlock
+		pthread_mutex_unlock(&p_consumer->lock);
+
+		// Deliver a batch without holding any lock
+		count = circular_buffer_pop_batch(p_circular_buffer, p_consumer->_p_batch, p_consumer->max_batch);
+		if ( count ) p_consumer->pfn_consumer(p_consumer->_p_batch, count, p_consumer->p_context);
+
+		// Lock
+		pthread_mutex_lock(&p_consumer->lock);
+	}
+
+	// Unlock
+	pthread_mutex_unlock(&p_consumer->lock);
+
+	// Deliver whatever is left before exiting
+	while ( ( count = circular_buffer_pop_batch(p_circular_buffer, p_consumer->_p_batch, p_consumer->max_batch) ) )
+		p_consumer->pfn_consumer(p_consumer->_p_batch, count, p_consumer->p_context);
+
+	// Done
+	return (void *) 0;
+}
+#endif
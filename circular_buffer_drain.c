@@ -0,0 +1,237 @@
+/** !
+ * Double buffered drain implementation
+ *
+ * @file circular_buffer_drain.c
+ *
+ * @author Jacob Smith
+ */
+
+// Header
+#include <circular_buffer/drain.h>
+
+// Internal
+#include "circular_buffer_internal.h"
+
+// Standard library
+#include <string.h>
+
+// Function definitions
+size_t circular_buffer_drain_all ( circular_buffer *const p_circular_buffer, circular_buffer_batch *const p_batch )
+{
+
+	// Argument check
+	if ( p_circular_buffer       == (void *) 0 ) goto no_circular_buffer;
+	if ( p_batch                 == (void *) 0 ) goto no_batch;
+	if ( p_circular_buffer->features           ) goto has_features;
+
+	// Initialized data
+	void   **p_block = (void *) 0;
+	size_t   count   = 0;
+
+	// Empty batch
+	*p_batch = (circular_buffer_batch) { 0 };
+
+	// Allocate the spare block on the first drain, outside the lock
+	if ( CIRCULAR_BUFFER_LOAD(p_circular_buffer->_p_drain) == (void *) 0 )
+	{
+
+		// Allocate memory for the spare block
+		p_block = CIRCULAR_BUFFER_REALLOC(0, CIRCULAR_BUFFER_STORAGE_SIZE(p_circular_buffer->length));
+
+		// Error check
+		if ( p_block == (void *) 0 ) goto no_mem;
+
+		// Touch every page of the block, so the hot path never faults
+		memset(p_block, 0, CIRCULAR_BUFFER_STORAGE_SIZE(p_circular_buffer->length));
+	}
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Install the spare block, unless another drain got there first
+	if ( p_block && p_circular_buffer->_p_drain == (void *) 0 )
+	{
+		CIRCULAR_BUFFER_STORE(p_circular_buffer->_p_drain, p_block);
+		p_circular_buffer->_p_spare = p_block;
+		p_block                     = (void *) 0;
+	}
+
+	// The previous batch has not been released
+	if ( p_circular_buffer->_p_spare == (void *) 0 ) goto batch_outstanding;
+
+	// Count the elements
+	count = circular_buffer_count_unlocked(p_circular_buffer);
+
+	// Nothing to drain
+	if ( count == 0 ) goto done;
+
+	// Hand the storage to the batch
+	*p_batch = (circular_buffer_batch)
+	{
+		.count   = count,
+		.read    = p_circular_buffer->read,
+		.length  = p_circular_buffer->length,
+		._p_data = p_circular_buffer->_p_data
+	};
+
+	// Continue into the spare block
+	p_circular_buffer->_p_data  = p_circular_buffer->_p_spare;
+	p_circular_buffer->_p_spare = (void *) 0;
+
+	// Empty the circular buffer
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->read, 0);
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->write, 0);
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->full, false);
+
+	done:
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Free a block that lost the race to be installed
+	if ( p_block ) p_block = CIRCULAR_BUFFER_REALLOC(p_block, 0);
+
+	// Trace the drain
+	CIRCULAR_BUFFER_PROBE2(drain, p_circular_buffer, count);
+
+	// Success
+	return count;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_batch:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_batch\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			has_features:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer has features that can not be drained in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			batch_outstanding:
+
+				// Unlock
+				circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+				#ifndef NDEBUG
+					log_error("[circular buffer] Previous batch has not been released in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free a block that lost the race to be installed
+				if ( p_block ) p_block = CIRCULAR_BUFFER_REALLOC(p_block, 0);
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_batch_release ( circular_buffer *const p_circular_buffer, circular_buffer_batch *const p_batch )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_batch           == (void *) 0 ) goto no_batch;
+
+	// An empty batch holds no storage
+	if ( p_batch->_p_data == (void *) 0 ) return 1;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// The batch was not drained from this circular buffer
+	if ( p_circular_buffer->_p_spare || p_batch->length != p_circular_buffer->length ) goto wrong_circular_buffer;
+
+	// The storage is the spare block of the next drain
+	p_circular_buffer->_p_spare = p_batch->_p_data;
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Empty batch
+	*p_batch = (circular_buffer_batch) { 0 };
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_batch:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_batch\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			wrong_circular_buffer:
+
+				// Unlock
+				circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+				#ifndef NDEBUG
+					log_error("[circular buffer] Batch was not drained from this circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+void circular_buffer_drain_destroy ( circular_buffer *const p_circular_buffer )
+{
+
+	// Free the spare block
+	p_circular_buffer->_p_drain = CIRCULAR_BUFFER_REALLOC(p_circular_buffer->_p_drain, 0);
+	p_circular_buffer->_p_spare = (void *) 0;
+
+	// Done
+	return;
+}
@@ -0,0 +1,206 @@
+/** !
+ * Circular buffer event file descriptor implementation
+ *
+ * @file circular_buffer_event.c
+ *
+ * @author Jacob Smith
+ */
+
+// Header
+#include <circular_buffer/event.h>
+
+// Internal
+#include "circular_buffer_internal.h"
+
+// Platform dependent includes
+#ifdef __linux__
+	#include <stdint.h>
+	#include <unistd.h>
+	#include <sys/eventfd.h>
+#endif
+
+// Function definitions
+int circular_buffer_get_fd ( circular_buffer *const p_circular_buffer )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+
+	#ifdef __linux__
+	{
+
+		// Lock
+		circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+		// Create the event file descriptor on first use
+		if ( ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_EVENT ) == 0 )
+		{
+
+			// Initialized data
+			int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+			// Error check
+			if ( fd == -1 ) goto failed_to_create_eventfd;
+
+			// Store the event file descriptor
+			p_circular_buffer->_event_fd  = fd;
+			p_circular_buffer->features  |= CIRCULAR_BUFFER_FEATURE_EVENT;
+
+			// A non empty circular buffer is already readable
+			if ( circular_buffer_count_unlocked(p_circular_buffer) ) circular_buffer_event_signal(p_circular_buffer);
+		}
+
+		// Initialized data
+		int ret = p_circular_buffer->_event_fd;
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Success
+		return ret;
+	}
+	#else
+
+		// Error
+		goto no_eventfd;
+	#endif
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return -1;
+		}
+
+		// Platform errors
+		{
+			#ifdef __linux__
+				failed_to_create_eventfd:
+					#ifndef NDEBUG
+						log_error("[Standard Library] Failed to create eventfd in call to function \"%s\"\n", __FUNCTION__);
+					#endif
+
+					// Unlock
+					circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+					// Error
+					return -1;
+			#else
+				no_eventfd:
+					#ifndef NDEBUG
+						log_error("[circular buffer] Event file descriptors are not supported on this platform in call to function \"%s\"\n", __FUNCTION__);
+					#endif
+
+					// Error
+					return -1;
+			#endif
+		}
+	}
+}
+
+int circular_buffer_set_fd_watermark ( circular_buffer *const p_circular_buffer, size_t watermark )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( watermark > p_circular_buffer->length ) goto watermark_too_large;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Store the watermark
+	p_circular_buffer->_event_watermark = watermark;
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			watermark_too_large:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"watermark\" exceeds the size of the circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+void circular_buffer_event_signal ( circular_buffer *const p_circular_buffer )
+{
+
+	#ifdef __linux__
+	{
+
+		// Initialized data
+		uint64_t one = 1;
+
+		// Make the event file descriptor readable
+		(void) !write(p_circular_buffer->_event_fd, &one, sizeof(uint64_t));
+	}
+	#else
+		(void) p_circular_buffer;
+	#endif
+
+	// Done
+	return;
+}
+
+void circular_buffer_event_clear ( circular_buffer *const p_circular_buffer )
+{
+
+	#ifdef __linux__
+	{
+
+		// Initialized data
+		uint64_t value = 0;
+
+		// Reset the counter. The descriptor is non blocking, so this is a no-op if nothing is pending.
+		(void) !read(p_circular_buffer->_event_fd, &value, sizeof(uint64_t));
+	}
+	#else
+		(void) p_circular_buffer;
+	#endif
+
+	// Done
+	return;
+}
+
+void circular_buffer_event_destroy ( circular_buffer *const p_circular_buffer )
+{
+
+	#ifdef __linux__
+
+		// Close the event file descriptor
+		close(p_circular_buffer->_event_fd);
+	#endif
+
+	// Detach the event file descriptor
+	p_circular_buffer->_event_fd  = -1;
+	p_circular_buffer->features  &= ~CIRCULAR_BUFFER_FEATURE_EVENT;
+
+	// Done
+	return;
+}
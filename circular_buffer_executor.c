@@ -0,0 +1,835 @@
+/** !
+ * Work stealing executor implementation
+ *
+ * @file circular_buffer_executor.c
+ *
+ * @author Jacob Smith
+ */
+
+// Feature test macros
+#define _POSIX_C_SOURCE 200809L
+
+// Header
+#include <circular_buffer/executor.h>
+
+// Internal
+#include "circular_buffer_internal.h"
+
+#ifndef _WIN64
+
+// Platform dependent includes
+#include <pthread.h>
+#include <sched.h>
+
+// Preprocessor definitions
+#define CIRCULAR_BUFFER_EXECUTOR_LINE  64
+#define CIRCULAR_BUFFER_EXECUTOR_BATCH 32
+#define CIRCULAR_BUFFER_EXECUTOR_SPIN  64
+
+// Structure definitions
+struct circular_buffer_executor_worker_s
+{
+
+	// Written by the owner. The padding keeps the bottom and the top of the
+	// deque on separate cache lines, since thieves only touch the top.
+	int64_t bottom;
+	char    _bottom_pad[CIRCULAR_BUFFER_EXECUTOR_LINE - sizeof(int64_t)];
+
+	// Advanced by the owner and by thieves
+	int64_t top;
+	char    _top_pad[CIRCULAR_BUFFER_EXECUTOR_LINE - sizeof(int64_t)];
+
+	size_t                             steals;
+	uint64_t                           seed;
+	pthread_t                          thread;
+	struct circular_buffer_executor_s *p_executor;
+	void                             **_p_tasks, **_p_batch;
+};
+
+struct circular_buffer_executor_s
+{
+	circular_buffer                          *p_injection;
+	size_t                                    workers, started, mask, batch, pending, sleeping;
+	bool                                      stop;
+	fn_circular_buffer_task                  *pfn_task;
+	void                                     *p_context;
+	pthread_mutex_t                           lock;
+	pthread_cond_t                            wake, idle;
+	struct circular_buffer_executor_worker_s *_p_workers;
+	void                                    **_p_storage;
+};
+
+// Data
+static _Thread_local struct circular_buffer_executor_worker_s *p_current_worker = (void *) 0;
+
+// Function declarations
+/** !
+ * Push a task to the bottom of a deque. Only the owner calls this.
+ *
+ * @param p_worker the owner of the deque
+ * @param p_task   the task
+ *
+ * @return 1 on success, 0 if the deque is full
+ */
+static int circular_buffer_executor_deque_push ( struct circular_buffer_executor_worker_s *const p_worker, void *p_task );
+
+/** !
+ * Take the most recent task from the bottom of a deque. Only the owner
+ * calls this.
+ *
+ * @param p_worker the owner of the deque
+ *
+ * @return the task, or null if the deque is empty
+ */
+static void *circular_buffer_executor_deque_take ( struct circular_buffer_executor_worker_s *const p_worker );
+
+/** !
+ * Steal the oldest task from the top of another worker's deque
+ *
+ * @param p_worker the owner of the deque
+ *
+ * @return the task, or null if the deque is empty or another thief won
+ */
+static void *circular_buffer_executor_deque_steal ( struct circular_buffer_executor_worker_s *const p_worker );
+
+/** !
+ * Push tasks to the injection circular buffer, locking it once
+ *
+ * @param p_executor the executor
+ * @param pp_tasks   the tasks
+ * @param count      the quantity of tasks
+ *
+ * @return the quantity of tasks pushed, which stops short when the circular buffer fills
+ */
+static size_t circular_buffer_executor_inject ( circular_buffer_executor *const p_executor, void *const *pp_tasks, size_t count );
+
+/** !
+ * Check if there is a task anywhere, without taking any lock
+ *
+ * @param p_executor the executor
+ *
+ * @return true if a task is waiting, else false
+ */
+static bool circular_buffer_executor_available ( circular_buffer_executor *const p_executor );
+
+/** !
+ * Find a task for a worker. Look in its own deque, then in the injection
+ * circular buffer, then in the other deques.
+ *
+ * @param p_worker the worker
+ *
+ * @return the task, or null if there is none
+ */
+static void *circular_buffer_executor_find ( struct circular_buffer_executor_worker_s *const p_worker );
+
+/** !
+ * Wake parked workers after a submission
+ *
+ * @param p_executor the executor
+ * @param count      the quantity of tasks submitted
+ *
+ * @return void
+ */
+static void circular_buffer_executor_wake ( circular_buffer_executor *const p_executor, size_t count );
+
+/** !
+ * Retire tasks that ran or failed to submit, releasing waiting threads when
+ * none are left
+ *
+ * @param p_executor the executor
+ * @param count      the quantity of tasks
+ *
+ * @return void
+ */
+static void circular_buffer_executor_retire ( circular_buffer_executor *const p_executor, size_t count );
+
+/** !
+ * Run tasks until the executor stops
+ *
+ * @param p_parameter the worker
+ *
+ * @return null
+ */
+static void *circular_buffer_executor_worker ( void *p_parameter );
+
+/** !
+ * Stop and join the started workers, then free the executor
+ *
+ * @param p_executor the executor
+ *
+ * @return void
+ */
+static void circular_buffer_executor_free ( circular_buffer_executor *p_executor );
+
+// Function definitions
+int circular_buffer_executor_construct ( circular_buffer_executor **const pp_executor, size_t workers, size_t size, fn_circular_buffer_task *pfn_task, void *p_context )
+{
+
+	// Argument check
+	if ( pp_executor ==          (void *) 0 ) goto no_executor;
+	if ( workers     ==                   0 ) goto no_workers;
+	if ( pfn_task    ==          (void *) 0 ) goto no_task;
+
+	// Default
+	if ( size == 0 ) size = CIRCULAR_BUFFER_EXECUTOR_DEFAULT_SIZE;
+
+	// Initialized data
+	circular_buffer_executor *p_executor = (void *) 0;
+	size_t                    capacity   = 2,
+	                          batch      = 0;
+
+	// Round up to a power of two, so the deques index with a mask
+	while ( capacity < size ) capacity <<= 1;
+	batch = ( capacity < CIRCULAR_BUFFER_EXECUTOR_BATCH ) ? capacity : CIRCULAR_BUFFER_EXECUTOR_BATCH;
+
+	// Allocate memory for the executor
+	p_executor = CIRCULAR_BUFFER_REALLOC(0, sizeof(circular_buffer_executor));
+
+	// Error check
+	if ( p_executor == (void *) 0 ) goto no_mem;
+
+	// Populate the struct
+	*p_executor = (circular_buffer_executor)
+	{
+		.p_injection = (void *) 0,
+		.workers     = workers,
+		.started     = 0,
+		.mask        = capacity - 1,
+		.batch       = batch,
+		.pending     = 0,
+		.sleeping    = 0,
+		.stop        = false,
+		.pfn_task    = pfn_task,
+		.p_context   = p_context,
+		._p_workers  = CIRCULAR_BUFFER_REALLOC(0, workers * sizeof(struct circular_buffer_executor_worker_s)),
+		._p_storage  = CIRCULAR_BUFFER_REALLOC(0, workers * ( capacity + batch ) * sizeof(void *))
+	};
+
+	// Initialize the lock and the condition variables
+	pthread_mutex_init(&p_executor->lock, (void *) 0);
+	pthread_cond_init(&p_executor->wake, (void *) 0);
+	pthread_cond_init(&p_executor->idle, (void *) 0);
+
+	// Error check
+	if ( p_executor->_p_workers == (void *) 0 || p_executor->_p_storage == (void *) 0 ) goto no_mem_free;
+
+	// Construct the injection circular buffer
+	if ( circular_buffer_construct(&p_executor->p_injection, capacity) == 0 ) goto failed_to_construct_circular_buffer;
+
+	// Give each worker an empty deque and a batch
+	for (size_t i = 0; i < workers; i++)
+		p_executor->_p_workers[i] = (struct circular_buffer_executor_worker_s)
+		{
+			.bottom     = 0,
+			.top        = 0,
+			.steals     = 0,
+			.seed       = 0x9e3779b97f4a7c15ULL * ( i + 1 ),
+			.p_executor = p_executor,
+			._p_tasks   = &p_executor->_p_storage[i * ( capacity + batch )],
+			._p_batch   = &p_executor->_p_storage[i * ( capacity + batch ) + capacity]
+		};
+
+	// Start the workers
+	for (; p_executor->started < workers; p_executor->started++)
+		if ( pthread_create(&p_executor->_p_workers[p_executor->started].thread, (void *) 0, circular_buffer_executor_worker, &p_executor->_p_workers[p_executor->started]) ) goto failed_to_create_thread;
+
+	// Return a pointer to the caller
+	*pp_executor = p_executor;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_executor:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_executor\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_workers:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"workers\" must be greater than zero in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_task:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pfn_task\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			failed_to_construct_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Failed to construct circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free the executor
+				circular_buffer_executor_free(p_executor);
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			no_mem_free:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free the executor
+				circular_buffer_executor_free(p_executor);
+
+				// Error
+				return 0;
+
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			failed_to_create_thread:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to create thread in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Stop the workers that started, and free the executor
+				circular_buffer_executor_free(p_executor);
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_executor_steals ( circular_buffer_executor *const p_executor )
+{
+
+	// Argument check
+	if ( p_executor == (void *) 0 ) goto no_executor;
+
+	// Initialized data
+	size_t ret = 0;
+
+	// Sum the steals of each worker
+	for (size_t i = 0; i < p_executor->workers; i++) ret += __atomic_load_n(&p_executor->_p_workers[i].steals, __ATOMIC_RELAXED);
+
+	// Success
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_executor:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_executor\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_executor_submit ( circular_buffer_executor *const p_executor, void *p_task )
+{
+
+	// Argument check
+	if ( p_executor == (void *) 0 ) goto no_executor;
+	if ( p_task     == (void *) 0 ) goto no_task;
+
+	// Success
+	return circular_buffer_executor_submit_batch(p_executor, &p_task, 1) == 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_executor:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_executor\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_task:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_task\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_executor_submit_batch ( circular_buffer_executor *const p_executor, void *const *pp_tasks, size_t count )
+{
+
+	// Argument check
+	if ( p_executor == (void *) 0 ) goto no_executor;
+	if ( pp_tasks   == (void *) 0 ) goto no_tasks;
+
+	// Initialized data
+	struct circular_buffer_executor_worker_s *p_worker  = p_current_worker;
+	size_t                                    submitted = 0;
+
+	// Count the tasks before they can run
+	__atomic_fetch_add(&p_executor->pending, count, __ATOMIC_ACQ_REL);
+
+	// A worker of this executor keeps its subtasks
+	if ( p_worker && p_worker->p_executor == p_executor )
+		while ( submitted < count && circular_buffer_executor_deque_push(p_worker, pp_tasks[submitted]) ) submitted++;
+
+	// Everything else goes to the injection circular buffer
+	submitted += circular_buffer_executor_inject(p_executor, pp_tasks + submitted, count - submitted);
+
+	// Wake parked workers
+	if ( submitted ) circular_buffer_executor_wake(p_executor, submitted);
+
+	// Tasks that did not fit will never run
+	if ( submitted < count ) circular_buffer_executor_retire(p_executor, count - submitted);
+
+	// Success
+	return submitted;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_executor:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_executor\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_tasks:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_tasks\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_executor_wait ( circular_buffer_executor *const p_executor )
+{
+
+	// Argument check
+	if ( p_executor == (void *) 0 ) goto no_executor;
+	if ( p_current_worker && p_current_worker->p_executor == p_executor ) goto called_from_worker;
+
+	// Lock
+	pthread_mutex_lock(&p_executor->lock);
+
+	// Wait for the last task
+	while ( __atomic_load_n(&p_executor->pending, __ATOMIC_ACQUIRE) ) pthread_cond_wait(&p_executor->idle, &p_executor->lock);
+
+	// Unlock
+	pthread_mutex_unlock(&p_executor->lock);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_executor:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_executor\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Executor errors
+		{
+			called_from_worker:
+				#ifndef NDEBUG
+					log_error("[circular buffer] A worker can not wait for its own executor in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_executor_destroy ( circular_buffer_executor **const pp_executor )
+{
+
+	// Argument check
+	if ( pp_executor == (void *) 0 ) goto no_executor;
+	if ( *pp_executor == (void *) 0 ) goto no_executor;
+
+	// Initialized data
+	circular_buffer_executor *p_executor = *pp_executor;
+
+	// Run every submitted task
+	if ( circular_buffer_executor_wait(p_executor) == 0 ) return 0;
+
+	// No more executor for end user
+	*pp_executor = (void *) 0;
+
+	// Stop the workers, and free the executor
+	circular_buffer_executor_free(p_executor);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_executor:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_executor\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+static int circular_buffer_executor_deque_push ( struct circular_buffer_executor_worker_s *const p_worker, void *p_task )
+{
+
+	// Initialized data
+	size_t  mask = p_worker->p_executor->mask;
+	int64_t b    = __atomic_load_n(&p_worker->bottom, __ATOMIC_RELAXED),
+	        t    = __atomic_load_n(&p_worker->top, __ATOMIC_ACQUIRE);
+
+	// Full
+	if ( b - t > (int64_t) mask ) return 0;
+
+	// Store the task, then publish it to thieves
+	__atomic_store_n(&p_worker->_p_tasks[(size_t) b & mask], p_task, __ATOMIC_RELAXED);
+	__atomic_store_n(&p_worker->bottom, b + 1, __ATOMIC_RELEASE);
+
+	// Success
+	return 1;
+}
+
+static void *circular_buffer_executor_deque_take ( struct circular_buffer_executor_worker_s *const p_worker )
+{
+
+	// Initialized data
+	size_t  mask   = p_worker->p_executor->mask;
+	int64_t b      = __atomic_load_n(&p_worker->bottom, __ATOMIC_RELAXED) - 1,
+	        t      = 0;
+	void   *p_task = (void *) 0;
+
+	// Reserve the bottom task before looking at the top, so a thief that
+	// reads the top afterwards sees the reservation
+	__atomic_store_n(&p_worker->bottom, b, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	t = __atomic_load_n(&p_worker->top, __ATOMIC_RELAXED);
+
+	// Empty
+	if ( t > b )
+	{
+		__atomic_store_n(&p_worker->bottom, b + 1, __ATOMIC_RELAXED);
+		return (void *) 0;
+	}
+
+	// Take the task
+	p_task = __atomic_load_n(&p_worker->_p_tasks[(size_t) b & mask], __ATOMIC_RELAXED);
+
+	// More than one task, so no thief can reach this one
+	if ( t < b ) return p_task;
+
+	// The last task. Race thieves for it through the top.
+	if ( __atomic_compare_exchange_n(&p_worker->top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED) == false ) p_task = (void *) 0;
+	__atomic_store_n(&p_worker->bottom, b + 1, __ATOMIC_RELAXED);
+
+	// Done
+	return p_task;
+}
+
+static void *circular_buffer_executor_deque_steal ( struct circular_buffer_executor_worker_s *const p_worker )
+{
+
+	// Initialized data
+	size_t  mask   = p_worker->p_executor->mask;
+	int64_t t      = __atomic_load_n(&p_worker->top, __ATOMIC_ACQUIRE),
+	        b      = 0;
+	void   *p_task = (void *) 0;
+
+	// Read the top before the bottom
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	b = __atomic_load_n(&p_worker->bottom, __ATOMIC_ACQUIRE);
+
+	// Empty
+	if ( t >= b ) return (void *) 0;
+
+	// Read the oldest task, then claim it
+	p_task = __atomic_load_n(&p_worker->_p_tasks[(size_t) t & mask], __ATOMIC_RELAXED);
+	if ( __atomic_compare_exchange_n(&p_worker->top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED) == false ) return (void *) 0;
+
+	// Success
+	return p_task;
+}
+
+static size_t circular_buffer_executor_inject ( circular_buffer_executor *const p_executor, void *const *pp_tasks, size_t count )
+{
+
+	// Initialized data
+	circular_buffer *p_injection = p_executor->p_injection;
+	size_t           pushed      = 0,
+	                 occupancy   = 0;
+	bool             signal      = false;
+
+	// Nothing to push
+	if ( count == 0 ) return 0;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_injection->_lock);
+
+	// Push until full. Tasks are never overwritten.
+	while ( pushed < count && p_injection->full == false )
+		pushed += (size_t) circular_buffer_push_unlocked(p_injection, pp_tasks[pushed], &signal, &occupancy);
+
+	// Unlock
+	circular_buffer_lock_release(&p_injection->_lock);
+
+	// Success
+	return pushed;
+}
+
+static bool circular_buffer_executor_available ( circular_buffer_executor *const p_executor )
+{
+
+	// Initialized data
+	circular_buffer *p_injection = p_executor->p_injection;
+
+	// The injection circular buffer
+	if ( CIRCULAR_BUFFER_LOAD(p_injection->full) || CIRCULAR_BUFFER_LOAD(p_injection->read) != CIRCULAR_BUFFER_LOAD(p_injection->write) ) return true;
+
+	// Each deque
+	for (size_t i = 0; i < p_executor->workers; i++)
+		if ( __atomic_load_n(&p_executor->_p_workers[i].bottom, __ATOMIC_SEQ_CST) > __atomic_load_n(&p_executor->_p_workers[i].top, __ATOMIC_SEQ_CST) ) return true;
+
+	// Nothing
+	return false;
+}
+
+static void *circular_buffer_executor_find ( struct circular_buffer_executor_worker_s *const p_worker )
+{
+
+	// Initialized data
+	circular_buffer_executor *p_executor  = p_worker->p_executor;
+	circular_buffer          *p_injection = p_executor->p_injection;
+	void                     *p_task      = circular_buffer_executor_deque_take(p_worker);
+	size_t                    count       = 0,
+	                          victim      = 0;
+
+	// Own deque
+	if ( p_task ) return p_task;
+
+	// Move a batch from the injection circular buffer to the deque, which is
+	// empty, and run the oldest task
+	if ( CIRCULAR_BUFFER_LOAD(p_injection->full) || CIRCULAR_BUFFER_LOAD(p_injection->read) != CIRCULAR_BUFFER_LOAD(p_injection->write) )
+	{
+
+		// Take a batch
+		count = circular_buffer_pop_batch(p_injection, p_worker->_p_batch, p_executor->batch);
+
+		// Keep the rest, pushed newest first so the oldest is taken next
+		for (size_t i = count; i-- > 1; ) circular_buffer_executor_deque_push(p_worker, p_worker->_p_batch[i]);
+
+		// Success
+		if ( count ) return p_worker->_p_batch[0];
+	}
+
+	// Pick a random first victim, so thieves spread out
+	p_worker->seed ^= p_worker->seed << 13;
+	p_worker->seed ^= p_worker->seed >> 7;
+	p_worker->seed ^= p_worker->seed << 17;
+	victim           = (size_t) ( p_worker->seed % p_executor->workers );
+
+	// Try each other deque once
+	for (size_t i = 0; i < p_executor->workers; i++, victim = ( victim + 1 ) % p_executor->workers)
+	{
+
+		// Skip the own deque
+		if ( &p_executor->_p_workers[victim] == p_worker ) continue;
+
+		// Steal
+		p_task = circular_buffer_executor_deque_steal(&p_executor->_p_workers[victim]);
+
+		// Count the steal
+		if ( p_task )
+		{
+			__atomic_store_n(&p_worker->steals, p_worker->steals + 1, __ATOMIC_RELAXED);
+			return p_task;
+		}
+	}
+
+	// Nothing
+	return (void *) 0;
+}
+
+static void circular_buffer_executor_wake ( circular_buffer_executor *const p_executor, size_t count )
+{
+
+	// Publish the tasks before looking for parked workers. A worker counts
+	// itself as sleeping before it looks for tasks, so one of the two sees
+	// the other.
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	// No parked workers
+	if ( __atomic_load_n(&p_executor->sleeping, __ATOMIC_RELAXED) == 0 ) return;
+
+	// Lock
+	pthread_mutex_lock(&p_executor->lock);
+
+	// Wake one worker per task
+	if ( count > 1 ) pthread_cond_broadcast(&p_executor->wake);
+	else             pthread_cond_signal(&p_executor->wake);
+
+	// Unlock
+	pthread_mutex_unlock(&p_executor->lock);
+
+	// Done
+	return;
+}
+
+static void circular_buffer_executor_retire ( circular_buffer_executor *const p_executor, size_t count )
+{
+
+	// More tasks are pending
+	if ( __atomic_sub_fetch(&p_executor->pending, count, __ATOMIC_ACQ_REL) ) return;
+
+	// Lock
+	pthread_mutex_lock(&p_executor->lock);
+
+	// Release the waiting threads
+	pthread_cond_broadcast(&p_executor->idle);
+
+	// Unlock
+	pthread_mutex_unlock(&p_executor->lock);
+
+	// Done
+	return;
+}
+
+static void *circular_buffer_executor_worker ( void *p_parameter )
+{
+
+	// Initialized data
+	struct circular_buffer_executor_worker_s *p_worker   = p_parameter;
+	circular_buffer_executor                 *p_executor = p_worker->p_executor;
+	size_t                                    idle       = 0;
+
+	// Submissions from this thread go to its deque
+	p_current_worker = p_worker;
+
+	// Run tasks until the executor stops
+	for (;;)
+	{
+
+		// Initialized data
+		void *p_task = circular_buffer_executor_find(p_worker);
+
+		// Run the task
+		if ( p_task )
+		{
+			p_executor->pfn_task(p_task, p_executor->p_context);
+			circular_buffer_executor_retire(p_executor, 1);
+			idle = 0;
+			continue;
+		}
+
+		// Spin for a while before parking
+		if ( ++idle < CIRCULAR_BUFFER_EXECUTOR_SPIN ) { sched_yield(); continue; }
+		idle = 0;
+
+		// Lock
+		pthread_mutex_lock(&p_executor->lock);
+
+		// Count this worker as sleeping, then look once more
+		__atomic_fetch_add(&p_executor->sleeping, 1, __ATOMIC_SEQ_CST);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		while ( p_executor->stop == false && circular_buffer_executor_available(p_executor) == false )
+			pthread_cond_wait(&p_executor->wake, &p_executor->lock);
+		__atomic_fetch_sub(&p_executor->sleeping, 1, __ATOMIC_SEQ_CST);
+
+		// Stop once there is nothing left to run
+		if ( p_executor->stop && circular_buffer_executor_available(p_executor) == false )
+		{
+			pthread_mutex_unlock(&p_executor->lock);
+			break;
+		}
+
+		// Unlock
+		pthread_mutex_unlock(&p_executor->lock);
+	}
+
+	// Done
+	return (void *) 0;
+}
+
+static void circular_buffer_executor_free ( circular_buffer_executor *p_executor )
+{
+
+	// Lock
+	pthread_mutex_lock(&p_executor->lock);
+
+	// Stop the workers
+	p_executor->stop = true;
+	pthread_cond_broadcast(&p_executor->wake);
+
+	// Unlock
+	pthread_mutex_unlock(&p_executor->lock);
+
+	// Wait for the workers
+	for (size_t i = 0; i < p_executor->started; i++) pthread_join(p_executor->_p_workers[i].thread, (void *) 0);
+
+	// Destroy the injection circular buffer
+	if ( p_executor->p_injection ) circular_buffer_destroy(&p_executor->p_injection);
+
+	// Destroy the lock and the condition variables
+	pthread_cond_destroy(&p_executor->idle);
+	pthread_cond_destroy(&p_executor->wake);
+	pthread_mutex_destroy(&p_executor->lock);
+
+	// Free the memory
+	p_executor->_p_storage = CIRCULAR_BUFFER_REALLOC(p_executor->_p_storage, 0);
+	p_executor->_p_workers = CIRCULAR_BUFFER_REALLOC(p_executor->_p_workers, 0);
+	p_executor             = CIRCULAR_BUFFER_REALLOC(p_executor, 0);
+
+	// Done
+	return;
+}
+
+#endif
@@ -0,0 +1,554 @@
+/** !
+ * Private header shared by the circular buffer translation units
+ *
+ * @file circular_buffer_internal.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+#include <circular_buffer/latency.h>
+#include <circular_buffer/budget.h>
+#include <circular_buffer/drain.h>
+
+// Static tracepoints
+#include <circular_buffer/probes.h>
+
+// Standard library
+#include <stdint.h>
+
+// Structure definitions
+struct circular_buffer_spill_s
+{
+	FILE   *p_writer, *p_reader;
+	char   *p_path;
+	size_t  count;
+	void   *p_context;
+	size_t (*pfn_serialize)( void *p_element, void *p_buffer, size_t size, void *p_context );
+	void  *(*pfn_deserialize)( const void *p_buffer, size_t size, void *p_context );
+	unsigned char *p_scratch, *_p_read_scratch;
+	size_t         scratch_size, read_scratch_size, dropped;
+	circular_buffer_lock _reader;
+	void               **_p_batch;
+};
+
+struct circular_buffer_coalesce_s
+{
+	size_t    mask, coalesced;
+	uint64_t *_p_keys;
+	size_t   *_p_index;
+};
+
+struct circular_buffer_budget_s
+{
+	size_t                    budget, bytes, evicted;
+	fn_circular_buffer_size  *pfn_size;
+	fn_circular_buffer_evict *pfn_evict;
+	void                     *p_context;
+	size_t                    _p_sizes[];
+};
+
+struct circular_buffer_latency_s
+{
+	size_t    sequence, mask, count;
+	timestamp max;
+	size_t    _buckets[CIRCULAR_BUFFER_LATENCY_BUCKETS];
+	timestamp _p_stamps[];
+};
+
+// Function declarations
+/** !
+ * Append an element to the spill log. The caller must hold the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param p_data            the element
+ *
+ * @return 1 on success, 0 on error
+ */
+int circular_buffer_spill_append ( circular_buffer *const p_circular_buffer, void *p_data );
+
+/** !
+ * Move spilled elements back into an empty circular buffer. The log is read
+ * and deserialized without the lock, so the caller must not hold it.
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return void
+ */
+void circular_buffer_spill_refill ( circular_buffer *const p_circular_buffer );
+
+/** !
+ * Close and remove the spill log
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return void
+ */
+void circular_buffer_spill_destroy ( circular_buffer *const p_circular_buffer );
+
+/** !
+ * Get the quantity of spilled elements without taking the lock
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return the quantity of elements in the spill log, 0 without a spill tier
+ */
+static inline size_t circular_buffer_spill_pending ( circular_buffer *const p_circular_buffer )
+{
+
+	// Initialized data
+	struct circular_buffer_spill_s *p_spill = CIRCULAR_BUFFER_LOAD(p_circular_buffer->_p_spill);
+
+	// Success
+	return ( p_spill ) ? CIRCULAR_BUFFER_LOAD(p_spill->count) : 0;
+}
+
+/** !
+ * Signal the event file descriptor. Call after releasing the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return void
+ */
+void circular_buffer_event_signal ( circular_buffer *const p_circular_buffer );
+
+/** !
+ * Consume a pending signal on the event file descriptor. The caller must hold the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return void
+ */
+void circular_buffer_event_clear ( circular_buffer *const p_circular_buffer );
+
+/** !
+ * Close the event file descriptor
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return void
+ */
+void circular_buffer_event_destroy ( circular_buffer *const p_circular_buffer );
+
+/** !
+ * Wake the consumer thread if a push completed a transition it waits for.
+ * Call after releasing the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param count             the occupancy after the push
+ *
+ * @return void
+ */
+void circular_buffer_consumer_notify ( circular_buffer *const p_circular_buffer, size_t count );
+
+/** !
+ * Push an element, spilling instead of overwriting if a spill tier is
+ * attached. The caller must hold the lock, and after releasing it must
+ * signal the event file descriptor if *p_signal was set and notify the
+ * consumer thread if *p_count was set.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param p_data            the element
+ * @param p_signal          set if the event file descriptor should be signaled
+ * @param p_count           set to the occupancy if a consumer thread is attached
+ *
+ * @return 1 on success, 0 on error
+ */
+int circular_buffer_push_unlocked ( circular_buffer *const p_circular_buffer, void *p_data, bool *p_signal, size_t *p_count );
+
+/** !
+ * Push an element of a known size. Like circular_buffer_push_unlocked, but
+ * the size is charged to the byte budget instead of asking the size
+ * callback.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param p_data            the element
+ * @param size              the size of the element in bytes
+ * @param p_signal          set if the event file descriptor should be signaled
+ * @param p_count           set to the occupancy if a consumer thread is attached
+ *
+ * @return 1 on success, 0 on error
+ */
+int circular_buffer_push_sized_unlocked ( circular_buffer *const p_circular_buffer, void *p_data, size_t size, bool *p_signal, size_t *p_count );
+
+/** !
+ * Store an element in memory, bypassing the spill tier. Charges the byte
+ * budget and updates the event, consumer, watermark and probe state like
+ * any other push. The caller must hold the lock, and after releasing it
+ * must act on *p_signal and *p_count as for circular_buffer_push_unlocked.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param p_data            the element
+ * @param size              the size of the element in bytes
+ * @param p_signal          set if the event file descriptor should be signaled
+ * @param p_count           set to the occupancy if a consumer thread is attached
+ *
+ * @return 1 on success, 0 on error
+ */
+int circular_buffer_insert_unlocked ( circular_buffer *const p_circular_buffer, void *p_data, size_t size, bool *p_signal, size_t *p_count );
+
+/** !
+ * Push through the flat combiner
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param p_data            the element
+ *
+ * @return 1 on success, 0 on error
+ */
+int circular_buffer_combining_push ( circular_buffer *const p_circular_buffer, void *p_data );
+
+/** !
+ * Free the flat combiner
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return void
+ */
+void circular_buffer_combining_destroy ( circular_buffer *const p_circular_buffer );
+
+/** !
+ * Remove the key of the element at an index from the coalescing index
+ * before the element leaves the circular buffer. The caller must hold the
+ * lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param index             the index of the element being removed
+ *
+ * @return void
+ */
+void circular_buffer_coalesce_forget ( circular_buffer *const p_circular_buffer, size_t index );
+
+/** !
+ * Free the coalescing index
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return void
+ */
+void circular_buffer_coalesce_destroy ( circular_buffer *const p_circular_buffer );
+
+/** !
+ * Evict the oldest elements until an element of a size fits under the
+ * byte budget and in a free entry, then charge the size to the entry at the
+ * write index. The caller must hold the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param size              the size of the element in bytes
+ *
+ * @return 1 on success, 0 if the element is larger than the budget
+ */
+int circular_buffer_budget_admit ( circular_buffer *const p_circular_buffer, size_t size );
+
+/** !
+ * Free the byte budget
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return void
+ */
+void circular_buffer_budget_destroy ( circular_buffer *const p_circular_buffer );
+
+/** !
+ * Free the spare block of double buffered drains
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return void
+ */
+void circular_buffer_drain_destroy ( circular_buffer *const p_circular_buffer );
+
+/** !
+ * Find a pointer with the widest kernel the processor supports
+ *
+ * @param pp_data the elements
+ * @param size    the quantity of elements
+ * @param p_value the pointer
+ *
+ * @return the position of the first match, or size if there is none
+ */
+size_t circular_buffer_search_find ( void *const *pp_data, size_t size, const void *p_value );
+
+/** !
+ * Count a pointer with the widest kernel the processor supports
+ *
+ * @param pp_data the elements
+ * @param size    the quantity of elements
+ * @param p_value the pointer
+ *
+ * @return the quantity of matches
+ */
+size_t circular_buffer_search_count ( void *const *pp_data, size_t size, const void *p_value );
+
+/** !
+ * Count a byte with the widest kernel the processor supports
+ *
+ * @param p_data the bytes
+ * @param size   the quantity of bytes
+ * @param value  the byte
+ *
+ * @return the quantity of matches
+ */
+size_t circular_buffer_search_count_bytes ( const unsigned char *p_data, size_t size, unsigned char value );
+
+/** !
+ * Free the latency histogram
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return void
+ */
+void circular_buffer_latency_destroy ( circular_buffer *const p_circular_buffer );
+
+// Function definitions
+/** !
+ * Get the quantity of elements in a circular buffer. The caller must hold the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return the quantity of elements
+ */
+static inline size_t circular_buffer_count_unlocked ( const circular_buffer *const p_circular_buffer )
+{
+
+	// Full
+	if ( p_circular_buffer->full ) return p_circular_buffer->length;
+
+	// Success
+	return ( p_circular_buffer->write + p_circular_buffer->length - p_circular_buffer->read ) % p_circular_buffer->length;
+}
+
+/** !
+ * Store an element, overwriting the oldest element if the circular buffer
+ * is full. The caller must hold the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param p_data            the element
+ *
+ * @return true if the oldest element was overwritten, else false
+ */
+static inline bool circular_buffer_store_unlocked ( circular_buffer *const p_circular_buffer, void *p_data )
+{
+
+	// Trace the overwrite
+	if ( p_circular_buffer->full ) CIRCULAR_BUFFER_PROBE3(overflow, p_circular_buffer, p_circular_buffer->_p_data[p_circular_buffer->write], p_circular_buffer->length);
+
+	// The oldest element is about to be overwritten
+	if ( p_circular_buffer->_p_coalesce && p_circular_buffer->full ) circular_buffer_coalesce_forget(p_circular_buffer, p_circular_buffer->write);
+
+	// Store the element
+	p_circular_buffer->_p_data[p_circular_buffer->write] = p_data;
+
+	// Record the time of the push
+	if ( p_circular_buffer->_p_timestamps ) p_circular_buffer->_p_timestamps[p_circular_buffer->write] = timer_high_precision();
+
+	// Stamp sampled elements for the latency histogram
+	#ifdef CIRCULAR_BUFFER_LATENCY
+		if ( p_circular_buffer->_p_latency )
+		{
+
+			// Initialized data
+			struct circular_buffer_latency_s *p_latency = p_circular_buffer->_p_latency;
+
+			// Zero marks an element that was not sampled
+			p_latency->_p_stamps[p_circular_buffer->write] = ( p_latency->sequence++ & p_latency->mask ) ? 0 : timer_high_precision();
+		}
+	#endif
+
+	// Update the write index
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->write, ( p_circular_buffer->write + 1 ) % p_circular_buffer->length);
+
+	// Handle overflows
+	if ( p_circular_buffer->full )
+	{
+
+		// Update the read index
+		CIRCULAR_BUFFER_STORE(p_circular_buffer->read, p_circular_buffer->write);
+
+		// Overflow
+		return true;
+	}
+
+	// Update the full flag
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->full, p_circular_buffer->read == p_circular_buffer->write);
+
+	// Done
+	return false;
+}
+
+/** !
+ * Return the size of the element at an index to the byte budget before the
+ * element leaves the circular buffer. The caller must hold the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param index             the index of the element being removed
+ *
+ * @return void
+ */
+static inline void circular_buffer_budget_release ( circular_buffer *const p_circular_buffer, size_t index )
+{
+
+	// Initialized data
+	struct circular_buffer_budget_s *p_budget = p_circular_buffer->_p_budget;
+
+	// Update the running total
+	CIRCULAR_BUFFER_STORE(p_budget->bytes, p_budget->bytes - p_budget->_p_sizes[index]);
+
+	// Done
+	return;
+}
+
+/** !
+ * Check if a store crossed a transition the event file descriptor reports.
+ * The caller must hold the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param overflow          the return value of circular_buffer_store_unlocked
+ *
+ * @return true if the event file descriptor should be signaled, else false
+ */
+static inline bool circular_buffer_event_crossed ( const circular_buffer *const p_circular_buffer, bool overflow )
+{
+
+	// Initialized data
+	size_t count = circular_buffer_count_unlocked(p_circular_buffer);
+
+	// Overwriting an element never changes the count
+	if ( overflow ) return false;
+
+	// Success
+	return ( count == 1 || count == p_circular_buffer->_event_watermark );
+}
+
+/** !
+ * Consume the signal on the event file descriptor if the circular buffer
+ * has drained, including its spill log. The caller must hold the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return void
+ */
+static inline void circular_buffer_event_drained ( circular_buffer *const p_circular_buffer )
+{
+
+	// Not drained
+	if ( ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_EVENT ) == 0 ) return;
+	if ( circular_buffer_count_unlocked(p_circular_buffer) ) return;
+
+	// Spilled elements are still waiting, so stay readable
+	if ( p_circular_buffer->_p_spill && p_circular_buffer->_p_spill->count ) return;
+
+	// Clear the event file descriptor
+	circular_buffer_event_clear(p_circular_buffer);
+
+	// Done
+	return;
+}
+
+/** !
+ * Report a crossing of the high or low watermark. Under pressure only the
+ * low watermark is compared, otherwise only the high watermark, so each
+ * update costs one comparison and crossings fire once. The caller must
+ * hold the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return void
+ */
+static inline void circular_buffer_watermark_check ( circular_buffer *const p_circular_buffer )
+{
+
+	// Initialized data
+	size_t count = 0;
+
+	// No watermarks
+	if ( ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_WATERMARK ) == 0 ) return;
+
+	// Compare against the threshold for the current state
+	count = circular_buffer_count_unlocked(p_circular_buffer);
+	if ( p_circular_buffer->_pressure ? count > p_circular_buffer->_low_watermark : count < p_circular_buffer->_high_watermark ) return;
+
+	// Flip the state
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->_pressure, !p_circular_buffer->_pressure);
+
+	// Report the crossing
+	if ( p_circular_buffer->_pfn_watermark ) p_circular_buffer->_pfn_watermark(p_circular_buffer, p_circular_buffer->_pressure, p_circular_buffer->_p_watermark_context);
+
+	// Done
+	return;
+}
+
+#ifdef CIRCULAR_BUFFER_LATENCY
+
+/** !
+ * Map a residence time to a histogram bucket. Values below
+ * 2^CIRCULAR_BUFFER_LATENCY_SUB_BITS get their own bucket; above that, each
+ * power of two is split into 2^(CIRCULAR_BUFFER_LATENCY_SUB_BITS - 1)
+ * linear buckets.
+ *
+ * @param value the residence time
+ *
+ * @return the bucket index
+ */
+static inline size_t circular_buffer_latency_bucket ( unsigned long long value )
+{
+
+	// Initialized data
+	size_t half = (size_t) 1 << ( CIRCULAR_BUFFER_LATENCY_SUB_BITS - 1 ),
+	       msb  = 0,
+	       shift;
+
+	// Small values are exact
+	if ( value < ( 1ULL << CIRCULAR_BUFFER_LATENCY_SUB_BITS ) ) return (size_t) value;
+
+	// Find the most significant bit
+	#if defined(__GNUC__) || defined(__clang__)
+		msb = 63 - (size_t) __builtin_clzll(value);
+	#else
+		for (unsigned long long v = value; v >>= 1; msb++);
+	#endif
+
+	// Keep the top bits
+	shift = msb - ( CIRCULAR_BUFFER_LATENCY_SUB_BITS - 1 );
+
+	// Success
+	return shift * half + (size_t) ( value >> shift );
+}
+
+/** !
+ * Record the residence time of the element at an index if it was sampled.
+ * The caller must hold the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param index             the index of the element being removed
+ * @param now               the current time
+ *
+ * @return void
+ */
+static inline void circular_buffer_latency_record ( circular_buffer *const p_circular_buffer, size_t index, timestamp now )
+{
+
+	// Initialized data
+	struct circular_buffer_latency_s *p_latency = p_circular_buffer->_p_latency;
+	timestamp                         stamp     = p_latency->_p_stamps[index],
+	                                  elapsed   = now - stamp;
+
+	// Not sampled
+	if ( stamp == 0 ) return;
+
+	// Guard against clock adjustments
+	if ( elapsed < 0 ) elapsed = 0;
+
+	// Count the sample
+	p_latency->_buckets[circular_buffer_latency_bucket((unsigned long long) elapsed)]++;
+	p_latency->count++;
+	if ( elapsed > p_latency->max ) p_latency->max = elapsed;
+
+	// Done
+	return;
+}
+
+#endif
@@ -0,0 +1,423 @@
+/** !
+ * Circular buffer latency histogram implementation
+ *
+ * @file circular_buffer_latency.c
+ *
+ * @author Jacob Smith
+ */
+
+// Header
+#include <circular_buffer/latency.h>
+
+// Internal
+#include "circular_buffer_internal.h"
+
+// Function declarations
+#ifdef CIRCULAR_BUFFER_LATENCY
+/** !
+ * Get the largest value that maps to a histogram bucket
+ *
+ * @param index the bucket index
+ *
+ * @return the largest value in the bucket
+ */
+static timestamp circular_buffer_latency_bucket_max ( size_t index );
+#endif
+
+// Function definitions
+int circular_buffer_latency_enable ( circular_buffer *const p_circular_buffer, unsigned sample_shift )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( sample_shift      >= 32         ) goto sample_shift_too_large;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+
+	#ifdef CIRCULAR_BUFFER_LATENCY
+	{
+
+		// Initialized data
+		struct circular_buffer_latency_s *p_latency = (void *) 0;
+
+		// State check
+		if ( p_circular_buffer->_p_latency ) goto already_enabled;
+
+		// Allocate memory for the histogram and a stamp per slot
+		p_latency = CIRCULAR_BUFFER_REALLOC(0, sizeof(struct circular_buffer_latency_s) + p_circular_buffer->length * sizeof(timestamp));
+
+		// Error check
+		if ( p_latency == (void *) 0 ) goto no_mem;
+
+		// Zero set
+		memset(p_latency, 0, sizeof(struct circular_buffer_latency_s) + p_circular_buffer->length * sizeof(timestamp));
+
+		// Store the sampling interval
+		p_latency->mask = ( (size_t) 1 << sample_shift ) - 1;
+
+		// Lock
+		circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+		// Attach the histogram. Elements already in the circular buffer carry no stamp.
+		p_circular_buffer->_p_latency  = p_latency;
+		p_circular_buffer->features   |= CIRCULAR_BUFFER_FEATURE_LATENCY;
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Success
+		return 1;
+
+		// Error handling
+		{
+
+			// Circular buffer errors
+			{
+				already_enabled:
+					#ifndef NDEBUG
+						log_error("[circular buffer] Latency recording is already enabled in call to function \"%s\"\n", __FUNCTION__);
+					#endif
+
+					// Error
+					return 0;
+			}
+
+			// Standard library errors
+			{
+				no_mem:
+					#ifndef NDEBUG
+						log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+					#endif
+
+					// Error
+					return 0;
+			}
+		}
+	}
+	#else
+
+		// Error
+		goto not_compiled;
+	#endif
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			sample_shift_too_large:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"sample_shift\" must be less than 32 in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			#ifndef CIRCULAR_BUFFER_LATENCY
+				not_compiled:
+					#ifndef NDEBUG
+						log_error("[circular buffer] Latency recording was not compiled in. Define CIRCULAR_BUFFER_LATENCY in call to function \"%s\"\n", __FUNCTION__);
+					#endif
+
+					// Error
+					return 0;
+			#endif
+		}
+	}
+}
+
+int circular_buffer_latency_reset ( circular_buffer *const p_circular_buffer )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+
+	#ifdef CIRCULAR_BUFFER_LATENCY
+	{
+
+		// State check
+		if ( p_circular_buffer->_p_latency == (void *) 0 ) goto not_enabled;
+
+		// Initialized data
+		struct circular_buffer_latency_s *p_latency = p_circular_buffer->_p_latency;
+
+		// Lock
+		circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+		// Clear the histogram. Stamps are kept, so elements in flight are still recorded.
+		memset(p_latency->_buckets, 0, sizeof(p_latency->_buckets));
+		p_latency->count = 0;
+		p_latency->max   = 0;
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Success
+		return 1;
+	}
+	#else
+
+		// Error
+		goto not_enabled;
+	#endif
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_enabled:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Latency recording is not enabled in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_latency_count ( circular_buffer *const p_circular_buffer, size_t *p_count )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_count           == (void *) 0 ) goto no_count;
+
+	#ifdef CIRCULAR_BUFFER_LATENCY
+	{
+
+		// State check
+		if ( p_circular_buffer->_p_latency == (void *) 0 ) goto not_enabled;
+
+		// Lock
+		circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+		// Return the quantity of samples to the caller
+		*p_count = p_circular_buffer->_p_latency->count;
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Success
+		return 1;
+	}
+	#else
+
+		// Error
+		goto not_enabled;
+	#endif
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_count:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_count\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_enabled:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Latency recording is not enabled in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_latency_percentile ( circular_buffer *const p_circular_buffer, double percentile, timestamp *p_result )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_result          == (void *) 0 ) goto no_result;
+	if ( percentile < 0.0 || percentile > 100.0 ) goto percentile_out_of_range;
+
+	#ifdef CIRCULAR_BUFFER_LATENCY
+	{
+
+		// State check
+		if ( p_circular_buffer->_p_latency == (void *) 0 ) goto not_enabled;
+
+		// Initialized data
+		struct circular_buffer_latency_s *p_latency = p_circular_buffer->_p_latency;
+		size_t                            rank      = 0,
+		                                  seen      = 0,
+		                                  i         = 0;
+		timestamp                         result    = 0;
+
+		// Lock
+		circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+		// Nothing recorded
+		if ( p_latency->count == 0 ) goto no_samples;
+
+		// The rank of the sample at the percentile
+		rank = (size_t) ( percentile / 100.0 * (double) p_latency->count + 0.999999 );
+		if ( rank == 0 ) rank = 1;
+
+		// Walk the buckets until the rank is reached
+		for (i = 0; i < CIRCULAR_BUFFER_LATENCY_BUCKETS - 1; i++)
+		{
+			seen += p_latency->_buckets[i];
+			if ( seen >= rank ) break;
+		}
+
+		// Report the upper bound of the bucket, but never more than was seen
+		result = circular_buffer_latency_bucket_max(i);
+		if ( result > p_latency->max ) result = p_latency->max;
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Return the percentile to the caller
+		*p_result = result;
+
+		// Success
+		return 1;
+
+		// Error handling
+		{
+
+			// Circular buffer errors
+			{
+				no_samples:
+
+					// Unlock
+					circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+					// Error
+					return 0;
+			}
+		}
+	}
+	#else
+
+		// Error
+		goto not_enabled;
+	#endif
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_result:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_result\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			percentile_out_of_range:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"percentile\" must be between 0 and 100 in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			not_enabled:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Latency recording is not enabled in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+void circular_buffer_latency_destroy ( circular_buffer *const p_circular_buffer )
+{
+
+	// Free the histogram
+	p_circular_buffer->_p_latency  = CIRCULAR_BUFFER_REALLOC(p_circular_buffer->_p_latency, 0);
+	p_circular_buffer->features   &= ~CIRCULAR_BUFFER_FEATURE_LATENCY;
+
+	// Done
+	return;
+}
+
+#ifdef CIRCULAR_BUFFER_LATENCY
+static timestamp circular_buffer_latency_bucket_max ( size_t index )
+{
+
+	// Initialized data
+	size_t half = (size_t) 1 << ( CIRCULAR_BUFFER_LATENCY_SUB_BITS - 1 ),
+	       shift,
+	       top;
+
+	// Small values are exact
+	if ( index < ( half << 1 ) ) return (timestamp) index;
+
+	// Recover the shift and the top bits
+	shift = index / half - 1;
+	top   = index - shift * half;
+
+	// The largest value with the same top bits
+	if ( shift >= 62 - CIRCULAR_BUFFER_LATENCY_SUB_BITS ) return (timestamp) ( ~0ULL >> 1 );
+
+	// Success
+	return (timestamp) ( ( ( (unsigned long long) top + 1 ) << shift ) - 1 );
+}
+#endif
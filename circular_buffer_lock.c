@@ -0,0 +1,116 @@
+/** !
+ * Circular buffer lock implementation
+ *
+ * @file circular_buffer_lock.c
+ *
+ * @author Jacob Smith
+ */
+
+// Feature test macros
+#define _GNU_SOURCE
+
+// Header
+#include <circular_buffer/lock.h>
+
+// Static tracepoints
+#include <circular_buffer/probes.h>
+
+// Platform dependent includes
+#ifdef __linux__
+	#include <unistd.h>
+	#include <sys/syscall.h>
+	#include <linux/futex.h>
+#elif defined(_WIN64)
+	#include <windows.h>
+#else
+	#include <sched.h>
+#endif
+
+// Function declarations
+/** !
+ * Sleep while a lock is in the parked state
+ *
+ * @param p_lock the lock
+ *
+ * @return void
+ */
+static void circular_buffer_lock_park ( circular_buffer_lock *const p_lock );
+
+// Function definitions
+void circular_buffer_lock_wait ( circular_buffer_lock *const p_lock )
+{
+
+	// Initialized data
+	unsigned spin = CIRCULAR_BUFFER_LOAD(p_lock->spin);
+
+	// Trace the contention
+	CIRCULAR_BUFFER_PROBE2(lock_contended, p_lock, spin);
+
+	// Spin while the holder is likely to finish soon
+	for (unsigned i = 0; i < spin; i++)
+	{
+
+		// Only attempt the exchange when the lock looks free
+		if ( CIRCULAR_BUFFER_LOAD(p_lock->state) == 0 )
+		{
+
+			// Try to take the lock
+			if ( circular_buffer_atomic_compare_exchange_acquire(&p_lock->state, 0, 1) ) return;
+		}
+
+		// Back off
+		CIRCULAR_BUFFER_PAUSE();
+	}
+
+	// Trace the park
+	CIRCULAR_BUFFER_PROBE1(lock_park, p_lock);
+
+	// Mark the lock as having parked waiters, and park until it is released.
+	// A thread that takes the lock this way leaves it in the parked state,
+	// so its release wakes the next waiter.
+	while ( circular_buffer_atomic_exchange_acquire(&p_lock->state, 2) != 0 )
+		circular_buffer_lock_park(p_lock);
+
+	// Done
+	return;
+}
+
+void circular_buffer_lock_wake ( circular_buffer_lock *const p_lock )
+{
+
+	#ifdef __linux__
+
+		// Wake one waiter
+		syscall(SYS_futex, &p_lock->state, FUTEX_WAKE_PRIVATE, 1, (void *) 0, (void *) 0, 0);
+	#else
+
+		// Waiters poll the lock
+		(void) p_lock;
+	#endif
+
+	// Done
+	return;
+}
+
+static void circular_buffer_lock_park ( circular_buffer_lock *const p_lock )
+{
+
+	#ifdef __linux__
+
+		// Sleep unless the lock changed since it was marked
+		syscall(SYS_futex, &p_lock->state, FUTEX_WAIT_PRIVATE, 2, (void *) 0, (void *) 0, 0);
+	#elif defined(_WIN64)
+
+		// Give up the rest of the time slice
+		(void) p_lock;
+		SwitchToThread();
+	#else
+
+		// Give up the rest of the time slice
+		(void) p_lock;
+		sched_yield();
+	#endif
+
+	// Done
+	return;
+}
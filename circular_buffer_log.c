@@ -0,0 +1,791 @@
+/** !
+ * Asynchronous log implementation
+ *
+ * @file circular_buffer_log.c
+ *
+ * @author Jacob Smith
+ */
+
+// Feature test macros
+#define _POSIX_C_SOURCE 200809L
+
+// Header
+#include <circular_buffer/log.h>
+
+// circular buffer
+#include <circular_buffer/bytes.h>
+
+#ifndef _WIN64
+
+// Standard library
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// Platform dependent includes
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+// Preprocessor definitions
+#define CIRCULAR_BUFFER_LOG_BATCH       65536
+#define CIRCULAR_BUFFER_LOG_INTERVAL_NS 10000000
+
+// Structure definitions
+struct circular_buffer_log_ring_s
+{
+	circular_buffer                   *p_circular_buffer;
+	struct circular_buffer_log_ring_s *p_next;
+	bool                               retired;
+};
+
+struct circular_buffer_log_s
+{
+	struct circular_buffer_log_ring_s *p_rings;
+	pthread_key_t    key;
+	int              fd;
+	size_t           size;
+	pthread_t        thread;
+	pthread_mutex_t  lock;
+	pthread_cond_t   wake, flushed;
+	bool             stop, sleeping;
+	size_t           dropped, requested, completed;
+	size_t           history, history_next, history_count, history_fill;
+	char            *_p_history;
+	unsigned char    _batch[CIRCULAR_BUFFER_LOG_BATCH];
+};
+
+// Function declarations
+/** !
+ * Get the circular buffer of the calling thread, claiming one retired by
+ * an exited thread or constructing one on the first write
+ *
+ * @param p_log the asynchronous log
+ *
+ * @return the circular buffer of the calling thread, or null on error
+ */
+static circular_buffer *circular_buffer_log_ring ( circular_buffer_log *const p_log );
+
+/** !
+ * Retire the circular buffer of an exiting thread. The writer thread still
+ * drains it, and the next thread to log claims it.
+ *
+ * @param p_ring the circular buffer of the exiting thread
+ *
+ * @return void
+ */
+static void circular_buffer_log_retire ( void *p_ring );
+
+/** !
+ * Keep the lines in a batch in the history. Only the writer thread calls this.
+ *
+ * @param p_log  the asynchronous log
+ * @param p_data the batch
+ * @param size   the quantity of bytes in the batch
+ *
+ * @return void
+ */
+static void circular_buffer_log_remember ( circular_buffer_log *const p_log, const unsigned char *p_data, size_t size );
+
+/** !
+ * Write everything in the circular buffer of each thread to the file
+ * descriptor in batches
+ *
+ * @param p_log the asynchronous log
+ *
+ * @return void
+ */
+static void circular_buffer_log_drain ( circular_buffer_log *const p_log );
+
+/** !
+ * Drain the circular buffer every interval, when it is half full, on flush,
+ * and once more before exiting
+ *
+ * @param p_parameter the asynchronous log
+ *
+ * @return null
+ */
+static void *circular_buffer_log_thread ( void *p_parameter );
+
+// Function definitions
+int circular_buffer_log_open ( circular_buffer_log **const pp_log, int fd, size_t size, size_t history )
+{
+
+	// Argument check
+	if ( pp_log == (void *) 0 ) goto no_log;
+	if ( fd     <           0 ) goto no_fd;
+
+	// Initialized data
+	circular_buffer_log *p_log      = (void *) 0;
+	pthread_condattr_t   attributes;
+
+	// Default
+	if ( size == 0 ) size = CIRCULAR_BUFFER_LOG_DEFAULT_SIZE;
+
+	// Allocate memory for the log
+	p_log = CIRCULAR_BUFFER_REALLOC(0, sizeof(circular_buffer_log));
+
+	// Error check
+	if ( p_log == (void *) 0 ) goto no_mem;
+
+	// Zero set
+	memset(p_log, 0, sizeof(circular_buffer_log));
+
+	// Store the file descriptor
+	p_log->fd      = fd;
+	p_log->size    = size;
+	p_log->history = history;
+
+	// Allocate the history. The extra slot is the line being written, which a dump skips.
+	if ( history )
+	{
+
+		// Allocate memory for the history
+		p_log->_p_history = CIRCULAR_BUFFER_REALLOC(0, ( history + 1 ) * CIRCULAR_BUFFER_LOG_LINE_MAX);
+
+		// Error check
+		if ( p_log->_p_history == (void *) 0 ) goto no_mem;
+	}
+
+	// Each thread constructs its circular buffer on its first write
+	if ( pthread_key_create(&p_log->key, circular_buffer_log_retire) ) goto failed_to_create_key;
+
+	// Interval deadlines are measured on the monotonic clock
+	pthread_condattr_init(&attributes);
+	pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+
+	// Create the lock and the condition variables
+	pthread_mutex_init(&p_log->lock, (void *) 0);
+	pthread_cond_init(&p_log->wake, &attributes);
+	pthread_cond_init(&p_log->flushed, (void *) 0);
+	pthread_condattr_destroy(&attributes);
+
+	// Start the writer thread
+	if ( pthread_create(&p_log->thread, (void *) 0, circular_buffer_log_thread, p_log) ) goto failed_to_create_thread;
+
+	// Return a pointer to the caller
+	*pp_log = p_log;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_log:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_log\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_fd:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"fd\" must be a valid file descriptor in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free the log
+				if ( p_log ) p_log = CIRCULAR_BUFFER_REALLOC(p_log, 0);
+
+				// Error
+				return 0;
+
+			failed_to_create_key:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to create thread specific key in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free the log
+				p_log->_p_history = CIRCULAR_BUFFER_REALLOC(p_log->_p_history, 0);
+				p_log             = CIRCULAR_BUFFER_REALLOC(p_log, 0);
+
+				// Error
+				return 0;
+
+			failed_to_create_thread:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to create thread in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free the log
+				pthread_cond_destroy(&p_log->flushed);
+				pthread_cond_destroy(&p_log->wake);
+				pthread_mutex_destroy(&p_log->lock);
+				pthread_key_delete(p_log->key);
+				p_log->_p_history = CIRCULAR_BUFFER_REALLOC(p_log->_p_history, 0);
+				p_log             = CIRCULAR_BUFFER_REALLOC(p_log, 0);
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_log_printf ( circular_buffer_log *const p_log, const char *const format, ... )
+{
+
+	// Argument check
+	if ( p_log  == (void *) 0 ) goto no_log;
+	if ( format == (void *) 0 ) goto no_format;
+
+	// Initialized data
+	char    _line[CIRCULAR_BUFFER_LOG_LINE_MAX];
+	int     len = 0;
+	va_list list;
+
+	// Format the line
+	va_start(list, format);
+	len = vsnprintf(_line, sizeof(_line), format, list);
+	va_end(list);
+
+	// Error check
+	if ( len < 0 ) goto failed_to_format;
+
+	// Truncate, keeping the last byte for the newline the format ends with
+	if ( (size_t) len >= sizeof(_line) )
+	{
+
+		// Initialized data
+		size_t format_len = strlen(format);
+
+		// Keep the terminator
+		len = (int) sizeof(_line) - 1;
+
+		// Put the newline back
+		if ( format_len && format[format_len - 1] == '\n' ) _line[len - 1] = '\n';
+	}
+
+	// Copy the line into the log
+	return circular_buffer_log_write(p_log, _line, (size_t) len);
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_log:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_log\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_format:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"format\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			failed_to_format:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to format line in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_log_write ( circular_buffer_log *const p_log, const char *const p_line, size_t size )
+{
+
+	// Argument check
+	if ( p_log  == (void *) 0 ) goto no_log;
+	if ( p_line == (void *) 0 ) goto no_line;
+
+	// Nothing to write
+	if ( size == 0 ) return 1;
+
+	// Initialized data
+	circular_buffer *p_circular_buffer = circular_buffer_log_ring(p_log);
+
+	// Error check
+	if ( p_circular_buffer == (void *) 0 ) goto dropped;
+
+	// Copy the whole line, or drop it
+	if ( circular_buffer_write_all(p_circular_buffer, p_line, size) == 0 ) goto dropped;
+
+	// Wake a sleeping writer once the circular buffer is half full
+	if ( __atomic_load_n(&p_log->sleeping, __ATOMIC_RELAXED) && circular_buffer_size(p_circular_buffer) >= circular_buffer_capacity(p_circular_buffer) / 2 )
+	{
+
+		// Lock
+		pthread_mutex_lock(&p_log->lock);
+
+		// Wake the writer thread
+		pthread_cond_signal(&p_log->wake);
+
+		// Unlock
+		pthread_mutex_unlock(&p_log->lock);
+	}
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_log:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_log\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_line:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_line\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			dropped:
+
+				// Count the dropped line
+				__atomic_add_fetch(&p_log->dropped, 1, __ATOMIC_RELAXED);
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_log_flush ( circular_buffer_log *const p_log )
+{
+
+	// Argument check
+	if ( p_log == (void *) 0 ) goto no_log;
+
+	// Initialized data
+	size_t ticket = 0;
+
+	// Lock
+	pthread_mutex_lock(&p_log->lock);
+
+	// Ask the writer thread for a drain that starts after this point
+	ticket = ++p_log->requested;
+	pthread_cond_signal(&p_log->wake);
+
+	// Wait for the drain
+	while ( p_log->completed < ticket ) pthread_cond_wait(&p_log->flushed, &p_log->lock);
+
+	// Unlock
+	pthread_mutex_unlock(&p_log->lock);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_log:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_log\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_log_dropped ( circular_buffer_log *const p_log )
+{
+
+	// Argument check
+	if ( p_log == (void *) 0 ) goto no_log;
+
+	// Success
+	return __atomic_load_n(&p_log->dropped, __ATOMIC_RELAXED);
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_log:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_log\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_log_dump ( circular_buffer_log *const p_log, int fd )
+{
+
+	// Argument check
+	if ( p_log == (void *) 0 ) goto no_log;
+	if ( fd    <           0 ) goto no_fd;
+
+	// No history
+	if ( p_log->history == 0 ) return 0;
+
+	// Initialized data
+	size_t slots = p_log->history + 1,
+	       next  = __atomic_load_n(&p_log->history_next , __ATOMIC_ACQUIRE),
+	       count = __atomic_load_n(&p_log->history_count, __ATOMIC_ACQUIRE);
+
+	// Write each line, oldest first
+	for (size_t i = 0; i < count; i++)
+	{
+
+		// Initialized data
+		const char *p_line = p_log->_p_history + ( ( next + slots - count + i ) % slots ) * CIRCULAR_BUFFER_LOG_LINE_MAX;
+
+		// Write the line
+		if ( write(fd, p_line, strlen(p_line)) < 0 ) return i;
+	}
+
+	// Success
+	return count;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_log:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_log\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_fd:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"fd\" must be a valid file descriptor in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_log_close ( circular_buffer_log **const pp_log )
+{
+
+	// Argument check
+	if ( pp_log  == (void *) 0 ) goto no_log;
+	if ( *pp_log == (void *) 0 ) goto pointer_to_null_pointer;
+
+	// Initialized data
+	circular_buffer_log *p_log = *pp_log;
+
+	// No more log for end user
+	*pp_log = (void *) 0;
+
+	// Lock
+	pthread_mutex_lock(&p_log->lock);
+
+	// Ask the writer thread to drain and exit
+	p_log->stop = true;
+	pthread_cond_signal(&p_log->wake);
+
+	// Unlock
+	pthread_mutex_unlock(&p_log->lock);
+
+	// Wait for the writer thread
+	pthread_join(p_log->thread, (void *) 0);
+
+	// Stop retiring circular buffers on thread exit
+	pthread_key_delete(p_log->key);
+
+	// Free the circular buffer of each thread
+	for (struct circular_buffer_log_ring_s *p_ring = p_log->p_rings, *p_next = (void *) 0; p_ring; p_ring = p_next)
+	{
+		p_next = p_ring->p_next;
+		circular_buffer_destroy(&p_ring->p_circular_buffer);
+		p_ring = CIRCULAR_BUFFER_REALLOC(p_ring, 0);
+	}
+
+	// Release the log
+	pthread_cond_destroy(&p_log->flushed);
+	pthread_cond_destroy(&p_log->wake);
+	pthread_mutex_destroy(&p_log->lock);
+	p_log->_p_history = CIRCULAR_BUFFER_REALLOC(p_log->_p_history, 0);
+	p_log             = CIRCULAR_BUFFER_REALLOC(p_log, 0);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_log:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_log\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			pointer_to_null_pointer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"pp_log\" points to null pointer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+static circular_buffer *circular_buffer_log_ring ( circular_buffer_log *const p_log )
+{
+
+	// Initialized data
+	struct circular_buffer_log_ring_s *p_ring = pthread_getspecific(p_log->key);
+
+	// Fast path
+	if ( p_ring ) return p_ring->p_circular_buffer;
+
+	// Claim a circular buffer retired by an exited thread. Its remaining
+	// lines are still drained in order, ahead of the new ones.
+	for (p_ring = __atomic_load_n(&p_log->p_rings, __ATOMIC_ACQUIRE); p_ring; p_ring = p_ring->p_next)
+	{
+
+		// Initialized data
+		bool retired = true;
+
+		// Claim the circular buffer
+		if ( __atomic_compare_exchange_n(&p_ring->retired, &retired, false, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ) goto claimed;
+	}
+
+	// Allocate memory for a new circular buffer
+	p_ring = CIRCULAR_BUFFER_REALLOC(0, sizeof(struct circular_buffer_log_ring_s));
+
+	// Error check
+	if ( p_ring == (void *) 0 ) goto no_mem;
+
+	// Zero set
+	memset(p_ring, 0, sizeof(struct circular_buffer_log_ring_s));
+
+	// Construct the circular buffer
+	if ( circular_buffer_construct_bytes(&p_ring->p_circular_buffer, p_log->size) == 0 ) goto failed_to_construct_circular_buffer;
+
+	// Publish it to the writer thread. Circular buffers are never unlinked
+	// before the log closes, so only the head changes.
+	p_ring->p_next = __atomic_load_n(&p_log->p_rings, __ATOMIC_RELAXED);
+	while ( __atomic_compare_exchange_n(&p_log->p_rings, &p_ring->p_next, p_ring, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED) == false );
+
+	claimed:
+
+	// Remember the circular buffer for the next write
+	pthread_setspecific(p_log->key, p_ring);
+
+	// Success
+	return p_ring->p_circular_buffer;
+
+	// Error handling
+	{
+
+		// Circular buffer errors
+		{
+			failed_to_construct_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Failed to construct circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free the circular buffer
+				p_ring = CIRCULAR_BUFFER_REALLOC(p_ring, 0);
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+static void circular_buffer_log_retire ( void *p_ring )
+{
+
+	// Hand the circular buffer to the next thread
+	__atomic_store_n(&( (struct circular_buffer_log_ring_s *) p_ring )->retired, true, __ATOMIC_RELEASE);
+
+	// Done
+	return;
+}
+
+static void circular_buffer_log_remember ( circular_buffer_log *const p_log, const unsigned char *p_data, size_t size )
+{
+
+	// Initialized data
+	size_t slots = p_log->history + 1;
+
+	// Each line, or the start of one
+	while ( size )
+	{
+
+		// Initialized data
+		char                *p_slot    = p_log->_p_history + p_log->history_next * CIRCULAR_BUFFER_LOG_LINE_MAX;
+		const unsigned char *p_newline = memchr(p_data, '\n', size);
+		size_t               length    = ( p_newline ) ? (size_t) ( p_newline - p_data ) : size,
+		                     room      = CIRCULAR_BUFFER_LOG_LINE_MAX - 2 - p_log->history_fill;
+
+		// Copy as much of the line as fits, leaving room for the newline and the terminator
+		memcpy(p_slot + p_log->history_fill, p_data, ( length < room ) ? length : room);
+		p_log->history_fill += ( length < room ) ? length : room;
+
+		// The line continues in the next batch
+		if ( p_newline == (void *) 0 ) break;
+
+		// Finish the line
+		p_slot[p_log->history_fill++] = '\n';
+		p_slot[p_log->history_fill]   = '\0';
+		p_log->history_fill           = 0;
+
+		// Publish the line
+		__atomic_store_n(&p_log->history_next, ( p_log->history_next + 1 ) % slots, __ATOMIC_RELEASE);
+		if ( p_log->history_count < p_log->history ) __atomic_store_n(&p_log->history_count, p_log->history_count + 1, __ATOMIC_RELEASE);
+
+		// Next line
+		size   -= length + 1;
+		p_data += length + 1;
+	}
+
+	// Done
+	return;
+}
+
+static void circular_buffer_log_drain ( circular_buffer_log *const p_log )
+{
+
+	// Initialized data
+	size_t size = 0;
+
+	// Each thread, one circular buffer at a time. Lines are written whole,
+	// so emptying one circular buffer always ends on a line boundary.
+	for (struct circular_buffer_log_ring_s *p_ring = __atomic_load_n(&p_log->p_rings, __ATOMIC_ACQUIRE); p_ring; p_ring = p_ring->p_next)
+	{
+
+		// Until the circular buffer is empty
+		while ( ( size = circular_buffer_read(p_ring->p_circular_buffer, p_log->_batch, sizeof(p_log->_batch)) ) )
+		{
+
+			// Write the batch, resuming after short writes and interrupts
+			for (size_t written = 0; written < size; )
+			{
+
+				// Initialized data
+				ssize_t ret = write(p_log->fd, p_log->_batch + written, size - written);
+
+				// Give up on the batch if the file descriptor fails
+				if ( ret < 0 && errno != EINTR ) break;
+
+				// Advance
+				if ( ret > 0 ) written += (size_t) ret;
+			}
+
+			// Keep the most recent lines
+			if ( p_log->history ) circular_buffer_log_remember(p_log, p_log->_batch, size);
+		}
+	}
+
+	// Done
+	return;
+}
+
+static void *circular_buffer_log_thread ( void *p_parameter )
+{
+
+	// Initialized data
+	circular_buffer_log *p_log    = p_parameter;
+	struct timespec      deadline = { 0 };
+	size_t               target   = 0;
+	bool                 stop     = false;
+
+	// Lock
+	pthread_mutex_lock(&p_log->lock);
+
+	// Until asked to stop
+	while ( stop == false )
+	{
+
+		// Every flush requested so far is satisfied by the drain below
+		target = p_log->requested;
+		stop   = p_log->stop;
+
+		// Unlock
+		pthread_mutex_unlock(&p_log->lock);
+
+		// Write without holding any lock
+		circular_buffer_log_drain(p_log);
+
+		// Lock
+		pthread_mutex_lock(&p_log->lock);
+
+		// Release the flushing threads
+		p_log->completed = target;
+		pthread_cond_broadcast(&p_log->flushed);
+
+		// Sleep for an interval, unless there is more to do
+		if ( p_log->stop || p_log->requested != target ) continue;
+
+		// Compute the deadline
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		deadline.tv_nsec += CIRCULAR_BUFFER_LOG_INTERVAL_NS;
+		if ( deadline.tv_nsec >= 1000000000 ) deadline.tv_sec++, deadline.tv_nsec -= 1000000000;
+
+		// Sleep
+		__atomic_store_n(&p_log->sleeping, true, __ATOMIC_RELAXED);
+		pthread_cond_timedwait(&p_log->wake, &p_log->lock, &deadline);
+		__atomic_store_n(&p_log->sleeping, false, __ATOMIC_RELAXED);
+	}
+
+	// Unlock
+	pthread_mutex_unlock(&p_log->lock);
+
+	// Done
+	return (void *) 0;
+}
+
+#endif
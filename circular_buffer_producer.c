@@ -0,0 +1,231 @@
+/** !
+ * Circular buffer producer handle implementation
+ *
+ * @file circular_buffer_producer.c
+ *
+ * @author Jacob Smith
+ */
+
+// Header
+#include <circular_buffer/producer.h>
+
+// Structure definitions
+struct circular_buffer_producer_s
+{
+	circular_buffer *p_circular_buffer;
+	size_t           size, count;
+	timestamp        max_delay, oldest;
+	void            *_p_stage[];
+};
+
+// Function definitions
+int circular_buffer_producer_open ( circular_buffer_producer **const pp_producer, circular_buffer *const p_circular_buffer, size_t size, timestamp max_delay )
+{
+
+	// Argument check
+	if ( pp_producer       == (void *) 0 ) goto no_producer;
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+
+	// Default
+	if ( size == 0 ) size = CIRCULAR_BUFFER_PRODUCER_DEFAULT_SIZE;
+
+	// Initialized data
+	circular_buffer_producer *p_producer = CIRCULAR_BUFFER_REALLOC(0, sizeof(circular_buffer_producer) + size * sizeof(void *));
+
+	// Error check
+	if ( p_producer == (void *) 0 ) goto no_mem;
+
+	// Populate the struct
+	*p_producer = (circular_buffer_producer)
+	{
+		.p_circular_buffer = p_circular_buffer,
+		.size              = size,
+		.count             = 0,
+		.max_delay         = max_delay,
+		.oldest            = 0
+	};
+
+	// Return a pointer to the caller
+	*pp_producer = p_producer;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_producer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_producer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_producer_push ( circular_buffer_producer *const p_producer, void *p_data )
+{
+
+	// Argument check
+	if ( p_producer == (void *) 0 ) goto no_producer;
+	if ( p_data     == (void *) 0 ) goto no_data;
+
+	// Start the clock on the first staged value
+	if ( p_producer->count == 0 && p_producer->max_delay ) p_producer->oldest = timer_high_precision();
+
+	// Stage the value
+	p_producer->_p_stage[p_producer->count++] = p_data;
+
+	// Flush a full stage
+	if ( p_producer->count == p_producer->size ) return circular_buffer_producer_flush(p_producer);
+
+	// Flush a stage whose oldest value is due
+	if ( p_producer->max_delay && timer_high_precision() - p_producer->oldest >= p_producer->max_delay ) return circular_buffer_producer_flush(p_producer);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_producer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_producer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_producer_flush ( circular_buffer_producer *const p_producer )
+{
+
+	// Argument check
+	if ( p_producer == (void *) 0 ) goto no_producer;
+
+	// Initialized data
+	size_t count = p_producer->count;
+
+	// Nothing staged
+	if ( count == 0 ) return 1;
+
+	// Empty the stage
+	p_producer->count = 0;
+
+	// Move the stage into the circular buffer
+	if ( circular_buffer_push_batch(p_producer->p_circular_buffer, p_producer->_p_stage, count) != count ) goto failed_to_push;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_producer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_producer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			failed_to_push:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Failed to push staged values in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_producer_close ( circular_buffer_producer **const pp_producer )
+{
+
+	// Argument check
+	if ( pp_producer == (void *) 0 ) goto no_producer;
+
+	// Initialized data
+	circular_buffer_producer *p_producer = *pp_producer;
+	int                       ret        = 0;
+
+	// No more producer for end user
+	*pp_producer = (void *) 0;
+
+	// Flush what is left
+	ret = circular_buffer_producer_flush(p_producer);
+
+	// Free the memory
+	p_producer = CIRCULAR_BUFFER_REALLOC(p_producer, 0);
+
+	// Done
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_producer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_producer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
@@ -0,0 +1,1005 @@
+/** !
+ * Sample circular buffer implementation
+ *
+ * @file circular_buffer_samples.c
+ *
+ * @author Jacob Smith
+ */
+
+// Header
+#include <circular_buffer/samples.h>
+
+// Standard library
+#include <math.h>
+
+// Vector kernels. SSE2 is part of x86-64, so no run time check is needed.
+#if defined(__SSE2__) || defined(_M_X64)
+	#define CIRCULAR_BUFFER_SAMPLES_SSE2
+	#include <emmintrin.h>
+#endif
+
+// Structure definitions
+struct circular_buffer_samples_s
+{
+	circular_buffer_sample_type  type;
+	size_t                       size, width, write, count;
+	circular_buffer_lock         _lock;
+	unsigned char                _p_data[];
+};
+
+// Function declarations
+/** !
+ * Find the most recent samples. The caller must hold the lock.
+ *
+ * @param p_samples the sample circular buffer
+ * @param p_width   the quantity of most recent samples, or 0 for every sample. Set to the quantity found.
+ *
+ * @return the first of the samples, or null if the window holds fewer than the width or is empty
+ */
+static const void *circular_buffer_samples_span ( const circular_buffer_samples *const p_samples, size_t *p_width );
+
+/** !
+ * Sum samples
+ *
+ * @param type      the sample type
+ * @param p_samples the samples
+ * @param size      the quantity of samples
+ *
+ * @return the sum
+ */
+static double circular_buffer_samples_sum_kernel ( circular_buffer_sample_type type, const void *p_samples, size_t size );
+
+/** !
+ * Sum the products of two arrays of samples
+ *
+ * @param type the sample type
+ * @param p_x  the first samples
+ * @param p_y  the second samples
+ * @param size the quantity of samples
+ *
+ * @return the sum of the products
+ */
+static double circular_buffer_samples_dot_kernel ( circular_buffer_sample_type type, const void *p_x, const void *p_y, size_t size );
+
+/** !
+ * Find the smallest and largest samples
+ *
+ * @param type      the sample type
+ * @param p_samples the samples
+ * @param size      the quantity of samples. Must not be 0.
+ * @param p_min     result
+ * @param p_max     result
+ *
+ * @return void
+ */
+static void circular_buffer_samples_min_max_kernel ( circular_buffer_sample_type type, const void *p_samples, size_t size, double *p_min, double *p_max );
+
+// Function definitions
+int circular_buffer_samples_construct ( circular_buffer_samples **const pp_samples, circular_buffer_sample_type type, size_t size )
+{
+
+	// Argument check
+	if ( pp_samples == (void *) 0 ) goto no_samples;
+	if ( size       ==          0 ) goto no_size;
+
+	// Initialized data
+	circular_buffer_samples *p_samples = (void *) 0;
+	size_t                   width     = 0;
+
+	// Width of a sample
+	switch ( type )
+	{
+		case CIRCULAR_BUFFER_SAMPLE_FLOAT:  width = sizeof(float);   break;
+		case CIRCULAR_BUFFER_SAMPLE_DOUBLE: width = sizeof(double);  break;
+		case CIRCULAR_BUFFER_SAMPLE_INT16:  width = sizeof(int16_t); break;
+		default: goto unknown_type;
+	}
+
+	// Allocate memory for both halves of the storage
+	p_samples = CIRCULAR_BUFFER_REALLOC(0, sizeof(circular_buffer_samples) + 2 * size * width);
+
+	// Error check
+	if ( p_samples == (void *) 0 ) goto no_mem;
+
+	// Zero set
+	memset(p_samples, 0, sizeof(circular_buffer_samples) + 2 * size * width);
+
+	// Populate the struct
+	p_samples->type  = type;
+	p_samples->size  = size;
+	p_samples->width = width;
+
+	// Create the lock
+	circular_buffer_lock_init(&p_samples->_lock, CIRCULAR_BUFFER_LOCK_DEFAULT_SPIN);
+
+	// Return a pointer to the caller
+	*pp_samples = p_samples;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_samples:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_samples\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_size:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"size\" must be greater than zero in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			unknown_type:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Unknown sample type %d in call to function \"%s\"\n", (int) type, __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_samples_count ( circular_buffer_samples *const p_samples )
+{
+
+	// Argument check
+	if ( p_samples == (void *) 0 ) goto no_samples;
+
+	// Success
+	return __atomic_load_n(&p_samples->count, __ATOMIC_RELAXED);
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_samples:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_samples\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_samples_window ( circular_buffer_samples *const p_samples, size_t width, const void **pp_samples )
+{
+
+	// Argument check
+	if ( p_samples  == (void *) 0 ) goto no_samples;
+	if ( pp_samples == (void *) 0 ) goto no_result;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_samples->_lock);
+
+	// Initialized data
+	const void *p_span = circular_buffer_samples_span(p_samples, &width);
+
+	// Unlock
+	circular_buffer_lock_release(&p_samples->_lock);
+
+	// Too few samples
+	if ( p_span == (void *) 0 ) return 0;
+
+	// Return a pointer to the caller
+	*pp_samples = p_span;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_samples:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_samples\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_result:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_samples\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_samples_dot ( circular_buffer_samples *const p_samples, const void *p_taps, size_t width, double *p_result )
+{
+
+	// Argument check
+	if ( p_samples == (void *) 0 ) goto no_samples;
+	if ( p_taps    == (void *) 0 ) goto no_taps;
+	if ( p_result  == (void *) 0 ) goto no_result;
+	if ( width     ==          0 ) goto no_width;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_samples->_lock);
+
+	// Initialized data
+	const void *p_span = circular_buffer_samples_span(p_samples, &width);
+
+	// Too few samples
+	if ( p_span == (void *) 0 ) goto too_few_samples;
+
+	// Apply the taps
+	*p_result = circular_buffer_samples_dot_kernel(p_samples->type, p_span, p_taps, width);
+
+	// Unlock
+	circular_buffer_lock_release(&p_samples->_lock);
+
+	// Success
+	return 1;
+
+	// Too few samples
+	too_few_samples:
+	{
+
+		// Unlock
+		circular_buffer_lock_release(&p_samples->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_samples:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_samples\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_taps:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_taps\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_result:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_result\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_width:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"width\" must be greater than zero in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_samples_mean ( circular_buffer_samples *const p_samples, size_t width, double *p_result )
+{
+
+	// Argument check
+	if ( p_samples == (void *) 0 ) goto no_samples;
+	if ( p_result  == (void *) 0 ) goto no_result;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_samples->_lock);
+
+	// Initialized data
+	const void *p_span = circular_buffer_samples_span(p_samples, &width);
+
+	// Too few samples
+	if ( p_span == (void *) 0 ) goto too_few_samples;
+
+	// Average
+	*p_result = circular_buffer_samples_sum_kernel(p_samples->type, p_span, width) / (double) width;
+
+	// Unlock
+	circular_buffer_lock_release(&p_samples->_lock);
+
+	// Success
+	return 1;
+
+	// Too few samples
+	too_few_samples:
+	{
+
+		// Unlock
+		circular_buffer_lock_release(&p_samples->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_samples:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_samples\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_result:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_result\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_samples_rms ( circular_buffer_samples *const p_samples, size_t width, double *p_result )
+{
+
+	// Argument check
+	if ( p_samples == (void *) 0 ) goto no_samples;
+	if ( p_result  == (void *) 0 ) goto no_result;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_samples->_lock);
+
+	// Initialized data
+	const void *p_span = circular_buffer_samples_span(p_samples, &width);
+
+	// Too few samples
+	if ( p_span == (void *) 0 ) goto too_few_samples;
+
+	// Root of the mean of the squares
+	*p_result = sqrt(circular_buffer_samples_dot_kernel(p_samples->type, p_span, p_span, width) / (double) width);
+
+	// Unlock
+	circular_buffer_lock_release(&p_samples->_lock);
+
+	// Success
+	return 1;
+
+	// Too few samples
+	too_few_samples:
+	{
+
+		// Unlock
+		circular_buffer_lock_release(&p_samples->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_samples:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_samples\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_result:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_result\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_samples_min_max ( circular_buffer_samples *const p_samples, size_t width, double *p_min, double *p_max )
+{
+
+	// Argument check
+	if ( p_samples == (void *) 0 ) goto no_samples;
+
+	// Initialized data
+	double min = 0,
+	       max = 0;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_samples->_lock);
+
+	// Initialized data
+	const void *p_span = circular_buffer_samples_span(p_samples, &width);
+
+	// Too few samples
+	if ( p_span == (void *) 0 ) goto too_few_samples;
+
+	// Find the extremes
+	circular_buffer_samples_min_max_kernel(p_samples->type, p_span, width, &min, &max);
+
+	// Unlock
+	circular_buffer_lock_release(&p_samples->_lock);
+
+	// Return the extremes to the caller
+	if ( p_min ) *p_min = min;
+	if ( p_max ) *p_max = max;
+
+	// Success
+	return 1;
+
+	// Too few samples
+	too_few_samples:
+	{
+
+		// Unlock
+		circular_buffer_lock_release(&p_samples->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_samples:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_samples\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_samples_push ( circular_buffer_samples *const p_samples, const void *p_data, size_t count )
+{
+
+	// Argument check
+	if ( p_samples == (void *) 0 ) goto no_samples;
+	if ( p_data    == (void *) 0 ) goto no_data;
+
+	// Initialized data
+	const unsigned char *p_bytes = p_data;
+	size_t               size    = p_samples->size,
+	                     width   = p_samples->width;
+
+	// Only the newest samples survive a push longer than the window
+	if ( count > size ) p_bytes += ( count - size ) * width, count = size;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_samples->_lock);
+
+	// Copy in runs that stop at the end of the first half
+	for (size_t done = 0; done < count; )
+	{
+
+		// Initialized data
+		size_t run = size - p_samples->write;
+
+		// Clamp
+		if ( run > count - done ) run = count - done;
+
+		// Write the run into both halves
+		memcpy(&p_samples->_p_data[p_samples->write * width         ], p_bytes + done * width, run * width);
+		memcpy(&p_samples->_p_data[( p_samples->write + size ) * width], p_bytes + done * width, run * width);
+
+		// Advance
+		p_samples->write  = ( p_samples->write + run ) % size;
+		done             += run;
+	}
+
+	// Update the count
+	__atomic_store_n(&p_samples->count, ( p_samples->count + count > size ) ? size : p_samples->count + count, __ATOMIC_RELAXED);
+
+	// Unlock
+	circular_buffer_lock_release(&p_samples->_lock);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_samples:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_samples\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_data:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_data\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_samples_destroy ( circular_buffer_samples **const pp_samples )
+{
+
+	// Argument check
+	if ( pp_samples == (void *) 0 ) goto no_samples;
+
+	// Initialized data
+	circular_buffer_samples *p_samples = *pp_samples;
+
+	// No more sample circular buffer for end user
+	*pp_samples = (void *) 0;
+
+	// Free the memory
+	p_samples = CIRCULAR_BUFFER_REALLOC(p_samples, 0);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_samples:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"pp_samples\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+static const void *circular_buffer_samples_span ( const circular_buffer_samples *const p_samples, size_t *p_width )
+{
+
+	// Every sample
+	if ( *p_width == 0 ) *p_width = p_samples->count;
+
+	// Too few samples
+	if ( *p_width == 0 || *p_width > p_samples->count ) return (void *) 0;
+
+	// The newest sample is just before the write index in the second half
+	return &p_samples->_p_data[( p_samples->write + p_samples->size - *p_width ) * p_samples->width];
+}
+
+static double circular_buffer_samples_sum_kernel ( circular_buffer_sample_type type, const void *p_samples, size_t size )
+{
+
+	// Initialized data
+	double ret = 0;
+	size_t i   = 0;
+
+	// float, accumulated in double
+	if ( type == CIRCULAR_BUFFER_SAMPLE_FLOAT )
+	{
+
+		// Initialized data
+		const float *p = p_samples;
+
+		#ifdef CIRCULAR_BUFFER_SAMPLES_SSE2
+		{
+
+			// Initialized data
+			__m128d lo = _mm_setzero_pd(),
+			        hi = _mm_setzero_pd();
+			double  _lanes[2];
+
+			// Four samples at a time
+			for (; i + 4 <= size; i += 4)
+			{
+				__m128 x = _mm_loadu_ps(&p[i]);
+				lo = _mm_add_pd(lo, _mm_cvtps_pd(x));
+				hi = _mm_add_pd(hi, _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+			}
+
+			// Reduce the lanes
+			_mm_storeu_pd(_lanes, _mm_add_pd(lo, hi));
+			ret = _lanes[0] + _lanes[1];
+		}
+		#endif
+
+		// The remainder
+		for (; i < size; i++) ret += p[i];
+	}
+
+	// double
+	else if ( type == CIRCULAR_BUFFER_SAMPLE_DOUBLE )
+	{
+
+		// Initialized data
+		const double *p = p_samples;
+
+		#ifdef CIRCULAR_BUFFER_SAMPLES_SSE2
+		{
+
+			// Initialized data
+			__m128d a = _mm_setzero_pd(),
+			        b = _mm_setzero_pd();
+			double  _lanes[2];
+
+			// Four samples at a time, in two independent sums
+			for (; i + 4 <= size; i += 4)
+			{
+				a = _mm_add_pd(a, _mm_loadu_pd(&p[i    ]));
+				b = _mm_add_pd(b, _mm_loadu_pd(&p[i + 2]));
+			}
+
+			// Reduce the lanes
+			_mm_storeu_pd(_lanes, _mm_add_pd(a, b));
+			ret = _lanes[0] + _lanes[1];
+		}
+		#endif
+
+		// The remainder
+		for (; i < size; i++) ret += p[i];
+	}
+
+	// int16_t, accumulated exactly
+	else
+	{
+
+		// Initialized data
+		const int16_t *p   = p_samples;
+		long long      sum = 0;
+
+		#ifdef CIRCULAR_BUFFER_SAMPLES_SSE2
+		{
+
+			// Initialized data
+			__m128i   acc  = _mm_setzero_si128(),
+			          ones = _mm_set1_epi16(1);
+			long long _lanes[2];
+
+			// Eight samples at a time. Adjacent pairs are summed into 32 bit lanes, then widened.
+			for (; i + 8 <= size; i += 8)
+			{
+				__m128i pairs = _mm_madd_epi16(_mm_loadu_si128((const __m128i *) &p[i]), ones),
+				        sign  = _mm_srai_epi32(pairs, 31);
+				acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(pairs, sign));
+				acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(pairs, sign));
+			}
+
+			// Reduce the lanes
+			_mm_storeu_si128((__m128i *) _lanes, acc);
+			sum = _lanes[0] + _lanes[1];
+		}
+		#endif
+
+		// The remainder
+		for (; i < size; i++) sum += p[i];
+
+		// Success
+		ret = (double) sum;
+	}
+
+	// Success
+	return ret;
+}
+
+static double circular_buffer_samples_dot_kernel ( circular_buffer_sample_type type, const void *p_x, const void *p_y, size_t size )
+{
+
+	// Initialized data
+	double ret = 0;
+	size_t i   = 0;
+
+	// float, multiplied and accumulated in double
+	if ( type == CIRCULAR_BUFFER_SAMPLE_FLOAT )
+	{
+
+		// Initialized data
+		const float *x = p_x,
+		            *y = p_y;
+
+		#ifdef CIRCULAR_BUFFER_SAMPLES_SSE2
+		{
+
+			// Initialized data
+			__m128d lo = _mm_setzero_pd(),
+			        hi = _mm_setzero_pd();
+			double  _lanes[2];
+
+			// Four samples at a time
+			for (; i + 4 <= size; i += 4)
+			{
+				__m128 a = _mm_loadu_ps(&x[i]),
+				       b = _mm_loadu_ps(&y[i]);
+				lo = _mm_add_pd(lo, _mm_mul_pd(_mm_cvtps_pd(a), _mm_cvtps_pd(b)));
+				hi = _mm_add_pd(hi, _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(a, a)), _mm_cvtps_pd(_mm_movehl_ps(b, b))));
+			}
+
+			// Reduce the lanes
+			_mm_storeu_pd(_lanes, _mm_add_pd(lo, hi));
+			ret = _lanes[0] + _lanes[1];
+		}
+		#endif
+
+		// The remainder
+		for (; i < size; i++) ret += (double) x[i] * (double) y[i];
+	}
+
+	// double
+	else if ( type == CIRCULAR_BUFFER_SAMPLE_DOUBLE )
+	{
+
+		// Initialized data
+		const double *x = p_x,
+		             *y = p_y;
+
+		#ifdef CIRCULAR_BUFFER_SAMPLES_SSE2
+		{
+
+			// Initialized data
+			__m128d a = _mm_setzero_pd(),
+			        b = _mm_setzero_pd();
+			double  _lanes[2];
+
+			// Four samples at a time, in two independent sums
+			for (; i + 4 <= size; i += 4)
+			{
+				a = _mm_add_pd(a, _mm_mul_pd(_mm_loadu_pd(&x[i    ]), _mm_loadu_pd(&y[i    ])));
+				b = _mm_add_pd(b, _mm_mul_pd(_mm_loadu_pd(&x[i + 2]), _mm_loadu_pd(&y[i + 2])));
+			}
+
+			// Reduce the lanes
+			_mm_storeu_pd(_lanes, _mm_add_pd(a, b));
+			ret = _lanes[0] + _lanes[1];
+		}
+		#endif
+
+		// The remainder
+		for (; i < size; i++) ret += x[i] * y[i];
+	}
+
+	// int16_t, accumulated exactly
+	else
+	{
+
+		// Initialized data
+		const int16_t *x   = p_x,
+		              *y   = p_y;
+		long long      sum = 0;
+
+		#ifdef CIRCULAR_BUFFER_SAMPLES_SSE2
+		{
+
+			// Initialized data
+			__m128i   acc = _mm_setzero_si128();
+			long long _lanes[2];
+
+			// Eight samples at a time. Each product is formed in a 32 bit lane
+			// from its low and high halves, then widened. Summing adjacent
+			// products in 32 bits, as pmaddwd does, overflows at -32768 * -32768.
+			for (; i + 8 <= size; i += 8)
+			{
+				__m128i a        = _mm_loadu_si128((const __m128i *) &x[i]),
+				        b        = _mm_loadu_si128((const __m128i *) &y[i]),
+				        low      = _mm_mullo_epi16(a, b),
+				        high     = _mm_mulhi_epi16(a, b),
+				        first    = _mm_unpacklo_epi16(low, high),
+				        second   = _mm_unpackhi_epi16(low, high),
+				        sign_1st = _mm_srai_epi32(first , 31),
+				        sign_2nd = _mm_srai_epi32(second, 31);
+				acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(first , sign_1st));
+				acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(first , sign_1st));
+				acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(second, sign_2nd));
+				acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(second, sign_2nd));
+			}
+
+			// Reduce the lanes
+			_mm_storeu_si128((__m128i *) _lanes, acc);
+			sum = _lanes[0] + _lanes[1];
+		}
+		#endif
+
+		// The remainder
+		for (; i < size; i++) sum += (long long) x[i] * y[i];
+
+		// Success
+		ret = (double) sum;
+	}
+
+	// Success
+	return ret;
+}
+
+static void circular_buffer_samples_min_max_kernel ( circular_buffer_sample_type type, const void *p_samples, size_t size, double *p_min, double *p_max )
+{
+
+	// Initialized data
+	size_t i = 0;
+
+	// float
+	if ( type == CIRCULAR_BUFFER_SAMPLE_FLOAT )
+	{
+
+		// Initialized data
+		const float *p   = p_samples;
+		float        min = p[0],
+		             max = p[0];
+
+		#ifdef CIRCULAR_BUFFER_SAMPLES_SSE2
+		if ( size >= 4 )
+		{
+
+			// Initialized data
+			__m128 lo = _mm_loadu_ps(p),
+			       hi = lo;
+			float  _lo[4], _hi[4];
+
+			// Four samples at a time
+			for (i = 4; i + 4 <= size; i += 4)
+			{
+				__m128 x = _mm_loadu_ps(&p[i]);
+				lo = _mm_min_ps(lo, x);
+				hi = _mm_max_ps(hi, x);
+			}
+
+			// Reduce the lanes
+			_mm_storeu_ps(_lo, lo);
+			_mm_storeu_ps(_hi, hi);
+			for (size_t j = 0; j < 4; j++)
+			{
+				if ( _lo[j] < min ) min = _lo[j];
+				if ( _hi[j] > max ) max = _hi[j];
+			}
+		}
+		#endif
+
+		// The remainder
+		for (; i < size; i++)
+		{
+			if ( p[i] < min ) min = p[i];
+			if ( p[i] > max ) max = p[i];
+		}
+
+		// Success
+		*p_min = min, *p_max = max;
+	}
+
+	// double
+	else if ( type == CIRCULAR_BUFFER_SAMPLE_DOUBLE )
+	{
+
+		// Initialized data
+		const double *p   = p_samples;
+		double        min = p[0],
+		              max = p[0];
+
+		#ifdef CIRCULAR_BUFFER_SAMPLES_SSE2
+		if ( size >= 2 )
+		{
+
+			// Initialized data
+			__m128d lo = _mm_loadu_pd(p),
+			        hi = lo;
+			double  _lo[2], _hi[2];
+
+			// Two samples at a time
+			for (i = 2; i + 2 <= size; i += 2)
+			{
+				__m128d x = _mm_loadu_pd(&p[i]);
+				lo = _mm_min_pd(lo, x);
+				hi = _mm_max_pd(hi, x);
+			}
+
+			// Reduce the lanes
+			_mm_storeu_pd(_lo, lo);
+			_mm_storeu_pd(_hi, hi);
+			for (size_t j = 0; j < 2; j++)
+			{
+				if ( _lo[j] < min ) min = _lo[j];
+				if ( _hi[j] > max ) max = _hi[j];
+			}
+		}
+		#endif
+
+		// The remainder
+		for (; i < size; i++)
+		{
+			if ( p[i] < min ) min = p[i];
+			if ( p[i] > max ) max = p[i];
+		}
+
+		// Success
+		*p_min = min, *p_max = max;
+	}
+
+	// int16_t
+	else
+	{
+
+		// Initialized data
+		const int16_t *p   = p_samples;
+		int16_t        min = p[0],
+		               max = p[0];
+
+		#ifdef CIRCULAR_BUFFER_SAMPLES_SSE2
+		if ( size >= 8 )
+		{
+
+			// Initialized data
+			__m128i lo = _mm_loadu_si128((const __m128i *) p),
+			        hi = lo;
+			int16_t _lo[8], _hi[8];
+
+			// Eight samples at a time
+			for (i = 8; i + 8 <= size; i += 8)
+			{
+				__m128i x = _mm_loadu_si128((const __m128i *) &p[i]);
+				lo = _mm_min_epi16(lo, x);
+				hi = _mm_max_epi16(hi, x);
+			}
+
+			// Reduce the lanes
+			_mm_storeu_si128((__m128i *) _lo, lo);
+			_mm_storeu_si128((__m128i *) _hi, hi);
+			for (size_t j = 0; j < 8; j++)
+			{
+				if ( _lo[j] < min ) min = _lo[j];
+				if ( _hi[j] > max ) max = _hi[j];
+			}
+		}
+		#endif
+
+		// The remainder
+		for (; i < size; i++)
+		{
+			if ( p[i] < min ) min = p[i];
+			if ( p[i] > max ) max = p[i];
+		}
+
+		// Success
+		*p_min = min, *p_max = max;
+	}
+
+	// Done
+	return;
+}
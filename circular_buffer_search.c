@@ -0,0 +1,325 @@
+/** !
+ * Circular buffer search kernels
+ *
+ * @file circular_buffer_search.c
+ *
+ * @author Jacob Smith
+ */
+
+// Internal
+#include "circular_buffer_internal.h"
+
+// Vector kernels on x86-64, chosen at run time
+#if defined(__x86_64__) && ( defined(__GNUC__) || defined(__clang__) )
+	#define CIRCULAR_BUFFER_SEARCH_X86
+	#include <immintrin.h>
+#endif
+
+// Type definitions
+typedef size_t (fn_circular_buffer_search_pointers)( void *const *pp_data, size_t size, const void *p_value, bool first );
+typedef size_t (fn_circular_buffer_search_bytes)( const unsigned char *p_data, size_t size, unsigned char value );
+
+// Function declarations
+/** !
+ * Find or count a pointer one element at a time
+ *
+ * @param pp_data the elements
+ * @param size    the quantity of elements
+ * @param p_value the pointer
+ * @param first   true to stop at the first match
+ *
+ * @return the position of the first match, or size if none, when first is true, else the quantity of matches
+ */
+static size_t circular_buffer_search_pointers_scalar ( void *const *pp_data, size_t size, const void *p_value, bool first );
+
+/** !
+ * Count a byte one byte at a time
+ *
+ * @param p_data the bytes
+ * @param size   the quantity of bytes
+ * @param value  the byte
+ *
+ * @return the quantity of matches
+ */
+static size_t circular_buffer_search_bytes_scalar ( const unsigned char *p_data, size_t size, unsigned char value );
+
+#ifdef CIRCULAR_BUFFER_SEARCH_X86
+
+/** !
+ * Find or count a pointer two elements at a time
+ *
+ * @param pp_data the elements
+ * @param size    the quantity of elements
+ * @param p_value the pointer
+ * @param first   true to stop at the first match
+ *
+ * @return the position of the first match, or size if none, when first is true, else the quantity of matches
+ */
+static size_t circular_buffer_search_pointers_sse2 ( void *const *pp_data, size_t size, const void *p_value, bool first );
+
+/** !
+ * Find or count a pointer eight elements at a time
+ *
+ * @param pp_data the elements
+ * @param size    the quantity of elements
+ * @param p_value the pointer
+ * @param first   true to stop at the first match
+ *
+ * @return the position of the first match, or size if none, when first is true, else the quantity of matches
+ */
+static size_t circular_buffer_search_pointers_avx2 ( void *const *pp_data, size_t size, const void *p_value, bool first ) __attribute__((target("avx2")));
+
+/** !
+ * Count a byte sixteen bytes at a time
+ *
+ * @param p_data the bytes
+ * @param size   the quantity of bytes
+ * @param value  the byte
+ *
+ * @return the quantity of matches
+ */
+static size_t circular_buffer_search_bytes_sse2 ( const unsigned char *p_data, size_t size, unsigned char value );
+
+/** !
+ * Count a byte thirty two bytes at a time
+ *
+ * @param p_data the bytes
+ * @param size   the quantity of bytes
+ * @param value  the byte
+ *
+ * @return the quantity of matches
+ */
+static size_t circular_buffer_search_bytes_avx2 ( const unsigned char *p_data, size_t size, unsigned char value ) __attribute__((target("avx2,popcnt")));
+
+#endif
+
+/** !
+ * Choose the widest pointer kernel this processor supports
+ *
+ * @param void
+ *
+ * @return the kernel
+ */
+static fn_circular_buffer_search_pointers *circular_buffer_search_pointers_kernel ( void );
+
+/** !
+ * Choose the widest byte kernel this processor supports
+ *
+ * @param void
+ *
+ * @return the kernel
+ */
+static fn_circular_buffer_search_bytes *circular_buffer_search_bytes_kernel ( void );
+
+// Function definitions
+size_t circular_buffer_search_find ( void *const *pp_data, size_t size, const void *p_value )
+{
+
+	// Success
+	return circular_buffer_search_pointers_kernel()(pp_data, size, p_value, true);
+}
+
+size_t circular_buffer_search_count ( void *const *pp_data, size_t size, const void *p_value )
+{
+
+	// Success
+	return circular_buffer_search_pointers_kernel()(pp_data, size, p_value, false);
+}
+
+size_t circular_buffer_search_count_bytes ( const unsigned char *p_data, size_t size, unsigned char value )
+{
+
+	// Success
+	return circular_buffer_search_bytes_kernel()(p_data, size, value);
+}
+
+static fn_circular_buffer_search_pointers *circular_buffer_search_pointers_kernel ( void )
+{
+
+	#ifdef CIRCULAR_BUFFER_SEARCH_X86
+
+		// AVX2
+		if ( __builtin_cpu_supports("avx2") ) return circular_buffer_search_pointers_avx2;
+
+		// SSE2 is part of x86-64
+		return circular_buffer_search_pointers_sse2;
+	#else
+
+		// Scalar
+		return circular_buffer_search_pointers_scalar;
+	#endif
+}
+
+static fn_circular_buffer_search_bytes *circular_buffer_search_bytes_kernel ( void )
+{
+
+	#ifdef CIRCULAR_BUFFER_SEARCH_X86
+
+		// AVX2
+		if ( __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt") ) return circular_buffer_search_bytes_avx2;
+
+		// SSE2 is part of x86-64
+		return circular_buffer_search_bytes_sse2;
+	#else
+
+		// Scalar
+		return circular_buffer_search_bytes_scalar;
+	#endif
+}
+
+static size_t circular_buffer_search_pointers_scalar ( void *const *pp_data, size_t size, const void *p_value, bool first )
+{
+
+	// Initialized data
+	size_t ret = 0;
+
+	// Each element
+	for (size_t i = 0; i < size; i++)
+	{
+
+		// Skip elements that do not match
+		if ( pp_data[i] != p_value ) continue;
+
+		// Found
+		if ( first ) return i;
+
+		// Count
+		ret++;
+	}
+
+	// Success
+	return ( first ) ? size : ret;
+}
+
+static size_t circular_buffer_search_bytes_scalar ( const unsigned char *p_data, size_t size, unsigned char value )
+{
+
+	// Initialized data
+	size_t ret = 0;
+
+	// Count each match
+	for (size_t i = 0; i < size; i++) ret += ( p_data[i] == value );
+
+	// Success
+	return ret;
+}
+
+#ifdef CIRCULAR_BUFFER_SEARCH_X86
+
+static size_t circular_buffer_search_pointers_sse2 ( void *const *pp_data, size_t size, const void *p_value, bool first )
+{
+
+	// Initialized data
+	__m128i needle = _mm_set1_epi64x((long long) (uintptr_t) p_value);
+	size_t  ret    = 0,
+	        i      = 0;
+
+	// Two elements at a time
+	for (; i + 2 <= size; i += 2)
+	{
+
+		// Compare the halves of each element, then require both halves to match.
+		// SSE2 has no 64 bit compare.
+		__m128i halves = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) &pp_data[i]), needle);
+		int     mask   = _mm_movemask_pd(_mm_castsi128_pd(_mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)))));
+
+		// No match
+		if ( mask == 0 ) continue;
+
+		// Found
+		if ( first ) return i + (size_t) __builtin_ctz((unsigned) mask);
+
+		// Count
+		ret += (size_t) __builtin_popcount((unsigned) mask);
+	}
+
+	// The remainder
+	if ( i < size )
+	{
+
+		// Initialized data
+		size_t tail = circular_buffer_search_pointers_scalar(pp_data + i, size - i, p_value, first);
+
+		// Success
+		return ( first ) ? i + tail : ret + tail;
+	}
+
+	// Success
+	return ( first ) ? size : ret;
+}
+
+static size_t circular_buffer_search_pointers_avx2 ( void *const *pp_data, size_t size, const void *p_value, bool first )
+{
+
+	// Initialized data
+	__m256i needle = _mm256_set1_epi64x((long long) (uintptr_t) p_value);
+	size_t  ret    = 0,
+	        i      = 0;
+
+	// Eight elements at a time, in two independent compares
+	for (; i + 8 <= size; i += 8)
+	{
+
+		// Initialized data
+		unsigned lo   = (unsigned) _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *) &pp_data[i    ]), needle))),
+		         hi   = (unsigned) _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *) &pp_data[i + 4]), needle))),
+		         mask = lo | ( hi << 4 );
+
+		// No match
+		if ( mask == 0 ) continue;
+
+		// Found
+		if ( first ) return i + (size_t) __builtin_ctz(mask);
+
+		// Count
+		ret += (size_t) __builtin_popcount(mask);
+	}
+
+	// The remainder
+	if ( i < size )
+	{
+
+		// Initialized data
+		size_t tail = circular_buffer_search_pointers_scalar(pp_data + i, size - i, p_value, first);
+
+		// Success
+		return ( first ) ? i + tail : ret + tail;
+	}
+
+	// Success
+	return ( first ) ? size : ret;
+}
+
+static size_t circular_buffer_search_bytes_sse2 ( const unsigned char *p_data, size_t size, unsigned char value )
+{
+
+	// Initialized data
+	__m128i needle = _mm_set1_epi8((char) value);
+	size_t  ret    = 0,
+	        i      = 0;
+
+	// Sixteen bytes at a time
+	for (; i + 16 <= size; i += 16)
+		ret += (size_t) __builtin_popcount((unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) &p_data[i]), needle)));
+
+	// Success
+	return ret + circular_buffer_search_bytes_scalar(p_data + i, size - i, value);
+}
+
+static size_t circular_buffer_search_bytes_avx2 ( const unsigned char *p_data, size_t size, unsigned char value )
+{
+
+	// Initialized data
+	__m256i needle = _mm256_set1_epi8((char) value);
+	size_t  ret    = 0,
+	        i      = 0;
+
+	// Thirty two bytes at a time
+	for (; i + 32 <= size; i += 32)
+		ret += (size_t) __builtin_popcount((unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) &p_data[i]), needle)));
+
+	// Success
+	return ret + circular_buffer_search_bytes_scalar(p_data + i, size - i, value);
+}
+
+#endif
@@ -0,0 +1,580 @@
+/** !
+ * Circular buffer spill tier implementation
+ *
+ * @file circular_buffer_spill.c
+ *
+ * @author Jacob Smith
+ */
+
+// Header
+#include <circular_buffer/spill.h>
+
+// Internal
+#include "circular_buffer_internal.h"
+
+// Size of the stdio buffers on the spill log, so disk I/O happens in large sequential blocks
+#ifndef CIRCULAR_BUFFER_SPILL_BUFFER_SIZE
+#define CIRCULAR_BUFFER_SPILL_BUFFER_SIZE ( 1 << 20 )
+#endif
+
+// Function declarations
+/** !
+ * Open the spill log for writing and reading, truncating it
+ *
+ * @param p_spill the spill tier
+ *
+ * @return 1 on success, 0 on error
+ */
+static int circular_buffer_spill_open ( struct circular_buffer_spill_s *p_spill );
+
+/** !
+ * Close the spill log
+ *
+ * @param p_spill the spill tier
+ *
+ * @return void
+ */
+static void circular_buffer_spill_close ( struct circular_buffer_spill_s *p_spill );
+
+/** !
+ * Read the next record of the spill log and deserialize it
+ *
+ * @param p_spill   the spill tier
+ * @param pp_element return, a null pointer if the deserializer rejected the record
+ *
+ * @return 1 on success, 0 on error
+ */
+static int circular_buffer_spill_read ( struct circular_buffer_spill_s *p_spill, void **pp_element );
+
+/** !
+ * Make sure a scratch buffer holds at least size bytes
+ *
+ * @param pp_scratch the scratch buffer
+ * @param p_capacity the size of the scratch buffer
+ * @param size       the quantity of bytes
+ *
+ * @return 1 on success, 0 on error
+ */
+static int circular_buffer_spill_reserve ( unsigned char **pp_scratch, size_t *p_capacity, size_t size );
+
+// Function definitions
+static int circular_buffer_spill_open ( struct circular_buffer_spill_s *p_spill )
+{
+
+	// Open the log for appending, truncating whatever was there
+	p_spill->p_writer = fopen(p_spill->p_path, "wb");
+
+	// Error check
+	if ( p_spill->p_writer == (void *) 0 ) goto failed_to_open;
+
+	// Open the log for reading from the start
+	p_spill->p_reader = fopen(p_spill->p_path, "rb");
+
+	// Error check
+	if ( p_spill->p_reader == (void *) 0 ) goto failed_to_open;
+
+	// Batch small records into large sequential writes and reads
+	setvbuf(p_spill->p_writer, 0, _IOFBF, CIRCULAR_BUFFER_SPILL_BUFFER_SIZE);
+	setvbuf(p_spill->p_reader, 0, _IOFBF, CIRCULAR_BUFFER_SPILL_BUFFER_SIZE);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Standard library errors
+		{
+			failed_to_open:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to open \"%s\" in call to function \"%s\"\n", p_spill->p_path, __FUNCTION__);
+				#endif
+
+				// Clean up
+				circular_buffer_spill_close(p_spill);
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+static void circular_buffer_spill_close ( struct circular_buffer_spill_s *p_spill )
+{
+
+	// Close the writer
+	if ( p_spill->p_writer ) fclose(p_spill->p_writer);
+
+	// Close the reader
+	if ( p_spill->p_reader ) fclose(p_spill->p_reader);
+
+	// Clear the handles
+	p_spill->p_writer = 0,
+	p_spill->p_reader = 0;
+
+	// Done
+	return;
+}
+
+static int circular_buffer_spill_reserve ( unsigned char **pp_scratch, size_t *p_capacity, size_t size )
+{
+
+	// Fast exit
+	if ( size <= *p_capacity ) return 1;
+
+	// Initialized data
+	unsigned char *p_scratch = CIRCULAR_BUFFER_REALLOC(*pp_scratch, size);
+
+	// Error check
+	if ( p_scratch == (void *) 0 ) goto no_mem;
+
+	// Store the scratch buffer
+	*pp_scratch = p_scratch;
+	*p_capacity = size;
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+static int circular_buffer_spill_read ( struct circular_buffer_spill_s *p_spill, void **pp_element )
+{
+
+	// Initialized data
+	size_t size = 0;
+
+	// Read the record
+	if ( fread(&size, sizeof(size_t), 1, p_spill->p_reader) != 1 ) goto failed_to_read;
+	if ( circular_buffer_spill_reserve(&p_spill->_p_read_scratch, &p_spill->read_scratch_size, size) == 0 ) goto failed_to_read;
+	if ( size && fread(p_spill->_p_read_scratch, size, 1, p_spill->p_reader) != 1 ) goto failed_to_read;
+
+	// Rebuild the element
+	*pp_element = p_spill->pfn_deserialize(p_spill->_p_read_scratch, size, p_spill->p_context);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Standard library errors
+		{
+			failed_to_read:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to read \"%s\" in call to function \"%s\"\n", p_spill->p_path, __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_spill_attach ( circular_buffer *const p_circular_buffer, const char *p_path, fn_circular_buffer_serialize *pfn_serialize, fn_circular_buffer_deserialize *pfn_deserialize, void *p_context )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( p_path            == (void *) 0 ) goto no_path;
+	if ( pfn_serialize     == (void *) 0 ) goto no_serializer;
+	if ( pfn_deserialize   == (void *) 0 ) goto no_serializer;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BYTES ) goto byte_buffer;
+	if ( p_circular_buffer->features & CIRCULAR_BUFFER_FEATURE_BUDGET ) goto budgeted;
+	if ( p_circular_buffer->_p_spill ) goto already_attached;
+
+	// Initialized data
+	size_t                          path_length = strlen(p_path) + 1;
+	struct circular_buffer_spill_s *p_spill     = CIRCULAR_BUFFER_REALLOC(0, sizeof(struct circular_buffer_spill_s));
+
+	// Error check
+	if ( p_spill == (void *) 0 ) goto no_mem;
+
+	// Zero set
+	memset(p_spill, 0, sizeof(struct circular_buffer_spill_s));
+
+	// Copy the path
+	p_spill->p_path = CIRCULAR_BUFFER_REALLOC(0, path_length);
+
+	// Error check
+	if ( p_spill->p_path == (void *) 0 ) goto no_mem;
+
+	// Allocate room for one refill of deserialized elements
+	p_spill->_p_batch = CIRCULAR_BUFFER_REALLOC(0, p_circular_buffer->length * sizeof(void *));
+
+	// Error check
+	if ( p_spill->_p_batch == (void *) 0 ) goto no_mem;
+
+	// Populate the struct
+	memcpy(p_spill->p_path, p_path, path_length);
+	p_spill->pfn_serialize   = pfn_serialize;
+	p_spill->pfn_deserialize = pfn_deserialize;
+	p_spill->p_context       = p_context;
+
+	// Serialize refills
+	circular_buffer_lock_init(&p_spill->_reader, CIRCULAR_BUFFER_LOCK_DEFAULT_SPIN);
+
+	// Open the log
+	if ( circular_buffer_spill_open(p_spill) == 0 ) goto failed_to_open;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Attach the spill tier
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->_p_spill, p_spill);
+	p_circular_buffer->features  |= CIRCULAR_BUFFER_FEATURE_SPILL;
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_path:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_path\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			no_serializer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Spill tier requires a serializer and a deserializer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Circular buffer errors
+		{
+			byte_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte circular buffers do not hold pointers in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			budgeted:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Byte budgeted circular buffers evict instead of spilling in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			already_attached:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Circular buffer already has a spill log in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			failed_to_open:
+
+				// Free the memory
+				p_spill->_p_batch = CIRCULAR_BUFFER_REALLOC(p_spill->_p_batch, 0);
+				p_spill->p_path   = CIRCULAR_BUFFER_REALLOC(p_spill->p_path, 0);
+				p_spill           = CIRCULAR_BUFFER_REALLOC(p_spill, 0);
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free the memory
+				if ( p_spill && p_spill->p_path ) p_spill->p_path = CIRCULAR_BUFFER_REALLOC(p_spill->p_path, 0);
+				if ( p_spill ) p_spill = CIRCULAR_BUFFER_REALLOC(p_spill, 0);
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_spill_count ( circular_buffer *const p_circular_buffer )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Initialized data
+	size_t ret = ( p_circular_buffer->_p_spill ) ? p_circular_buffer->_p_spill->count : 0;
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+size_t circular_buffer_spill_dropped ( circular_buffer *const p_circular_buffer )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Initialized data
+	size_t ret = ( p_circular_buffer->_p_spill ) ? p_circular_buffer->_p_spill->dropped : 0;
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return ret;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+int circular_buffer_spill_append ( circular_buffer *const p_circular_buffer, void *p_data )
+{
+
+	// Initialized data
+	struct circular_buffer_spill_s *p_spill = p_circular_buffer->_p_spill;
+
+	// State check
+	if ( p_spill->p_writer == (void *) 0 ) goto failed_to_write;
+
+	// Initialized data
+	size_t size = p_spill->pfn_serialize(p_data, p_spill->p_scratch, p_spill->scratch_size, p_spill->p_context);
+
+	// The serializer needs more room
+	if ( size > p_spill->scratch_size )
+	{
+
+		// Grow the scratch buffer
+		if ( circular_buffer_spill_reserve(&p_spill->p_scratch, &p_spill->scratch_size, size) == 0 ) goto failed_to_serialize;
+
+		// Serialize again
+		if ( p_spill->pfn_serialize(p_data, p_spill->p_scratch, p_spill->scratch_size, p_spill->p_context) != size ) goto failed_to_serialize;
+	}
+
+	// Append the record
+	if ( fwrite(&size, sizeof(size_t), 1, p_spill->p_writer) != 1 ) goto failed_to_write;
+	if ( size && fwrite(p_spill->p_scratch, size, 1, p_spill->p_writer) != 1 ) goto failed_to_write;
+
+	// Increment the counter
+	CIRCULAR_BUFFER_STORE(p_spill->count, p_spill->count + 1);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Circular buffer errors
+		{
+			failed_to_serialize:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Failed to serialize element in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+
+		// Standard library errors
+		{
+			failed_to_write:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to write \"%s\" in call to function \"%s\"\n", p_spill->p_path, __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+void circular_buffer_spill_refill ( circular_buffer *const p_circular_buffer )
+{
+
+	// Initialized data
+	struct circular_buffer_spill_s *p_spill  = p_circular_buffer->_p_spill;
+	size_t                          wanted   = 0,
+	                                consumed = 0,
+	                                stored   = 0,
+	                                dropped  = 0,
+	                                count    = 0;
+	bool                            signal   = false,
+	                                failed   = false;
+
+	// Fast exit
+	if ( CIRCULAR_BUFFER_LOAD(p_spill->count) == 0 ) return;
+
+	// One reader at a time
+	circular_buffer_lock_acquire(&p_spill->_reader);
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Only refill a drained circular buffer, with as many records as fit
+	if ( circular_buffer_count_unlocked(p_circular_buffer) == 0 ) wanted = ( p_spill->count < p_circular_buffer->length ) ? p_spill->count : p_circular_buffer->length;
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Nothing to read
+	if ( wanted == 0 ) goto done;
+
+	// Make every appended record visible to the reader. Producers append
+	// under the lock of the circular buffer, and stdio locks the stream
+	// against them, so that lock is not needed here.
+	failed = fflush(p_spill->p_writer) != 0;
+
+	// The reader may have seen the old end of file
+	clearerr(p_spill->p_reader);
+
+	// Read and rebuild the records, without the lock. While records are
+	// waiting, every push appends to the log, so the circular buffer stays
+	// empty in the meantime.
+	for (; failed == false && consumed < wanted; consumed++)
+	{
+
+		// Initialized data
+		void *p_element = (void *) 0;
+
+		// Read the record, discarding the rest of the log on error
+		if ( circular_buffer_spill_read(p_spill, &p_element) == 0 ) failed = true;
+
+		// Keep the element
+		else if ( p_element ) p_spill->_p_batch[stored++] = p_element;
+
+		// Count the record the deserializer rejected
+		else dropped++;
+	}
+
+	// Report rejected records
+	#ifndef NDEBUG
+		if ( dropped ) log_error("[circular buffer] Deserializer rejected %zu spilled elements in call to function \"%s\"\n", dropped, __FUNCTION__);
+	#endif
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Store each element through the usual path, before the records are
+	// consumed, so lock free readers never see both tiers empty
+	for (size_t i = 0; i < stored; i++) circular_buffer_insert_unlocked(p_circular_buffer, p_spill->_p_batch[i], 0, &signal, &count);
+
+	// Consume the records
+	CIRCULAR_BUFFER_STORE(p_spill->count, ( failed ) ? 0 : p_spill->count - consumed);
+	p_spill->dropped += dropped;
+
+	// Consume the event if every record was dropped
+	if ( stored == 0 ) circular_buffer_event_drained(p_circular_buffer);
+
+	// Start a fresh log once this one is drained. Every record has been
+	// read, so closing the writer has nothing left to write.
+	if ( p_spill->count == 0 ) circular_buffer_spill_close(p_spill), circular_buffer_spill_open(p_spill);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Wake event loops
+	if ( signal ) circular_buffer_event_signal(p_circular_buffer);
+
+	// Wake the consumer thread
+	if ( count ) circular_buffer_consumer_notify(p_circular_buffer, count);
+
+	done:
+
+	// Let the next reader in
+	circular_buffer_lock_release(&p_spill->_reader);
+
+	// Done
+	return;
+}
+
+void circular_buffer_spill_destroy ( circular_buffer *const p_circular_buffer )
+{
+
+	// Initialized data
+	struct circular_buffer_spill_s *p_spill = p_circular_buffer->_p_spill;
+
+	// Detach the spill tier
+	p_circular_buffer->_p_spill  = 0;
+	p_circular_buffer->features &= ~CIRCULAR_BUFFER_FEATURE_SPILL;
+
+	// Close and remove the log
+	circular_buffer_spill_close(p_spill);
+	remove(p_spill->p_path);
+
+	// Free the memory
+	p_spill->p_scratch       = CIRCULAR_BUFFER_REALLOC(p_spill->p_scratch, 0);
+	p_spill->_p_read_scratch = CIRCULAR_BUFFER_REALLOC(p_spill->_p_read_scratch, 0);
+	p_spill->_p_batch        = CIRCULAR_BUFFER_REALLOC(p_spill->_p_batch, 0);
+	p_spill->p_path          = CIRCULAR_BUFFER_REALLOC(p_spill->p_path, 0);
+	p_spill                  = CIRCULAR_BUFFER_REALLOC(p_spill, 0);
+
+	// Done
+	return;
+}
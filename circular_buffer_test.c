@@ -10,6 +10,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+// Platform dependent includes
+#ifndef _WIN64
+    #include <errno.h>
+    #include <unistd.h>
+    #include <poll.h>
+    #include <pthread.h>
+    #include <sched.h>
+#endif
 
 // log module
 #include <log/log.h>
@@ -19,6 +29,21 @@
 
 // circular buffer module
 #include <circular_buffer/circular_buffer.h>
+#include <circular_buffer/aggregate.h>
+#include <circular_buffer/bytes.h>
+#include <circular_buffer/spill.h>
+#include <circular_buffer/event.h>
+#include <circular_buffer/consumer.h>
+#include <circular_buffer/latency.h>
+#include <circular_buffer/combining.h>
+#include <circular_buffer/watermark.h>
+#include <circular_buffer/producer.h>
+#include <circular_buffer/log.h>
+#include <circular_buffer/coalesce.h>
+#include <circular_buffer/samples.h>
+#include <circular_buffer/budget.h>
+#include <circular_buffer/executor.h>
+#include <circular_buffer/drain.h>
 
 // Possible elements
 void *A_element = (void *)0x1,
@@ -77,6 +102,27 @@ int test_one_element_circular_buffer   ( int (*circular_buffer_constructor)(circ
 int test_two_element_circular_buffer   ( int (*circular_buffer_constructor)(circular_buffer **), char *name, void **elements );
 int test_three_element_circular_buffer ( int (*circular_buffer_constructor)(circular_buffer **), char *name, void **elements );
 
+int test_aggregate ( char *name );
+int test_timed     ( char *name );
+int test_init      ( char *name );
+int test_bytes     ( char *name );
+int test_spill     ( char *name );
+int test_event     ( char *name );
+int test_consumer  ( char *name );
+int test_latency   ( char *name );
+int test_lock      ( char *name );
+int test_size      ( char *name );
+int test_at        ( char *name );
+int test_watermark ( char *name );
+int test_producer  ( char *name );
+int test_log       ( char *name );
+int test_coalesce  ( char *name );
+int test_find      ( char *name );
+int test_samples   ( char *name );
+int test_budget    ( char *name );
+int test_executor  ( char *name );
+int test_drain     ( char *name );
+
 int construct_empty            ( circular_buffer **pp_circular_buffer );
 
 int construct_empty_pushA_A    ( circular_buffer **pp_circular_buffer );
@@ -283,6 +329,65 @@ int run_tests()
     // // [ A, B ] -> pop() -> [ B, _ ]
     // test_one_element_circular_buffer(construct_AB_pop_A, "AB_pop_A", A_contents);
 
+    // [ 1, 5, 2 ] -> push(3) -> push(4) -> pop() -> [ 3, 4 ]
+    test_aggregate("aggregate");
+
+    // [ A, B, | C ] -> expire() -> [ _, _, _ ]
+    test_timed("timed");
+
+    // init([ _, _ ]) -> push(A) -> push(B) -> push(C) -> [ B, C ]
+    test_init("init");
+
+    // [ a, b, c, d, e, f, _, _ ] -> read(4) -> write(ghijkl) -> [ k, l, | e, f, g, h, i, j ]
+    test_bytes("bytes");
+
+    // [ A, B ] -> push(C) -> push(D) -> [ A, B ] + disk[ C, D ]
+    test_spill("spill");
+
+    // [ _, _, _ ] -> push(A) -> readable -> pop() -> not readable
+    test_event("event");
+
+    // [ A, B, C, _ ] -> consumer(batch 2) -> detach() -> [ A, B ] [ C ]
+    test_consumer("consumer");
+
+    // [ A, B, C, D ] -> sample(1 in 2) -> pop() x 4 -> 2 samples
+    test_latency("latency");
+
+    // 4 threads x push(1..1000) -> [ 4000 elements ] -> sum, with each push path
+    test_lock("lock");
+
+    // [ _, _, _ ] -> push(A) -> push(B) -> push(C) -> push(D) -> pop() -> [ _, C, D ]
+    test_size("size");
+
+    // [ D, | B, C ] -> at(0) = B, latest(0) = D, copy_range(1, 5) = [ C, D ]
+    test_at("at");
+
+    // high 3, low 1: push(A, B, C) -> pressure -> pop() x 2 -> relief
+    test_watermark("watermark");
+
+    // stage[ A, B ] -> push(C) -> [ A, B, C, _ ] -> stage[ D ] -> close() -> [ A, B, C, D ]
+    test_producer("producer");
+
+    // printf("A"), printf("B"), printf("C") -> flush() -> "A\nB\nC\n" ; dump() -> "B\nC\n"
+    test_log("log");
+
+    // push(1, A), push(2, B), push(1, C) -> [ C, B, _, _ ]
+    test_coalesce("coalesce");
+
+    // [ B, C, D, A ] -> find(A) -> 3 ; [ C, D, A, A ] -> count(A) -> 2
+    test_find("find");
+
+    // push(1, 2, 3, 4, 5, 6) -> [ 3, 4, 5, 6 ] -> mean, rms, min, max, dot
+    test_samples("samples");
+
+    // budget 10: push(A, 4), push(B, 4), push(C, 5) -> evict(A) -> [ B, C ] -> 9 bytes
+    test_budget("budget");
+
+    // submit(1 .. 1000) -> wait() -> 500500 ; submit(tree of depth 10) -> wait() -> 2047 tasks
+    test_executor("executor");
+
+    // [ A, B, C ] -> push(D) -> drain_all() -> { B, C, D } -> [ ] ; push(A) -> release() -> drain_all() -> { A }
+    test_drain("drain");
 
     // Success
     return 1;
@@ -561,6 +666,1182 @@ int test_one_element_circular_buffer   ( int (*circular_buffer_constructor)(circ
     // Success
     return 1;
 }
+double square_combine ( double accumulator, double value ) { return accumulator + value * value; }
+double square_retract ( double accumulator, double value ) { return accumulator - value * value; }
+
+int test_aggregate ( char *name )
+{
+
+    // Initialized data
+    circular_buffer_aggregate *p_aggregate = 0;
+    circular_buffer_combiner   squares     = { .identity = 0, .pfn_combine = square_combine, .pfn_retract = square_retract };
+    double                     sum = 0, min = 0, max = 0, mean = 0, custom = 0;
+    void                      *p_element   = 0;
+
+    log_scenario("%s\n", name);
+
+    // [ 1, 5, 2 ]
+    circular_buffer_aggregate_construct(&p_aggregate, 3, 0, &squares);
+    circular_buffer_aggregate_push(p_aggregate, (void *)1);
+    circular_buffer_aggregate_push(p_aggregate, (void *)5);
+    circular_buffer_aggregate_push(p_aggregate, (void *)2);
+
+    circular_buffer_aggregate_sum(p_aggregate, &sum);
+    circular_buffer_aggregate_min(p_aggregate, &min);
+    circular_buffer_aggregate_max(p_aggregate, &max);
+    circular_buffer_aggregate_custom(p_aggregate, &custom);
+    print_test(name, "circular_buffer_aggregate_sum"   , sum    == 8 );
+    print_test(name, "circular_buffer_aggregate_min"   , min    == 1 );
+    print_test(name, "circular_buffer_aggregate_max"   , max    == 5 );
+    print_test(name, "circular_buffer_aggregate_custom", custom == 30 );
+
+    // [ 1, 5, 2 ] -> push(3) -> [ 5, 2, 3 ] -> push(4) -> [ 2, 3, 4 ]
+    circular_buffer_aggregate_push(p_aggregate, (void *)3);
+    circular_buffer_aggregate_push(p_aggregate, (void *)4);
+
+    circular_buffer_aggregate_sum(p_aggregate, &sum);
+    circular_buffer_aggregate_min(p_aggregate, &min);
+    circular_buffer_aggregate_max(p_aggregate, &max);
+    circular_buffer_aggregate_custom(p_aggregate, &custom);
+    print_test(name, "circular_buffer_aggregate_overflow_sum"   , sum    == 9 );
+    print_test(name, "circular_buffer_aggregate_overflow_min"   , min    == 2 );
+    print_test(name, "circular_buffer_aggregate_overflow_max"   , max    == 4 );
+    print_test(name, "circular_buffer_aggregate_overflow_custom", custom == 29 );
+
+    // [ 2, 3, 4 ] -> pop() -> [ 3, 4 ]
+    circular_buffer_aggregate_pop(p_aggregate, &p_element);
+    circular_buffer_aggregate_min(p_aggregate, &min);
+    circular_buffer_aggregate_mean(p_aggregate, &mean);
+    print_test(name, "circular_buffer_aggregate_pop" , p_element == (void *)2 );
+    print_test(name, "circular_buffer_aggregate_min" , min       == 3 );
+    print_test(name, "circular_buffer_aggregate_mean", mean      == 3.5 );
+
+    // Free the aggregate
+    circular_buffer_aggregate_destroy(&p_aggregate);
+
+    // [ 1e17, 1, 1, 1 ] -> push(1) -> [ 1, 1, 1, 1 ]
+    circular_buffer_aggregate_construct(&p_aggregate, 4, 0, 0);
+    circular_buffer_aggregate_push(p_aggregate, (void *)(intptr_t)100000000000000000LL);
+    circular_buffer_aggregate_push(p_aggregate, (void *)1);
+    circular_buffer_aggregate_push(p_aggregate, (void *)1);
+    circular_buffer_aggregate_push(p_aggregate, (void *)1);
+    circular_buffer_aggregate_push(p_aggregate, (void *)1);
+
+    circular_buffer_aggregate_sum(p_aggregate, &sum);
+    print_test(name, "circular_buffer_aggregate_compensated_sum", sum == 4 );
+
+    // Free the aggregate
+    circular_buffer_aggregate_destroy(&p_aggregate);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int test_timed ( char *name )
+{
+
+    // Initialized data
+    circular_buffer *p_circular_buffer = 0;
+    timestamp        ttl               = (timestamp) timer_seconds_divisor() * 3600,
+                     t                 = 0;
+    void            *p_value           = 0;
+
+    log_scenario("%s\n", name);
+
+    // [ A, B, | C ]
+    circular_buffer_construct_timed(&p_circular_buffer, 3, ttl);
+    circular_buffer_push(p_circular_buffer, A_element);
+    circular_buffer_push(p_circular_buffer, B_element);
+    t = timer_high_precision();
+    circular_buffer_push(p_circular_buffer, C_element);
+
+    print_test(name, "circular_buffer_count_since_0", circular_buffer_count_since(p_circular_buffer, 0) == 3 );
+    print_test(name, "circular_buffer_count_since_t", circular_buffer_count_since(p_circular_buffer, t) == 1 );
+    print_test(name, "circular_buffer_peek"         , circular_buffer_peek(p_circular_buffer, &p_value) && p_value == A_element );
+    print_test(name, "circular_buffer_expire_now"   , circular_buffer_expire(p_circular_buffer, t) == 0 );
+    print_test(name, "circular_buffer_expire_ttl"   , circular_buffer_expire(p_circular_buffer, t + ttl) == 2 );
+    print_test(name, "circular_buffer_pop"          , circular_buffer_pop(p_circular_buffer, &p_value) && p_value == C_element );
+    print_test(name, "circular_buffer_empty"        , circular_buffer_empty(p_circular_buffer) );
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int test_init ( char *name )
+{
+
+    // Initialized data
+    circular_buffer  _circular_buffer  = { 0 },
+                    *p_circular_buffer = &_circular_buffer;
+    void            *_p_storage[2]     = { 0 },
+                    *p_value           = 0;
+
+    log_scenario("%s\n", name);
+
+    // [ _, _ ]
+    print_test(name, "circular_buffer_init" , circular_buffer_init(p_circular_buffer, _p_storage, 2) );
+    print_test(name, "circular_buffer_empty", circular_buffer_empty(p_circular_buffer) );
+
+    // [ A, B ] -> push(C) -> [ B, C ]
+    circular_buffer_push(p_circular_buffer, A_element);
+    circular_buffer_push(p_circular_buffer, B_element);
+    circular_buffer_push(p_circular_buffer, C_element);
+    print_test(name, "circular_buffer_full"   , circular_buffer_full(p_circular_buffer) );
+    print_test(name, "circular_buffer_pop"    , circular_buffer_pop(p_circular_buffer, &p_value) && p_value == B_element );
+    print_test(name, "circular_buffer_storage", _p_storage[0] == C_element );
+
+    // The storage belongs to the caller
+    print_test(name, "circular_buffer_destroy", circular_buffer_destroy(&p_circular_buffer) && p_circular_buffer == 0 );
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int test_bytes ( char *name )
+{
+
+    // Initialized data
+    circular_buffer *p_circular_buffer = 0;
+    char             _buffer[16]       = { 0 };
+
+    log_scenario("%s\n", name);
+
+    // [ a, b, c, d, e, f, _, _ ] -> read(4) -> [ _, _, _, _, e, f, _, _ ]
+    circular_buffer_construct_bytes(&p_circular_buffer, 8);
+    print_test(name, "circular_buffer_write", circular_buffer_write(p_circular_buffer, "abcdef", 6) == 6 );
+    print_test(name, "circular_buffer_read" , circular_buffer_read(p_circular_buffer, _buffer, 4) == 4 && memcmp(_buffer, "abcd", 4) == 0 );
+
+    // write(ghijkl) -> [ k, l, | e, f, g, h, i, j ] -> write(m) -> [ k, l, | e, f, g, h, i, j ]
+    print_test(name, "circular_buffer_write_wrap", circular_buffer_write(p_circular_buffer, "ghijkl", 6) == 6 );
+    print_test(name, "circular_buffer_write_full", circular_buffer_write(p_circular_buffer, "m", 1) == 0 && circular_buffer_full(p_circular_buffer) );
+    print_test(name, "circular_buffer_push"      , circular_buffer_push(p_circular_buffer, A_element) == 0 );
+
+    #ifndef _WIN64
+    {
+
+        // Initialized data
+        int _fds[2] = { -1, -1 };
+
+        // Drain and fill through a pipe
+        if ( pipe(_fds) == 0 )
+        {
+            print_test(name, "circular_buffer_write_fd", circular_buffer_write_fd(p_circular_buffer, _fds[1], 16) == 8 && read(_fds[0], _buffer, 16) == 8 && memcmp(_buffer, "efghijkl", 8) == 0 );
+            print_test(name, "circular_buffer_empty"   , circular_buffer_empty(p_circular_buffer) );
+            print_test(name, "circular_buffer_read_fd" , write(_fds[1], "nopqrst", 7) == 7 && circular_buffer_read_fd(p_circular_buffer, _fds[0], 16) == 7 );
+            print_test(name, "circular_buffer_read"    , circular_buffer_read(p_circular_buffer, _buffer, 16) == 7 && memcmp(_buffer, "nopqrst", 7) == 0 );
+            print_test(name, "circular_buffer_read_fd_full", circular_buffer_write(p_circular_buffer, "uvwxyzAB", 8) == 8 && write(_fds[1], "C", 1) == 1 && circular_buffer_read_fd(p_circular_buffer, _fds[0], 16) == -1 && errno == ENOBUFS );
+            close(_fds[0]), close(_fds[1]);
+        }
+    }
+    #endif
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+size_t pointer_serialize ( void *p_element, void *p_buffer, size_t size, void *p_context )
+{
+    (void) p_context;
+    if ( size >= sizeof(void *) ) memcpy(p_buffer, &p_element, sizeof(void *));
+    return sizeof(void *);
+}
+
+void *pointer_deserialize ( const void *p_buffer, size_t size, void *p_context )
+{
+    void *p_element = 0;
+    (void) p_context;
+    if ( size == sizeof(void *) ) memcpy(&p_element, p_buffer, sizeof(void *));
+    return p_element;
+}
+
+void *reject_C_deserialize ( const void *p_buffer, size_t size, void *p_context )
+{
+    void *p_element = pointer_deserialize(p_buffer, size, p_context);
+    return ( p_element == C_element ) ? 0 : p_element;
+}
+
+#ifndef _WIN64
+bool spill_produced = false;
+
+void *spill_producer ( void *p_circular_buffer )
+{
+    for (size_t i = 1; i <= 20000; i++) circular_buffer_push(p_circular_buffer, (void *) i);
+    __atomic_store_n(&spill_produced, true, __ATOMIC_RELEASE);
+    return 0;
+}
+#endif
+
+int test_spill ( char *name )
+{
+
+    // Initialized data
+    circular_buffer *p_circular_buffer = 0;
+    void            *_p_values[4]      = { 0 };
+    size_t           index             = 0;
+
+    log_scenario("%s\n", name);
+
+    // [ A, B ] + disk[ C, D ]
+    circular_buffer_construct(&p_circular_buffer, 2);
+    print_test(name, "circular_buffer_spill_attach", circular_buffer_spill_attach(p_circular_buffer, "circular_buffer_spill_test.log", pointer_serialize, pointer_deserialize, 0) );
+    circular_buffer_push(p_circular_buffer, A_element);
+    circular_buffer_push(p_circular_buffer, B_element);
+    circular_buffer_push(p_circular_buffer, C_element);
+    circular_buffer_push(p_circular_buffer, D_element);
+    print_test(name, "circular_buffer_spill_count", circular_buffer_spill_count(p_circular_buffer) == 2 );
+    print_test(name, "circular_buffer_spill_size", circular_buffer_size(p_circular_buffer) == 4 );
+
+    // [ ] + disk[ C, D ] is not empty
+    for (size_t i = 0; i < 2; i++) circular_buffer_pop(p_circular_buffer, &_p_values[i]);
+    print_test(name, "circular_buffer_spill_empty", circular_buffer_empty(p_circular_buffer) == false && circular_buffer_size(p_circular_buffer) == 2 );
+
+    // Searching reads [ C, D ] back first
+    print_test(name, "circular_buffer_spill_find", circular_buffer_find(p_circular_buffer, D_element, &index) && index == 1 && circular_buffer_count(p_circular_buffer, C_element) == 1 );
+
+    // Nothing is lost, and order is preserved
+    for (size_t i = 2; i < 4; i++) circular_buffer_pop(p_circular_buffer, &_p_values[i]);
+    print_test(name, "circular_buffer_pop", _p_values[0] == A_element && _p_values[1] == B_element && _p_values[2] == C_element && _p_values[3] == D_element );
+    print_test(name, "circular_buffer_spill_drained", circular_buffer_spill_count(p_circular_buffer) == 0 && circular_buffer_empty(p_circular_buffer) );
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // [ A, B ] + disk[ C, D ] -> C is rejected by the deserializer -> A, B, D
+    circular_buffer_construct(&p_circular_buffer, 2);
+    circular_buffer_spill_attach(p_circular_buffer, "circular_buffer_spill_test.log", pointer_serialize, reject_C_deserialize, 0);
+    circular_buffer_push(p_circular_buffer, A_element);
+    circular_buffer_push(p_circular_buffer, B_element);
+    circular_buffer_push(p_circular_buffer, C_element);
+    circular_buffer_push(p_circular_buffer, D_element);
+    for (size_t i = 0; i < 3; i++) circular_buffer_pop(p_circular_buffer, &_p_values[i]);
+    print_test(name, "circular_buffer_spill_dropped", _p_values[2] == D_element && circular_buffer_spill_dropped(p_circular_buffer) == 1 && circular_buffer_pop(p_circular_buffer, &_p_values[3]) == 0 );
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // One producer spills while one consumer refills. Nothing is lost, and order is preserved.
+    #ifndef _WIN64
+    {
+        pthread_t producer;
+        size_t    expected = 1;
+        void     *p_value  = 0;
+
+        circular_buffer_construct(&p_circular_buffer, 16);
+        circular_buffer_spill_attach(p_circular_buffer, "circular_buffer_spill_test.log", pointer_serialize, pointer_deserialize, 0);
+        pthread_create(&producer, 0, spill_producer, p_circular_buffer);
+        while ( expected <= 20000 )
+        {
+            if ( circular_buffer_pop(p_circular_buffer, &p_value) == 0 )
+            {
+                if ( __atomic_load_n(&spill_produced, __ATOMIC_ACQUIRE) && circular_buffer_pop(p_circular_buffer, &p_value) == 0 ) break;
+                sched_yield();
+                continue;
+            }
+            if ( (size_t) p_value != expected ) break;
+            expected++;
+        }
+        pthread_join(producer, 0);
+        print_test(name, "circular_buffer_spill_concurrent", expected == 20001 && circular_buffer_spill_count(p_circular_buffer) == 0 );
+        circular_buffer_destroy(&p_circular_buffer);
+    }
+    #endif
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+bool fd_readable ( int fd )
+{
+    #ifndef _WIN64
+        struct pollfd _pfd = { .fd = fd, .events = POLLIN };
+        return poll(&_pfd, 1, 0) == 1;
+    #else
+        (void) fd;
+        return false;
+    #endif
+}
+
+int test_event ( char *name )
+{
+
+    // Initialized data
+    circular_buffer *p_circular_buffer = 0;
+    void            *p_value           = 0;
+    int              fd                = -1;
+
+    #ifndef __linux__
+        return 1;
+    #endif
+
+    log_scenario("%s\n", name);
+
+    // [ _, _, _ ]
+    circular_buffer_construct(&p_circular_buffer, 3);
+    fd = circular_buffer_get_fd(p_circular_buffer);
+    print_test(name, "circular_buffer_get_fd", fd >= 0 && fd_readable(fd) == false );
+
+    // [ _, _, _ ] -> push(A) -> [ A, _, _ ]
+    circular_buffer_push(p_circular_buffer, A_element);
+    print_test(name, "circular_buffer_push_readable", fd_readable(fd) );
+
+    // [ A, _, _ ] -> pop() -> [ _, _, _ ]
+    circular_buffer_pop(p_circular_buffer, &p_value);
+    print_test(name, "circular_buffer_pop_drained", fd_readable(fd) == false );
+
+    // Watermark
+    circular_buffer_set_fd_watermark(p_circular_buffer, 2);
+    circular_buffer_push(p_circular_buffer, A_element);
+    {
+        uint64_t value = 0;
+        print_test(name, "circular_buffer_consume", read(fd, &value, sizeof(value)) == sizeof(value) && fd_readable(fd) == false );
+    }
+    circular_buffer_push(p_circular_buffer, B_element);
+    print_test(name, "circular_buffer_watermark", fd_readable(fd) );
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // [ A, B ] + disk[ C ] -> pop(), pop() -> [ _, _ ] + disk[ C ] -> readable
+    circular_buffer_construct(&p_circular_buffer, 2);
+    fd = circular_buffer_get_fd(p_circular_buffer);
+    circular_buffer_spill_attach(p_circular_buffer, "circular_buffer_event_test.log", pointer_serialize, pointer_deserialize, 0);
+    circular_buffer_push(p_circular_buffer, A_element);
+    circular_buffer_push(p_circular_buffer, B_element);
+    circular_buffer_push(p_circular_buffer, C_element);
+    circular_buffer_pop(p_circular_buffer, &p_value);
+    circular_buffer_pop(p_circular_buffer, &p_value);
+    print_test(name, "circular_buffer_spill_readable", fd_readable(fd) && circular_buffer_spill_count(p_circular_buffer) == 1 );
+
+    // pop() -> C -> readable until the spill log drains
+    print_test(name, "circular_buffer_spill_drained", circular_buffer_pop(p_circular_buffer, &p_value) && p_value == C_element && fd_readable(fd) == false );
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+struct consumer_record_s
+{
+    void   *_p_elements[8];
+    size_t  count, batches, largest;
+};
+
+void record_batch ( void **pp_elements, size_t count, void *p_context )
+{
+    struct consumer_record_s *p_record = p_context;
+    for (size_t i = 0; i < count && p_record->count < 8; i++) p_record->_p_elements[p_record->count++] = pp_elements[i];
+    p_record->batches++;
+    if ( count > p_record->largest ) p_record->largest = count;
+}
+
+int test_consumer ( char *name )
+{
+
+    // Initialized data
+    circular_buffer                  *p_circular_buffer = 0;
+    void                             *_p_values[4]      = { 0 };
+    struct consumer_record_s          _record           = { 0 };
+    circular_buffer_consumer_options  _options          = { .max_batch = 2, .max_linger = timer_seconds_divisor(), .p_context = &_record };
+
+    #ifdef _WIN64
+        return 1;
+    #endif
+
+    log_scenario("%s\n", name);
+
+    // [ A, B, C, _ ] -> pop_batch(4) -> [ _, _, _, _ ]
+    circular_buffer_construct(&p_circular_buffer, 4);
+    circular_buffer_push(p_circular_buffer, A_element);
+    circular_buffer_push(p_circular_buffer, B_element);
+    circular_buffer_push(p_circular_buffer, C_element);
+    print_test(name, "circular_buffer_pop_batch", circular_buffer_pop_batch(p_circular_buffer, _p_values, 4) == 3 && _p_values[0] == A_element && _p_values[2] == C_element && circular_buffer_empty(p_circular_buffer) );
+
+    // Attach a consumer
+    print_test(name, "circular_buffer_attach_consumer", circular_buffer_attach_consumer(p_circular_buffer, record_batch, &_options) );
+    print_test(name, "circular_buffer_attach_consumer_twice", circular_buffer_attach_consumer(p_circular_buffer, record_batch, &_options) == 0 );
+
+    // [ A, B, C, _ ] -> detach() -> [ A, B ] [ C ]
+    circular_buffer_push(p_circular_buffer, A_element);
+    circular_buffer_push(p_circular_buffer, B_element);
+    circular_buffer_push(p_circular_buffer, C_element);
+    print_test(name, "circular_buffer_detach_consumer", circular_buffer_detach_consumer(p_circular_buffer) );
+    print_test(name, "circular_buffer_consumer_order", _record.count == 3 && _record._p_elements[0] == A_element && _record._p_elements[1] == B_element && _record._p_elements[2] == C_element );
+    print_test(name, "circular_buffer_consumer_batch", _record.largest <= 2 && _record.batches >= 2 && circular_buffer_empty(p_circular_buffer) );
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int test_latency ( char *name )
+{
+
+    // Initialized data
+    circular_buffer *p_circular_buffer = 0;
+    void            *p_value           = 0;
+    size_t           count             = 0;
+    timestamp        p50 = 0, p99 = 0, p999 = 0;
+
+    log_scenario("%s\n", name);
+
+    // [ _, _, _, _ ]
+    circular_buffer_construct(&p_circular_buffer, 4);
+
+    #ifdef CIRCULAR_BUFFER_LATENCY
+
+        // Sample every other push
+        print_test(name, "circular_buffer_latency_enable", circular_buffer_latency_enable(p_circular_buffer, 1) );
+        print_test(name, "circular_buffer_latency_percentile_empty", circular_buffer_latency_percentile(p_circular_buffer, 50, &p50) == 0 );
+
+        // [ A, B, C, D ] -> pop() x 4 -> [ _, _, _, _ ]
+        circular_buffer_push(p_circular_buffer, A_element);
+        circular_buffer_push(p_circular_buffer, B_element);
+        circular_buffer_push(p_circular_buffer, C_element);
+        circular_buffer_push(p_circular_buffer, D_element);
+        for (size_t i = 0; i < 4; i++) circular_buffer_pop(p_circular_buffer, &p_value);
+        print_test(name, "circular_buffer_latency_count", circular_buffer_latency_count(p_circular_buffer, &count) && count == 2 );
+
+        // Percentiles are ordered
+        circular_buffer_latency_percentile(p_circular_buffer, 50, &p50);
+        circular_buffer_latency_percentile(p_circular_buffer, 99, &p99);
+        circular_buffer_latency_percentile(p_circular_buffer, 99.9, &p999);
+        print_test(name, "circular_buffer_latency_percentile", p50 >= 0 && p50 <= p99 && p99 <= p999 );
+
+        // Reset
+        circular_buffer_latency_reset(p_circular_buffer);
+        print_test(name, "circular_buffer_latency_reset", circular_buffer_latency_count(p_circular_buffer, &count) && count == 0 );
+    #else
+
+        // Compiled out
+        (void) p_value, (void) count, (void) p99, (void) p999;
+        print_test(name, "circular_buffer_latency_enable", circular_buffer_latency_enable(p_circular_buffer, 1) == 0 );
+        print_test(name, "circular_buffer_latency_percentile", circular_buffer_latency_percentile(p_circular_buffer, 50, &p50) == 0 );
+    #endif
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+#ifndef _WIN64
+void *push_thousand ( void *p_parameter )
+{
+    for (size_t i = 1; i <= 1000; i++) circular_buffer_push(p_parameter, (void *) i);
+    return 0;
+}
+#endif
+
+int test_lock ( char *name )
+{
+
+    // Initialized data
+    circular_buffer *p_circular_buffer = 0;
+    void            *p_value           = 0;
+    size_t           count             = 0,
+                     sum               = 0;
+
+    #ifdef _WIN64
+        return 1;
+    #else
+
+    log_scenario("%s\n", name);
+
+    // Park immediately, spin, then flat combining with fewer slots than threads
+    for (unsigned spin = 0; spin < 3; spin++)
+    {
+
+        // Initialized data
+        pthread_t _threads[4];
+
+        // 4 threads x push(1..1000)
+        if ( spin == 2 ) print_test(name, "circular_buffer_construct_combining", circular_buffer_construct_combining(&p_circular_buffer, 4000, 2) );
+        else             circular_buffer_construct(&p_circular_buffer, 4000);
+        print_test(name, "circular_buffer_set_spin", circular_buffer_set_spin(p_circular_buffer, spin ? CIRCULAR_BUFFER_LOCK_DEFAULT_SPIN : 0) );
+        for (size_t i = 0; i < 4; i++) pthread_create(&_threads[i], 0, push_thousand, p_circular_buffer);
+        for (size_t i = 0; i < 4; i++) pthread_join(_threads[i], 0);
+
+        // Nothing is lost
+        count = 0, sum = 0;
+        while ( circular_buffer_pop(p_circular_buffer, &p_value) ) count++, sum += (size_t) p_value;
+        print_test(name, spin == 2 ? "circular_buffer_push_combining" : spin ? "circular_buffer_push_spin" : "circular_buffer_push_park", count == 4000 && sum == 4 * 500500 );
+
+        // Free the circular buffer
+        circular_buffer_destroy(&p_circular_buffer);
+    }
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+    #endif
+}
+
+int test_size ( char *name )
+{
+
+    // Initialized data
+    circular_buffer *p_circular_buffer = 0;
+    void            *p_value           = 0;
+    bool             bounded           = true;
+
+    log_scenario("%s\n", name);
+
+    // [ _, _, _ ]
+    circular_buffer_construct(&p_circular_buffer, 3);
+    print_test(name, "circular_buffer_capacity", circular_buffer_capacity(p_circular_buffer) == 3 );
+    print_test(name, "circular_buffer_size_empty", circular_buffer_size(p_circular_buffer) == 0 );
+
+    // [ _, _, _ ] -> push(A) -> [ A, _, _ ]
+    circular_buffer_push(p_circular_buffer, A_element);
+    print_test(name, "circular_buffer_size_one", circular_buffer_size(p_circular_buffer) == 1 );
+
+    // [ A, _, _ ] -> push(B) -> push(C) -> push(D) -> [ D, B, C ]
+    circular_buffer_push(p_circular_buffer, B_element);
+    circular_buffer_push(p_circular_buffer, C_element);
+    circular_buffer_push(p_circular_buffer, D_element);
+    print_test(name, "circular_buffer_size_full", circular_buffer_size(p_circular_buffer) == 3 && circular_buffer_full(p_circular_buffer) );
+
+    // [ D, B, C ] -> pop() -> [ D, _, C ]
+    circular_buffer_pop(p_circular_buffer, &p_value);
+    print_test(name, "circular_buffer_size_pop", circular_buffer_size(p_circular_buffer) == 2 && circular_buffer_full(p_circular_buffer) == false );
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Observe a circular buffer while another thread pushes
+    #ifndef _WIN64
+    {
+        pthread_t _thread;
+        circular_buffer_construct(&p_circular_buffer, 64);
+        pthread_create(&_thread, 0, push_thousand, p_circular_buffer);
+        for (size_t i = 0; i < 10000; i++) bounded &= circular_buffer_size(p_circular_buffer) <= 64;
+        pthread_join(_thread, 0);
+        print_test(name, "circular_buffer_size_concurrent", bounded && circular_buffer_full(p_circular_buffer) );
+        circular_buffer_destroy(&p_circular_buffer);
+    }
+    #endif
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int test_at ( char *name )
+{
+
+    // Initialized data
+    circular_buffer *p_circular_buffer = 0;
+    void            *p_value           = 0;
+    void            *_p_values[5]      = { 0 };
+
+    log_scenario("%s\n", name);
+
+    // [ _, _, _ ]
+    circular_buffer_construct(&p_circular_buffer, 3);
+    print_test(name, "circular_buffer_at_empty", circular_buffer_at(p_circular_buffer, 0, &p_value) == 0 && circular_buffer_latest(p_circular_buffer, 0, &p_value) == 0 );
+
+    // [ _, _, _ ] -> push(A) -> push(B) -> push(C) -> push(D) -> [ D, | B, C ]
+    circular_buffer_push(p_circular_buffer, A_element);
+    circular_buffer_push(p_circular_buffer, B_element);
+    circular_buffer_push(p_circular_buffer, C_element);
+    circular_buffer_push(p_circular_buffer, D_element);
+
+    // Oldest first, across the wrap point
+    print_test(name, "circular_buffer_at_oldest", circular_buffer_at(p_circular_buffer, 0, &p_value) && p_value == B_element );
+    print_test(name, "circular_buffer_at_wrap", circular_buffer_at(p_circular_buffer, 2, &p_value) && p_value == D_element );
+    print_test(name, "circular_buffer_at_out_of_bounds", circular_buffer_at(p_circular_buffer, 3, &p_value) == 0 );
+
+    // Newest first
+    print_test(name, "circular_buffer_latest_newest", circular_buffer_latest(p_circular_buffer, 0, &p_value) && p_value == D_element );
+    print_test(name, "circular_buffer_latest_oldest", circular_buffer_latest(p_circular_buffer, 2, &p_value) && p_value == B_element );
+    print_test(name, "circular_buffer_latest_out_of_bounds", circular_buffer_latest(p_circular_buffer, 3, &p_value) == 0 );
+
+    // Ranges are clamped, and nothing is removed
+    print_test(name, "circular_buffer_copy_range", circular_buffer_copy_range(p_circular_buffer, 1, _p_values, 5) == 2 && _p_values[0] == C_element && _p_values[1] == D_element );
+    print_test(name, "circular_buffer_copy_range_out_of_bounds", circular_buffer_copy_range(p_circular_buffer, 3, _p_values, 5) == 0 && circular_buffer_size(p_circular_buffer) == 3 );
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+void record_watermark ( circular_buffer *p_circular_buffer, bool pressure, void *p_context )
+{
+    int *p_crossings = p_context;
+    (void) p_circular_buffer;
+    *p_crossings = *p_crossings * 10 + ( pressure ? 1 : 2 );
+}
+
+int test_watermark ( char *name )
+{
+
+    // Initialized data
+    circular_buffer *p_circular_buffer = 0;
+    void            *p_value           = 0;
+    int              crossings         = 0;
+
+    log_scenario("%s\n", name);
+
+    // [ _, _, _, _ ]
+    circular_buffer_construct(&p_circular_buffer, 4);
+    print_test(name, "circular_buffer_set_watermarks_invalid", circular_buffer_set_watermarks(p_circular_buffer, 3, 3, record_watermark, &crossings) == 0 );
+    print_test(name, "circular_buffer_set_watermarks", circular_buffer_set_watermarks(p_circular_buffer, 3, 1, record_watermark, &crossings) );
+
+    // [ _, _, _, _ ] -> push(A) -> push(B) -> [ A, B, _, _ ]
+    circular_buffer_push(p_circular_buffer, A_element);
+    circular_buffer_push(p_circular_buffer, B_element);
+    print_test(name, "circular_buffer_below_high", crossings == 0 && circular_buffer_under_pressure(p_circular_buffer) == false );
+
+    // [ A, B, _, _ ] -> push(C) -> push(D) -> [ A, B, C, D ]
+    circular_buffer_push(p_circular_buffer, C_element);
+    circular_buffer_push(p_circular_buffer, D_element);
+    print_test(name, "circular_buffer_high", crossings == 1 && circular_buffer_under_pressure(p_circular_buffer) );
+
+    // Hysteresis: [ A, B, C, D ] -> pop() -> pop() -> [ _, _, C, D ]
+    circular_buffer_pop(p_circular_buffer, &p_value);
+    circular_buffer_pop(p_circular_buffer, &p_value);
+    print_test(name, "circular_buffer_hysteresis", crossings == 1 && circular_buffer_under_pressure(p_circular_buffer) );
+
+    // [ _, _, C, D ] -> pop() -> push(A) -> [ A, _, _, D ]
+    circular_buffer_pop(p_circular_buffer, &p_value);
+    circular_buffer_push(p_circular_buffer, A_element);
+    print_test(name, "circular_buffer_low", crossings == 12 && circular_buffer_under_pressure(p_circular_buffer) == false );
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int test_producer ( char *name )
+{
+
+    // Initialized data
+    circular_buffer          *p_circular_buffer = 0;
+    circular_buffer_producer *p_producer        = 0;
+    void                     *_p_values[4]      = { 0 };
+    void                     *_p_batch[]        = { A_element, 0, B_element };
+
+    log_scenario("%s\n", name);
+
+    // push_batch skips null values
+    circular_buffer_construct(&p_circular_buffer, 4);
+    print_test(name, "circular_buffer_push_batch", circular_buffer_push_batch(p_circular_buffer, _p_batch, 3) == 2 && circular_buffer_size(p_circular_buffer) == 2 );
+    circular_buffer_pop_batch(p_circular_buffer, _p_values, 4);
+
+    // stage[ A, B ]
+    print_test(name, "circular_buffer_producer_open", circular_buffer_producer_open(&p_producer, p_circular_buffer, 3, 0) );
+    circular_buffer_producer_push(p_producer, A_element);
+    circular_buffer_producer_push(p_producer, B_element);
+    print_test(name, "circular_buffer_producer_staged", circular_buffer_empty(p_circular_buffer) );
+
+    // stage[ A, B ] -> push(C) -> [ A, B, C, _ ]
+    circular_buffer_producer_push(p_producer, C_element);
+    print_test(name, "circular_buffer_producer_full_stage", circular_buffer_size(p_circular_buffer) == 3 );
+
+    // stage[ D ] -> close() -> [ A, B, C, D ]
+    circular_buffer_producer_push(p_producer, D_element);
+    print_test(name, "circular_buffer_producer_close", circular_buffer_producer_close(&p_producer) && p_producer == 0 );
+    print_test(name, "circular_buffer_producer_order", circular_buffer_pop_batch(p_circular_buffer, _p_values, 4) == 4 && _p_values[0] == A_element && _p_values[3] == D_element );
+
+    // A zero delay bound flushes on the next push
+    circular_buffer_producer_open(&p_producer, p_circular_buffer, 8, 1);
+    circular_buffer_producer_push(p_producer, A_element);
+    circular_buffer_producer_push(p_producer, B_element);
+    print_test(name, "circular_buffer_producer_delay", circular_buffer_size(p_circular_buffer) >= 1 );
+    circular_buffer_producer_close(&p_producer);
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+#ifndef _WIN64
+struct log_lines_s
+{
+    circular_buffer_log *p_log;
+    char                 tag;
+};
+
+void *log_lines ( void *p_parameter )
+{
+    struct log_lines_s *p_lines = p_parameter;
+    for (size_t i = 0; i < 100; i++) circular_buffer_log_printf(p_lines->p_log, "%c%02zu\n", p_lines->tag, i);
+    return 0;
+}
+#endif
+
+int test_log ( char *name )
+{
+
+    #ifndef _WIN64
+
+        // Initialized data
+        circular_buffer_log *p_log       = 0;
+        int                  _output[2]  = { -1, -1 },
+                             _dump[2]    = { -1, -1 };
+        char                 _text[64]   = { 0 };
+        ssize_t              len         = 0;
+
+        log_scenario("%s\n", name);
+
+        // Pipes for the output and the crash dump
+        pipe(_output);
+        pipe(_dump);
+
+        // Open a log that remembers two lines
+        print_test(name, "circular_buffer_log_open", circular_buffer_log_open(&p_log, _output[1], 16, 2) );
+
+        // "A\n" "B\n" "C\n"
+        circular_buffer_log_printf(p_log, "%s\n", "A");
+        circular_buffer_log_printf(p_log, "%c\n", 'B');
+        circular_buffer_log_write(p_log, "C\n", 2);
+
+        // flush() -> "A\nB\nC\n"
+        print_test(name, "circular_buffer_log_flush", circular_buffer_log_flush(p_log) );
+        len = read(_output[0], _text, sizeof(_text) - 1);
+        print_test(name, "circular_buffer_log_output", len == 6 && strncmp(_text, "A\nB\nC\n", 6) == 0 );
+
+        // dump() -> "B\nC\n"
+        print_test(name, "circular_buffer_log_dump", circular_buffer_log_dump(p_log, _dump[1]) == 2 );
+        len = read(_dump[0], _text, sizeof(_text) - 1);
+        print_test(name, "circular_buffer_log_history", len == 4 && strncmp(_text, "B\nC\n", 4) == 0 );
+
+        // A line longer than the circular buffer is dropped whole
+        print_test(name, "circular_buffer_log_drop", circular_buffer_log_write(p_log, "this line does not fit\n", 23) == 0 && circular_buffer_log_dropped(p_log) == 1 );
+
+        // close() writes what is left
+        circular_buffer_log_write(p_log, "D\n", 2);
+        print_test(name, "circular_buffer_log_close", circular_buffer_log_close(&p_log) && p_log == 0 );
+        len = read(_output[0], _text, sizeof(_text) - 1);
+        print_test(name, "circular_buffer_log_close_output", len == 2 && strncmp(_text, "D\n", 2) == 0 );
+
+        // A long line is cut short, but still ends the line
+        {
+
+            // Initialized data
+            char _long[CIRCULAR_BUFFER_LOG_LINE_MAX * 2] = { 0 };
+
+            memset(_long, 'x', sizeof(_long) - 1);
+            circular_buffer_log_open(&p_log, _output[1], 4096, 0);
+            circular_buffer_log_printf(p_log, "%s\n", _long);
+            circular_buffer_log_close(&p_log);
+            len = read(_output[0], _long, sizeof(_long));
+            print_test(name, "circular_buffer_log_truncate", len == CIRCULAR_BUFFER_LOG_LINE_MAX - 1 && _long[len - 2] == 'x' && _long[len - 1] == '\n' );
+        }
+
+        // Each thread logs into its own circular buffer, and keeps its order
+        {
+
+            // Initialized data
+            pthread_t          _threads[2] = { 0 };
+            struct log_lines_s _lines[2]   = { 0 };
+            char               _all[1024]  = { 0 };
+            size_t             _next[2]    = { 0 };
+            bool               ordered     = true;
+
+            circular_buffer_log_open(&p_log, _output[1], 1024, 0);
+            for (size_t i = 0; i < 2; i++) _lines[i] = (struct log_lines_s) { .p_log = p_log, .tag = (char) ( 'a' + i ) };
+            for (size_t i = 0; i < 2; i++) pthread_create(&_threads[i], 0, log_lines, &_lines[i]);
+            for (size_t i = 0; i < 2; i++) pthread_join(_threads[i], 0);
+            circular_buffer_log_close(&p_log);
+            len = read(_output[0], _all, sizeof(_all));
+            for (ssize_t i = 0; i + 4 <= len; i += 4) ordered &= ( (size_t) atoi(&_all[i + 1]) == _next[_all[i] - 'a']++ );
+            print_test(name, "circular_buffer_log_threads", len == 800 && ordered && _next[0] == 100 && _next[1] == 100 );
+        }
+
+        // Close the pipes
+        close(_output[0]), close(_output[1]);
+        close(_dump[0]), close(_dump[1]);
+
+        // Print the final summary
+        print_final_summary();
+    #else
+        (void) name;
+    #endif
+
+    // Success
+    return 1;
+}
+
+int test_coalesce ( char *name )
+{
+
+    // Initialized data
+    circular_buffer *p_circular_buffer = 0;
+    void            *_p_values[4]      = { 0 },
+                    *p_replaced        = X_element;
+
+    log_scenario("%s\n", name);
+
+    // Only coalescing circular buffers take keys
+    circular_buffer_construct(&p_circular_buffer, 4);
+    print_test(name, "circular_buffer_push_keyed_plain", circular_buffer_push_keyed(p_circular_buffer, 1, A_element, (void *) 0) == 0 );
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // push(1, A), push(2, B), push(1, C) -> [ C, B, _, _ ]
+    print_test(name, "circular_buffer_construct_coalescing", circular_buffer_construct_coalescing(&p_circular_buffer, 4) );
+    circular_buffer_push_keyed(p_circular_buffer, 1, A_element, (void *) 0);
+    circular_buffer_push_keyed(p_circular_buffer, 2, B_element, &p_replaced);
+    print_test(name, "circular_buffer_coalesce_new_key", p_replaced == (void *) 0 );
+    circular_buffer_push_keyed(p_circular_buffer, 1, C_element, &p_replaced);
+    print_test(name, "circular_buffer_coalesce_replaced", p_replaced == A_element );
+    print_test(name, "circular_buffer_coalesced", circular_buffer_size(p_circular_buffer) == 2 && circular_buffer_coalesced(p_circular_buffer) == 1 );
+    print_test(name, "circular_buffer_coalesce_order", circular_buffer_pop_batch(p_circular_buffer, _p_values, 4) == 2 && _p_values[0] == C_element && _p_values[1] == B_element );
+
+    // A popped key starts a new element. push(1, A), push(2, B), push(3, C), push(4, D) -> [ A, B, C, D ]
+    circular_buffer_push_keyed(p_circular_buffer, 1, A_element, (void *) 0);
+    circular_buffer_push_keyed(p_circular_buffer, 2, B_element, (void *) 0);
+    circular_buffer_push_keyed(p_circular_buffer, 3, C_element, (void *) 0);
+    circular_buffer_push_keyed(p_circular_buffer, 4, D_element, (void *) 0);
+    print_test(name, "circular_buffer_coalesce_popped_key", circular_buffer_size(p_circular_buffer) == 4 && circular_buffer_coalesced(p_circular_buffer) == 1 );
+
+    // An overwritten key starts a new element. push(5, A) -> [ B, C, D, A ] ; push(1, B) -> [ C, D, A, B ]
+    circular_buffer_push_keyed(p_circular_buffer, 5, A_element, (void *) 0);
+    circular_buffer_push_keyed(p_circular_buffer, 1, B_element, (void *) 0);
+    print_test(name, "circular_buffer_coalesce_overwritten_key", circular_buffer_coalesced(p_circular_buffer) == 1 );
+
+    // push(3, A) -> [ A, D, A, B ] ; push(X) -> [ D, A, B, X ]
+    circular_buffer_push_keyed(p_circular_buffer, 3, A_element, (void *) 0);
+    circular_buffer_push(p_circular_buffer, X_element);
+    print_test(name, "circular_buffer_coalesce_replace", circular_buffer_pop_batch(p_circular_buffer, _p_values, 4) == 4 && _p_values[0] == D_element && _p_values[1] == A_element && _p_values[2] == B_element && _p_values[3] == X_element );
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int test_find ( char *name )
+{
+
+    // Initialized data
+    circular_buffer *p_circular_buffer = 0;
+    size_t           index             = 0;
+
+    log_scenario("%s\n", name);
+
+    // [ A, B, C, D ] -> push(A) -> [ B, C, D, A ]
+    circular_buffer_construct(&p_circular_buffer, 4);
+    circular_buffer_push(p_circular_buffer, A_element);
+    circular_buffer_push(p_circular_buffer, B_element);
+    circular_buffer_push(p_circular_buffer, C_element);
+    circular_buffer_push(p_circular_buffer, D_element);
+    circular_buffer_push(p_circular_buffer, A_element);
+    print_test(name, "circular_buffer_find_wrapped", circular_buffer_find(p_circular_buffer, A_element, &index) && index == 3 );
+    print_test(name, "circular_buffer_find_oldest", circular_buffer_find(p_circular_buffer, B_element, &index) && index == 0 );
+    print_test(name, "circular_buffer_find_missing", circular_buffer_find(p_circular_buffer, X_element, (void *) 0) == 0 );
+
+    // [ B, C, D, A ] -> push(A) -> [ C, D, A, A ]
+    circular_buffer_push(p_circular_buffer, A_element);
+    print_test(name, "circular_buffer_count", circular_buffer_count(p_circular_buffer, A_element) == 2 && circular_buffer_count(p_circular_buffer, B_element) == 0 );
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Long enough to use the vector kernels on both sides of the wrap point
+    circular_buffer_construct(&p_circular_buffer, 1003);
+    for (size_t i = 0; i < 1500; i++) circular_buffer_push(p_circular_buffer, (void *) ( i % 700 + 1 ));
+    print_test(name, "circular_buffer_find_long", circular_buffer_find(p_circular_buffer, (void *) 600, &index) && index == 102 );
+    print_test(name, "circular_buffer_count_long", circular_buffer_count(p_circular_buffer, (void *) 300) == 1 && circular_buffer_count(p_circular_buffer, (void *) 600) == 2 );
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // "abcdef" -> read(3) -> "def" -> write("abca") -> "defabca"
+    circular_buffer_construct_bytes(&p_circular_buffer, 8);
+    circular_buffer_write(p_circular_buffer, "abcdef", 6);
+    circular_buffer_read(p_circular_buffer, (char[3]) { 0 }, 3);
+    circular_buffer_write(p_circular_buffer, "abca", 4);
+    print_test(name, "circular_buffer_bytes_find", circular_buffer_bytes_find(p_circular_buffer, 'b', &index) && index == 4 );
+    print_test(name, "circular_buffer_bytes_count", circular_buffer_bytes_count(p_circular_buffer, 'a') == 2 && circular_buffer_bytes_count(p_circular_buffer, 'z') == 0 );
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int test_samples ( char *name )
+{
+
+    // Initialized data
+    circular_buffer_samples *p_samples  = 0;
+    const float              _floats[]  = { 1, 2, 3, 4, 5, 6 },
+                             _taps[]    = { 0.5f, 0.5f };
+    const int16_t            _shorts[]  = { -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, 32767 };
+    const float             *p_window   = 0;
+    double                   result     = 0,
+                             min        = 0,
+                             max        = 0;
+
+    log_scenario("%s\n", name);
+
+    // An empty window has no statistics
+    print_test(name, "circular_buffer_samples_construct", circular_buffer_samples_construct(&p_samples, CIRCULAR_BUFFER_SAMPLE_FLOAT, 4) );
+    print_test(name, "circular_buffer_samples_empty", circular_buffer_samples_mean(p_samples, 0, &result) == 0 );
+
+    // push(1, 2, 3, 4, 5, 6) -> [ 3, 4, 5, 6 ]
+    circular_buffer_samples_push(p_samples, _floats, 6);
+    print_test(name, "circular_buffer_samples_window", circular_buffer_samples_window(p_samples, 0, (const void **) &p_window) && circular_buffer_samples_count(p_samples) == 4 && p_window[0] == 3 && p_window[3] == 6 );
+    print_test(name, "circular_buffer_samples_mean", circular_buffer_samples_mean(p_samples, 0, &result) && result == 4.5 );
+    print_test(name, "circular_buffer_samples_moving_average", circular_buffer_samples_mean(p_samples, 2, &result) && result == 5.5 );
+    print_test(name, "circular_buffer_samples_rms", circular_buffer_samples_rms(p_samples, 1, &result) && result == 6 );
+    print_test(name, "circular_buffer_samples_min_max", circular_buffer_samples_min_max(p_samples, 0, &min, &max) && min == 3 && max == 6 );
+    print_test(name, "circular_buffer_samples_dot", circular_buffer_samples_dot(p_samples, _taps, 2, &result) && result == 5.5 );
+    print_test(name, "circular_buffer_samples_too_wide", circular_buffer_samples_mean(p_samples, 5, &result) == 0 );
+    circular_buffer_samples_destroy(&p_samples);
+
+    // int16_t sums are exact at full scale
+    circular_buffer_samples_construct(&p_samples, CIRCULAR_BUFFER_SAMPLE_INT16, 16);
+    circular_buffer_samples_push(p_samples, _shorts, 9);
+    print_test(name, "circular_buffer_samples_int16_dot", circular_buffer_samples_dot(p_samples, _shorts, 9, &result) && result == 8.0 * 32768 * 32768 + 32767.0 * 32767 );
+    print_test(name, "circular_buffer_samples_int16_min_max", circular_buffer_samples_min_max(p_samples, 0, &min, &max) && min == -32768 && max == 32767 );
+    circular_buffer_samples_destroy(&p_samples);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+size_t element_size ( const void *p_data, void *p_context )
+{
+    (void) p_context;
+    return (size_t) (uintptr_t) p_data * 3;
+}
+
+void record_eviction ( circular_buffer *p_circular_buffer, void *p_data, size_t size, void *p_context )
+{
+    size_t *p_evicted = p_context;
+    (void) p_circular_buffer;
+    *p_evicted = *p_evicted * 100 + (size_t) (uintptr_t) p_data * 10 + size;
+}
+
+int test_budget ( char *name )
+{
+
+    // Initialized data
+    circular_buffer *p_circular_buffer = 0;
+    void            *p_value           = 0;
+    size_t           evicted           = 0;
+
+    log_scenario("%s\n", name);
+
+    // Only byte budgeted circular buffers take sizes
+    circular_buffer_construct(&p_circular_buffer, 4);
+    print_test(name, "circular_buffer_push_sized_plain", circular_buffer_push_sized(p_circular_buffer, A_element, 1) == 0 );
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // push(A, 4), push(B, 4) -> [ A, B ] -> 8 bytes
+    print_test(name, "circular_buffer_construct_budgeted", circular_buffer_construct_budgeted(&p_circular_buffer, 8, 10, 0, record_eviction, &evicted) );
+    circular_buffer_push_sized(p_circular_buffer, A_element, 4);
+    circular_buffer_push_sized(p_circular_buffer, B_element, 4);
+    print_test(name, "circular_buffer_budget_used", circular_buffer_budget_used(p_circular_buffer) == 8 && evicted == 0 );
+
+    // push(C, 5) -> evict(A) -> [ B, C ] -> 9 bytes
+    circular_buffer_push_sized(p_circular_buffer, C_element, 5);
+    print_test(name, "circular_buffer_budget_evict", circular_buffer_size(p_circular_buffer) == 2 && circular_buffer_budget_used(p_circular_buffer) == 9 && evicted == 14 && circular_buffer_budget_evicted(p_circular_buffer) == 1 );
+
+    // push(D, 11) -> never fits, and evicts nothing
+    print_test(name, "circular_buffer_budget_too_large", circular_buffer_push_sized(p_circular_buffer, D_element, 11) == 0 && circular_buffer_size(p_circular_buffer) == 2 );
+
+    // pop() -> B -> [ C ] -> 5 bytes
+    print_test(name, "circular_buffer_budget_pop", circular_buffer_pop(p_circular_buffer, &p_value) && p_value == B_element && circular_buffer_budget_used(p_circular_buffer) == 5 && evicted == 14 );
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Sizes from the callback, 3 bytes per unit, 2 entries. push(A), push(B) -> [ A, B ] -> 9 bytes
+    evicted = 0;
+    circular_buffer_construct_budgeted(&p_circular_buffer, 2, 100, element_size, record_eviction, &evicted);
+    circular_buffer_push(p_circular_buffer, A_element);
+    circular_buffer_push(p_circular_buffer, B_element);
+    print_test(name, "circular_buffer_budget_size_callback", circular_buffer_budget_used(p_circular_buffer) == 9 );
+
+    // A full circular buffer evicts too. push(C) -> evict(A) -> [ B, C ] -> 15 bytes
+    circular_buffer_push(p_circular_buffer, C_element);
+    print_test(name, "circular_buffer_budget_evict_full", circular_buffer_budget_used(p_circular_buffer) == 15 && evicted == 13 );
+
+    // A budget evicts, so it can not spill. The sizes stay charged. pop(), pop() -> [ ] -> 0 bytes
+    print_test(name, "circular_buffer_budget_spill_attach", circular_buffer_spill_attach(p_circular_buffer, "circular_buffer_budget_test.log", pointer_serialize, pointer_deserialize, 0) == 0 );
+    circular_buffer_push(p_circular_buffer, D_element);
+    circular_buffer_pop(p_circular_buffer, &p_value);
+    circular_buffer_pop(p_circular_buffer, &p_value);
+    print_test(name, "circular_buffer_budget_spill_pop", p_value == D_element && circular_buffer_budget_used(p_circular_buffer) == 0 && circular_buffer_pop(p_circular_buffer, &p_value) == 0 && circular_buffer_budget_used(p_circular_buffer) == 0 );
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+struct executor_test_s
+{
+    circular_buffer_executor *p_executor;
+    size_t                    sum, count;
+};
+
+void sum_task ( void *p_task, void *p_context )
+{
+    struct executor_test_s *p_test = p_context;
+    __atomic_fetch_add(&p_test->sum, (size_t) (uintptr_t) p_task, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&p_test->count, 1, __ATOMIC_RELAXED);
+}
+
+void tree_task ( void *p_task, void *p_context )
+{
+    struct executor_test_s *p_test = p_context;
+    size_t                  depth  = (size_t) (uintptr_t) p_task;
+    __atomic_fetch_add(&p_test->count, 1, __ATOMIC_RELAXED);
+    if ( depth == 1 ) return;
+    circular_buffer_executor_submit(p_test->p_executor, (void *) (uintptr_t) ( depth - 1 ));
+    circular_buffer_executor_submit(p_test->p_executor, (void *) (uintptr_t) ( depth - 1 ));
+}
+
+int test_executor ( char *name )
+{
+
+    // Initialized data
+    struct executor_test_s  _test      = { 0 };
+    void                   *_p_tasks[1000] = { 0 };
+    size_t                  submitted  = 0;
+
+    log_scenario("%s\n", name);
+
+    // submit(1 .. 1000), in batches that may stop short when the injection circular buffer fills
+    print_test(name, "circular_buffer_executor_construct", circular_buffer_executor_construct(&_test.p_executor, 4, 64, sum_task, &_test) );
+    for (size_t i = 0; i < 1000; i++) _p_tasks[i] = (void *) (uintptr_t) ( i + 1 );
+    while ( submitted < 1000 ) submitted += circular_buffer_executor_submit_batch(_test.p_executor, _p_tasks + submitted, 1000 - submitted);
+    print_test(name, "circular_buffer_executor_null_task", circular_buffer_executor_submit(_test.p_executor, (void *) 0) == 0 );
+    print_test(name, "circular_buffer_executor_wait", circular_buffer_executor_wait(_test.p_executor) && _test.sum == 500500 && _test.count == 1000 );
+    print_test(name, "circular_buffer_executor_destroy", circular_buffer_executor_destroy(&_test.p_executor) && _test.p_executor == 0 );
+
+    // Each task submits two subtasks to its own deque, and idle workers steal them
+    _test.count = 0;
+    circular_buffer_executor_construct(&_test.p_executor, 4, 64, tree_task, &_test);
+    circular_buffer_executor_submit(_test.p_executor, (void *) 11);
+    circular_buffer_executor_wait(_test.p_executor);
+    print_test(name, "circular_buffer_executor_subtasks", _test.count == 2047 );
+    circular_buffer_executor_destroy(&_test.p_executor);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int test_drain ( char *name )
+{
+
+    // Initialized data
+    circular_buffer       *p_circular_buffer = 0;
+    circular_buffer_batch  batch             = { 0 };
+    void                  *p_value           = 0;
+
+    log_scenario("%s\n", name);
+
+    // Only plain circular buffers drain
+    circular_buffer_construct_budgeted(&p_circular_buffer, 4, 10, 0, 0, 0);
+    circular_buffer_push_sized(p_circular_buffer, A_element, 1);
+    print_test(name, "circular_buffer_drain_all_features", circular_buffer_drain_all(p_circular_buffer, &batch) == 0 && circular_buffer_size(p_circular_buffer) == 1 );
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // [ ] -> drain_all() -> { }
+    circular_buffer_construct(&p_circular_buffer, 3);
+    print_test(name, "circular_buffer_drain_all_empty", circular_buffer_drain_all(p_circular_buffer, &batch) == 0 && batch.count == 0 && circular_buffer_batch_release(p_circular_buffer, &batch) );
+
+    // [ A, B, C ] -> push(D) -> [ B, C, D ] -> drain_all() -> { B, C, D } -> [ ]
+    circular_buffer_push(p_circular_buffer, A_element);
+    circular_buffer_push(p_circular_buffer, B_element);
+    circular_buffer_push(p_circular_buffer, C_element);
+    circular_buffer_push(p_circular_buffer, D_element);
+    print_test(name, "circular_buffer_drain_all", circular_buffer_drain_all(p_circular_buffer, &batch) == 3 && circular_buffer_empty(p_circular_buffer) );
+    print_test(name, "circular_buffer_batch_at", circular_buffer_batch_at(&batch, 0) == B_element && circular_buffer_batch_at(&batch, 1) == C_element && circular_buffer_batch_at(&batch, 2) == D_element );
+
+    // Producers continue into the spare block. push(A) -> [ A ]
+    circular_buffer_push(p_circular_buffer, A_element);
+    print_test(name, "circular_buffer_drain_all_push", circular_buffer_peek(p_circular_buffer, &p_value) && p_value == A_element && circular_buffer_batch_at(&batch, 0) == B_element );
+
+    // Only one batch can be out at a time
+    {
+        circular_buffer_batch second = { 0 };
+
+        print_test(name, "circular_buffer_drain_all_outstanding", circular_buffer_drain_all(p_circular_buffer, &second) == 0 && circular_buffer_size(p_circular_buffer) == 1 );
+    }
+
+    // release() -> drain_all() -> { A } -> [ ]
+    print_test(name, "circular_buffer_batch_release", circular_buffer_batch_release(p_circular_buffer, &batch) && batch.count == 0 );
+    print_test(name, "circular_buffer_drain_all_again", circular_buffer_drain_all(p_circular_buffer, &batch) == 1 && circular_buffer_batch_at(&batch, 0) == A_element && circular_buffer_empty(p_circular_buffer) );
+    circular_buffer_batch_release(p_circular_buffer, &batch);
+
+    // Free the circular buffer
+    circular_buffer_destroy(&p_circular_buffer);
+
+    // Print the final summary
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
 /*
 int test_two_element_circular_buffer   ( int (*queue_constructor)(queue **), char *name, void **elements )
 {
@@ -0,0 +1,448 @@
+/** !
+ * C++ circular buffer tester
+ *
+ * Runs the scenarios of the C tester against cb::ring and cb::dynamic_ring,
+ * with each synchronization policy
+ *
+ * @file circular_buffer_test.cpp
+ *
+ * @author Jacob Smith
+ */
+
+// Standard library
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// circular buffer module
+#include <circular_buffer/circular_buffer.hpp>
+
+// Possible elements
+void *A_element = (void *)0x1,
+     *B_element = (void *)0x2,
+     *C_element = (void *)0x3,
+     *D_element = (void *)0x4;
+
+// Expected results
+void *_contents    [] = { (void *)0x0 };
+void *A_contents   [] = { (void *)0x1, (void *)0x0 };
+void *B_contents   [] = { (void *)0x2, (void *)0x0 };
+void *AB_contents  [] = { (void *)0x1, (void *)0x2, (void *)0x0 };
+void *ABC_contents [] = { (void *)0x1, (void *)0x2, (void *)0x3, (void *)0x0 };
+void *BCD_contents [] = { (void *)0x2, (void *)0x3, (void *)0x4, (void *)0x0 };
+
+int total_tests  = 0,
+    total_passes = 0,
+    total_fails  = 0;
+
+// Forward declarations
+void print_test          ( const std::string &scenario, const char *test, bool passed );
+void print_final_summary ( void );
+
+template <typename Ring> int test_scenarios ( const char *name, Ring (*construct)( void ) );
+template <typename Ring> int test_contents  ( const std::string &scenario, Ring &ring, void **expected );
+
+int test_move_only ( const char *name );
+int test_segments  ( const char *name );
+int test_dynamic   ( const char *name );
+int test_spsc      ( const char *name );
+int test_mpmc      ( const char *name );
+
+// Constructors
+template <typename Policy> cb::ring<void *, 3, Policy>     construct_ring    ( void ) { return cb::ring<void *, 3, Policy>(); }
+template <typename Policy> cb::dynamic_ring<void *, Policy> construct_dynamic ( void ) { return cb::dynamic_ring<void *, Policy>(3); }
+
+// Entry point
+int main ( int argc, const char* argv[] )
+{
+
+    // Unused
+    (void) argc;
+    (void) argv;
+
+    // Formatting
+    printf(
+        "╭───────────────────────────────╮\n"\
+        "│ C++ circular buffer tester    │\n"\
+        "╰───────────────────────────────╯\n\n"
+    );
+
+    // The scenarios of the C tester, with each policy
+    test_scenarios("ring",                 construct_ring<cb::policy::none>);
+    test_scenarios("ring mutex",           construct_ring<cb::policy::mutex>);
+    test_scenarios("ring mpmc",            construct_ring<cb::policy::mpmc>);
+    test_scenarios("dynamic_ring",         construct_dynamic<cb::policy::none>);
+    test_scenarios("dynamic_ring mutex",   construct_dynamic<cb::policy::mutex>);
+
+    // Storage, types and concurrency
+    test_move_only("move only");
+    test_segments("segments");
+    test_dynamic("dynamic");
+    test_spsc("spsc");
+    test_mpmc("mpmc");
+
+    // Report the results
+    print_final_summary();
+
+    // Done
+    return ( total_fails == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void print_test ( const std::string &scenario, const char *test, bool passed )
+{
+
+    // Print the result
+    printf("%s %s %s\n", scenario.c_str(), test, passed ? "PASS" : "FAIL");
+
+    // Increment the counters
+    passed ? total_passes++ : total_fails++;
+    total_tests++;
+
+    // Done
+    return;
+}
+
+void print_final_summary ( void )
+{
+
+    // Print the totals
+    printf("\nTests: %d, Passed: %d, Failed: %d (%%%.3f)\n", total_tests, total_passes, total_fails, ( (float) total_passes / (float) total_tests * 100.f ));
+
+    // Done
+    return;
+}
+
+template <typename Ring>
+int test_contents ( const std::string &scenario, Ring &ring, void **expected )
+{
+
+    // Initialized data
+    size_t count = 0;
+    bool   match = true;
+
+    // Count the expected elements
+    while ( expected[count] ) count++;
+
+    // Test the accessors
+    print_test(scenario, "empty", ring.empty() == ( count == 0 ));
+    print_test(scenario, "full" , ring.full()  == ( count == ring.capacity() ));
+    print_test(scenario, "size" , ring.size()  == count);
+
+    // Test iteration, oldest first
+    {
+        size_t i = 0;
+
+        for (void *p_element : ring) match &= ( i < count && p_element == expected[i++] );
+
+        print_test(scenario, "iterate", match && i == count);
+    }
+
+    // Test the peek
+    {
+        void *p_element = (void *) 0;
+
+        print_test(scenario, "peek", ( count == 0 ) ? !ring.peek(p_element) : ( ring.peek(p_element) && p_element == expected[0] ));
+    }
+
+    // Success
+    return 1;
+}
+
+template <typename Ring>
+int test_scenarios ( const char *name, Ring (*construct)( void ) )
+{
+
+    // Formatting
+    printf("Scenario: %s\n", name);
+
+    // [ ]
+    {
+        Ring ring = construct();
+
+        test_contents(std::string(name) + " empty", ring, _contents);
+    }
+
+    // [ ] -> push(A) -> [ A ]
+    {
+        Ring ring = construct();
+
+        ring.push(A_element);
+        test_contents(std::string(name) + " empty_pushA_A", ring, A_contents);
+    }
+
+    // [ A ] -> pop() -> [ ]
+    {
+        Ring  ring      = construct();
+        void *p_element = (void *) 0;
+
+        ring.push(A_element);
+        print_test(std::string(name) + " A_pop_empty", "pop", ring.pop(p_element) && p_element == A_element);
+        test_contents(std::string(name) + " A_pop_empty", ring, _contents);
+    }
+
+    // [ A, B ] -> pop() -> [ B ]
+    {
+        Ring  ring      = construct();
+        void *p_element = (void *) 0;
+
+        ring.push(A_element), ring.push(B_element);
+        print_test(std::string(name) + " AB_pop_B", "pop", ring.pop(p_element) && p_element == A_element);
+        test_contents(std::string(name) + " AB_pop_B", ring, B_contents);
+    }
+
+    // [ A ] -> push(B) -> push(C) -> [ A, B, C ]
+    {
+        Ring ring = construct();
+
+        ring.push(A_element), ring.push(B_element), ring.push(C_element);
+        test_contents(std::string(name) + " AB_pushC_ABC", ring, ABC_contents);
+    }
+
+    // [ A, B, C ] -> push(D) -> [ B, C, D ]
+    {
+        Ring ring = construct();
+
+        ring.push(A_element), ring.push(B_element), ring.push(C_element);
+        print_test(std::string(name) + " ABC_pushD_BCD", "push", ring.push(D_element));
+        test_contents(std::string(name) + " ABC_pushD_BCD", ring, BCD_contents);
+    }
+
+    // [ ] -> pop() -> [ ]
+    {
+        Ring ring = construct();
+
+        print_test(std::string(name) + " empty_pop_empty", "pop", !ring.pop().has_value());
+    }
+
+    // [ A, B ] -> clear() -> [ ]
+    {
+        Ring ring = construct();
+
+        ring.push(A_element), ring.push(B_element);
+        ring.clear();
+        test_contents(std::string(name) + " AB_clear_empty", ring, _contents);
+    }
+
+    // [ A, B ] -> move -> [ A, B ]
+    {
+        Ring ring = construct();
+
+        ring.push(A_element), ring.push(B_element);
+
+        Ring moved(std::move(ring));
+
+        test_contents(std::string(name) + " AB_move_AB", moved, AB_contents);
+    }
+
+    // Success
+    return 1;
+}
+
+int test_move_only ( const char *name )
+{
+
+    // Initialized data
+    cb::ring<std::unique_ptr<int>, 4> ring;
+    std::unique_ptr<int>              p_value;
+    std::shared_ptr<int>              p_shared = std::make_shared<int>(0);
+
+    // Formatting
+    printf("Scenario: %s\n", name);
+
+    // Construct in place
+    ring.emplace(new int(1));
+    ring.push(std::make_unique<int>(2));
+    print_test(name, "emplace", ring.size() == 2 && *ring[0] == 1 && *ring[1] == 2);
+
+    // Move out
+    print_test(name, "pop", ring.pop(p_value) && *p_value == 1);
+    print_test(name, "pop optional", *ring.pop().value() == 2);
+
+    // Overwritten and remaining values are destroyed
+    {
+        cb::ring<std::shared_ptr<int>, 2> shared;
+
+        shared.push(p_shared), shared.push(p_shared), shared.push(p_shared);
+        print_test(name, "overwrite destroys", p_shared.use_count() == 3);
+    }
+    print_test(name, "destructor destroys", p_shared.use_count() == 1);
+
+    // Success
+    return 1;
+}
+
+int test_segments ( const char *name )
+{
+
+    // Initialized data
+    cb::ring<int, 4> ring;
+    int              sum = 0;
+
+    // Formatting
+    printf("Scenario: %s\n", name);
+
+    // [ 0, 1, 2 ]
+    for (int i = 0; i < 3; i++) ring.push(i);
+
+    {
+        auto [first, second] = ring.segments();
+
+        print_test(name, "contiguous", first.size() == 3 && second.empty() && first[0] == 0 && first[2] == 2);
+    }
+
+    // [ 4, _, 2, 3 ], oldest first [ 2, 3, 4 ]
+    ring.pop(), ring.pop();
+    ring.push(3), ring.push(4);
+
+    {
+        auto [first, second] = ring.segments();
+
+        print_test(name, "wrapped", first.size() == 2 && second.size() == 1 && first[0] == 2 && first[1] == 3 && second[0] == 4);
+
+        for (int value : first)  sum += value;
+        for (int value : second) sum += value;
+        print_test(name, "span iterate", sum == 9);
+    }
+
+    // Iteration crosses the wrap point
+    sum = 0;
+    for (int value : ring) sum = sum * 10 + value;
+    print_test(name, "iterate wrapped", sum == 234);
+
+    // Power of two capacities mask, others take the remainder
+    print_test(name, "static mask", cb::ring<int, 4>().capacity() == 4 && cb::ring<int, 5>().capacity() == 5);
+
+    // Success
+    return 1;
+}
+
+int test_dynamic ( const char *name )
+{
+
+    // Formatting
+    printf("Scenario: %s\n", name);
+
+    // Each capacity, masked or not, wraps in order
+    for (size_t capacity : { 1, 2, 5, 8 })
+    {
+
+        // Initialized data
+        cb::dynamic_ring<size_t> ring(capacity);
+        bool                     match = true;
+
+        // Push twice the capacity, keeping the newest
+        for (size_t i = 0; i < capacity * 2; i++) ring.push(i);
+
+        for (size_t i = capacity; i < capacity * 2; i++) match &= ( ring.pop().value_or(~i) == i );
+
+        print_test(name + std::string(" capacity ") + std::to_string(capacity), "wrap", match && ring.empty());
+    }
+
+    // A ring needs at least one slot
+    {
+        bool thrown = false;
+
+        try { cb::dynamic_ring<int> ring(0); }
+        catch ( const std::invalid_argument & ) { thrown = true; }
+
+        print_test(name, "zero capacity", thrown);
+    }
+
+    // A moved from ring is empty, and refuses pushes
+    {
+        cb::dynamic_ring<int> ring(4);
+
+        ring.push(1), ring.push(2);
+
+        cb::dynamic_ring<int> moved(std::move(ring));
+        auto [first, second] = ring.segments();
+
+        print_test(name, "moved from", ring.empty() && ring.capacity() == 0 && !ring.push(3) && !ring.pop().has_value() && ring.begin() == ring.end() && first.empty() && second.empty());
+        print_test(name, "moved to", moved.size() == 2 && moved.pop().value() == 1 && moved.push(3) && moved.size() == 2);
+    }
+
+    // Success
+    return 1;
+}
+
+int test_spsc ( const char *name )
+{
+
+    // Initialized data
+    cb::ring<size_t, 64, cb::policy::spsc> ring;
+    const size_t                           count    = 100000;
+    size_t                                 expected = 0;
+    bool                                   ordered  = true;
+
+    // Formatting
+    printf("Scenario: %s\n", name);
+
+    // A full circular buffer refuses the push
+    {
+        cb::ring<int, 2, cb::policy::spsc> small;
+
+        small.push(1), small.push(2);
+        print_test(name, "full push fails", !small.push(3) && small.pop().value() == 1);
+    }
+
+    // One producer and one consumer. Each yields on a full or empty ring, so
+    // the test also finishes quickly on a single processor.
+    std::thread producer([&ring, count]( void ) { for (size_t i = 0; i < count; ) if ( ring.push(i) ) i++; else std::this_thread::yield(); });
+
+    // A third thread watches the size while both ends move
+    std::atomic<bool> done    { false };
+    bool              bounded = true;
+    std::thread       observer([&]( void ) { while ( !done.load() ) bounded &= ( ring.size() <= ring.capacity() ); });
+
+    while ( expected < count )
+    {
+        std::optional<size_t> value = ring.pop();
+
+        if ( !value ) { std::this_thread::yield(); continue; }
+
+        ordered &= ( *value == expected++ );
+    }
+
+    producer.join();
+    done = true;
+    observer.join();
+
+    print_test(name, "in order", ordered && ring.empty());
+    print_test(name, "concurrent size", bounded);
+
+    // Success
+    return 1;
+}
+
+int test_mpmc ( const char *name )
+{
+
+    // Initialized data
+    cb::dynamic_ring<size_t, cb::policy::mpmc> ring(4096);
+    std::vector<std::thread>                   threads;
+    std::atomic<size_t>                        popped { 0 },
+                                               sum    { 0 };
+
+    // Formatting
+    printf("Scenario: %s\n", name);
+
+    // Four producers and four consumers. The capacity holds every value, so
+    // none are overwritten.
+    for (size_t t = 0; t < 4; t++)
+        threads.emplace_back([&ring]( void ) { for (size_t i = 1; i <= 1000; i++) ring.push(i); });
+
+    for (size_t t = 0; t < 4; t++)
+        threads.emplace_back([&]( void ) { while ( popped.load() < 4000 ) if ( auto value = ring.pop() ) sum += *value, popped++; else std::this_thread::yield(); });
+
+    for (std::thread &thread : threads) thread.join();
+
+    // Every value is popped exactly once
+    print_test(name, "sum", popped == 4000 && sum == 4 * 1000 * 1001 / 2 && ring.empty());
+
+    // Success
+    return 1;
+}
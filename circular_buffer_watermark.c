@@ -0,0 +1,99 @@
+/** !
+ * Circular buffer watermark implementation
+ *
+ * @file circular_buffer_watermark.c
+ *
+ * @author Jacob Smith
+ */
+
+// Header
+#include <circular_buffer/watermark.h>
+
+// Internal
+#include "circular_buffer_internal.h"
+
+// Function definitions
+int circular_buffer_set_watermarks ( circular_buffer *const p_circular_buffer, size_t high, size_t low, fn_circular_buffer_watermark *pfn_watermark, void *p_context )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+	if ( high > p_circular_buffer->length ) goto high_too_large;
+	if ( high && low >= high ) goto low_too_large;
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Store the watermarks
+	p_circular_buffer->_high_watermark      = high;
+	p_circular_buffer->_low_watermark       = low;
+	p_circular_buffer->_pfn_watermark       = pfn_watermark;
+	p_circular_buffer->_p_watermark_context = p_context;
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->_pressure, false);
+
+	// Enable or disable the check
+	if ( high ) p_circular_buffer->features |=  CIRCULAR_BUFFER_FEATURE_WATERMARK;
+	else        p_circular_buffer->features &= ~CIRCULAR_BUFFER_FEATURE_WATERMARK;
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return 1;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			high_too_large:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"high\" exceeds the size of the circular buffer in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+
+			low_too_large:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Parameter \"low\" must be less than parameter \"high\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return 0;
+		}
+	}
+}
+
+bool circular_buffer_under_pressure ( circular_buffer *const p_circular_buffer )
+{
+
+	// Argument check
+	if ( p_circular_buffer == (void *) 0 ) goto no_circular_buffer;
+
+	// Success
+	return CIRCULAR_BUFFER_LOAD(p_circular_buffer->_pressure);
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			no_circular_buffer:
+				#ifndef NDEBUG
+					log_error("[circular buffer] Null pointer provided for parameter \"p_circular_buffer\" in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return false;
+		}
+	}
+}
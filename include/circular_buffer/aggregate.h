@@ -0,0 +1,164 @@
+/** !
+ * Include header for circular buffer sliding window aggregates
+ *
+ * @file circular_buffer/aggregate.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Forward declarations
+struct circular_buffer_aggregate_s;
+struct circular_buffer_combiner_s;
+
+// Type definitions
+/** !
+ *  @brief The type definition of a circular buffer aggregate struct
+ */
+typedef struct circular_buffer_aggregate_s circular_buffer_aggregate;
+
+/** !
+ *  @brief The type definition of an invertible combiner struct
+ */
+typedef struct circular_buffer_combiner_s circular_buffer_combiner;
+
+/** !
+ *  @brief The type definition of a function that maps an element to its value
+ */
+typedef double (fn_circular_buffer_value)( void *p_element );
+
+// Structure definitions
+struct circular_buffer_combiner_s
+{
+	double identity;
+	double (*pfn_combine)( double accumulator, double value );
+	double (*pfn_retract)( double accumulator, double value );
+};
+
+// Constructors
+/** !
+ *  Construct a sliding window aggregate over a circular buffer with a specific number of entries.
+ *  Sum, mean, min and max are maintained in O(1) amortized time per push and eviction.
+ *
+ * @param pp_circular_buffer_aggregate return
+ * @param size                         the maximum quantity of elements in the window
+ * @param pfn_value                    maps an element to its value, or null to use the pointer as an integer
+ * @param p_combiner                   optional user defined invertible combiner, or null
+ *
+ * @sa circular_buffer_aggregate_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_aggregate_construct ( circular_buffer_aggregate **const pp_circular_buffer_aggregate, size_t size, fn_circular_buffer_value *pfn_value, const circular_buffer_combiner *p_combiner );
+
+// Accessors
+/** !
+ *  Get the quantity of elements in the window
+ *
+ * @param p_circular_buffer_aggregate the circular buffer aggregate
+ * @param p_count                     result
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_aggregate_count ( circular_buffer_aggregate *const p_circular_buffer_aggregate, size_t *p_count );
+
+/** !
+ *  Get the sum of the values in the window
+ *
+ * @param p_circular_buffer_aggregate the circular buffer aggregate
+ * @param p_result                    result
+ *
+ * @sa circular_buffer_aggregate_mean
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_aggregate_sum ( circular_buffer_aggregate *const p_circular_buffer_aggregate, double *p_result );
+
+/** !
+ *  Get the mean of the values in the window
+ *
+ * @param p_circular_buffer_aggregate the circular buffer aggregate
+ * @param p_result                    result
+ *
+ * @sa circular_buffer_aggregate_sum
+ *
+ * @return 1 on success, 0 if the window is empty or on error
+ */
+DLLEXPORT int circular_buffer_aggregate_mean ( circular_buffer_aggregate *const p_circular_buffer_aggregate, double *p_result );
+
+/** !
+ *  Get the smallest value in the window
+ *
+ * @param p_circular_buffer_aggregate the circular buffer aggregate
+ * @param p_result                    result
+ *
+ * @sa circular_buffer_aggregate_max
+ *
+ * @return 1 on success, 0 if the window is empty or on error
+ */
+DLLEXPORT int circular_buffer_aggregate_min ( circular_buffer_aggregate *const p_circular_buffer_aggregate, double *p_result );
+
+/** !
+ *  Get the largest value in the window
+ *
+ * @param p_circular_buffer_aggregate the circular buffer aggregate
+ * @param p_result                    result
+ *
+ * @sa circular_buffer_aggregate_min
+ *
+ * @return 1 on success, 0 if the window is empty or on error
+ */
+DLLEXPORT int circular_buffer_aggregate_max ( circular_buffer_aggregate *const p_circular_buffer_aggregate, double *p_result );
+
+/** !
+ *  Get the value of the user defined combiner over the window
+ *
+ * @param p_circular_buffer_aggregate the circular buffer aggregate
+ * @param p_result                    result
+ *
+ * @return 1 on success, 0 if there is no combiner or on error
+ */
+DLLEXPORT int circular_buffer_aggregate_custom ( circular_buffer_aggregate *const p_circular_buffer_aggregate, double *p_result );
+
+// Mutators
+/** !
+ * Add an element to the window. If the window is full, the contribution
+ * of the oldest element is retracted before it is overwritten.
+ *
+ * @param p_circular_buffer_aggregate the circular buffer aggregate
+ * @param p_element                   the element
+ *
+ * @sa circular_buffer_aggregate_pop
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_aggregate_push ( circular_buffer_aggregate *const p_circular_buffer_aggregate, void *p_element );
+
+/** !
+ * Remove the oldest element from the window
+ *
+ * @param p_circular_buffer_aggregate the circular buffer aggregate
+ * @param pp_element                  result
+ *
+ * @sa circular_buffer_aggregate_push
+ *
+ * @return 1 on success, 0 if the window is empty or on error
+ */
+DLLEXPORT int circular_buffer_aggregate_pop ( circular_buffer_aggregate *const p_circular_buffer_aggregate, void **pp_element );
+
+// Destructors
+/** !
+ *  Destroy and deallocate a circular buffer aggregate
+ *
+ * @param pp_circular_buffer_aggregate pointer to the circular buffer aggregate
+ *
+ * @sa circular_buffer_aggregate_construct
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_aggregate_destroy ( circular_buffer_aggregate **const pp_circular_buffer_aggregate );
@@ -0,0 +1,120 @@
+/** !
+ * Include header for circular buffer atomics
+ *
+ * GCC and Clang use the __atomic builtins. MSVC uses the Interlocked
+ * intrinsics, which are full barriers, so they are at least as strong as
+ * the order each operation asks for. Relaxed loads and stores are volatile
+ * accesses under MSVC, which are single instructions for aligned scalars
+ * no wider than a pointer. They need __typeof__, from Visual Studio 2022
+ * 17.9.
+ *
+ * @file circular_buffer/atomic.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// Standard library
+#include <stdbool.h>
+
+// Compiler dependent includes
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+// Compiler dependent macros
+#if defined(_MSC_VER) && ( defined(_M_X64) || defined(_M_IX86) )
+	#define CIRCULAR_BUFFER_PAUSE() _mm_pause()
+#elif defined(_MSC_VER) && ( defined(_M_ARM64) || defined(_M_ARM) )
+	#define CIRCULAR_BUFFER_PAUSE() __yield()
+#elif defined(__x86_64__) || defined(__i386__)
+	#define CIRCULAR_BUFFER_PAUSE() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+	#define CIRCULAR_BUFFER_PAUSE() __asm__ __volatile__ ( "yield" ::: "memory" )
+#else
+	#define CIRCULAR_BUFFER_PAUSE() ( (void) 0 )
+#endif
+
+// Relaxed atomic access to a scalar
+#ifdef _MSC_VER
+	#define CIRCULAR_BUFFER_LOAD(x)     ( *(volatile __typeof__(x) *) &(x) )
+	#define CIRCULAR_BUFFER_STORE(x, v) ( (void) ( *(volatile __typeof__(x) *) &(x) = (v) ) )
+#else
+	#define CIRCULAR_BUFFER_LOAD(x)     __atomic_load_n(&(x), __ATOMIC_RELAXED)
+	#define CIRCULAR_BUFFER_STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+#endif
+
+// Function definitions
+/** !
+ * Atomically replace a value with desired if it equals expected, with
+ * acquire order on success
+ *
+ * @param p_value  the value
+ * @param expected the value to compare against
+ * @param desired  the value to store
+ *
+ * @return true if the value was replaced, else false
+ */
+static inline bool circular_buffer_atomic_compare_exchange_acquire ( unsigned *const p_value, unsigned expected, unsigned desired )
+{
+
+	#ifdef _MSC_VER
+
+		// Success
+		return (unsigned) _InterlockedCompareExchange((volatile long *) p_value, (long) desired, (long) expected) == expected;
+	#else
+
+		// Success
+		return __atomic_compare_exchange_n(p_value, &expected, desired, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+	#endif
+}
+
+/** !
+ * Atomically replace a value, with acquire order
+ *
+ * @param p_value the value
+ * @param desired the value to store
+ *
+ * @sa circular_buffer_atomic_exchange_release
+ *
+ * @return the previous value
+ */
+static inline unsigned circular_buffer_atomic_exchange_acquire ( unsigned *const p_value, unsigned desired )
+{
+
+	#ifdef _MSC_VER
+
+		// Success
+		return (unsigned) _InterlockedExchange((volatile long *) p_value, (long) desired);
+	#else
+
+		// Success
+		return __atomic_exchange_n(p_value, desired, __ATOMIC_ACQUIRE);
+	#endif
+}
+
+/** !
+ * Atomically replace a value, with release order
+ *
+ * @param p_value the value
+ * @param desired the value to store
+ *
+ * @sa circular_buffer_atomic_exchange_acquire
+ *
+ * @return the previous value
+ */
+static inline unsigned circular_buffer_atomic_exchange_release ( unsigned *const p_value, unsigned desired )
+{
+
+	#ifdef _MSC_VER
+
+		// Success
+		return (unsigned) _InterlockedExchange((volatile long *) p_value, (long) desired);
+	#else
+
+		// Success
+		return __atomic_exchange_n(p_value, desired, __ATOMIC_RELEASE);
+	#endif
+}
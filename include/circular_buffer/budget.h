@@ -0,0 +1,93 @@
+/** !
+ * Include header for byte budgeted circular buffers
+ *
+ * A byte budgeted circular buffer is bounded by the total size of its
+ * elements as well as by their quantity. Each element carries a size in
+ * bytes, given at push time or by a size callback. A push evicts the oldest
+ * elements until the new element fits under the budget, so elements of very
+ * different sizes share one memory bound. The running total is updated as
+ * elements enter and leave, and costs one addition per element.
+ *
+ * Evicted elements are passed to an eviction callback, so the caller can
+ * free them. Elements removed by pop, pop batch and expiry are not evicted;
+ * they are handed back to the caller as usual. A byte budgeted circular
+ * buffer can not also have a spill log.
+ *
+ * @file circular_buffer/budget.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Type definitions
+/** !
+ *  @brief The type definition of a function that returns the size of an
+ *         element in bytes
+ */
+typedef size_t (fn_circular_buffer_size)( const void *p_data, void *p_context );
+
+/** !
+ *  @brief The type definition of a function called with each evicted
+ *         element. It runs with the lock held, so it must not call into the
+ *         same circular buffer.
+ */
+typedef void (fn_circular_buffer_evict)( circular_buffer *p_circular_buffer, void *p_data, size_t size, void *p_context );
+
+// Constructors
+/** !
+ *  Construct a circular buffer bounded by a byte budget
+ *
+ * @param pp_circular_buffer return
+ * @param size               the maximum quantity of elements
+ * @param budget             the maximum total size of the elements in bytes
+ * @param pfn_size           returns the size of an element pushed with circular_buffer_push, or null
+ *                           to charge those elements nothing
+ * @param pfn_evict          called with each evicted element, or null
+ * @param p_context          passed to pfn_size and pfn_evict
+ *
+ * @sa circular_buffer_push_sized
+ * @sa circular_buffer_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_construct_budgeted ( circular_buffer **const pp_circular_buffer, size_t size, size_t budget, fn_circular_buffer_size *pfn_size, fn_circular_buffer_evict *pfn_evict, void *p_context );
+
+// Accessors
+/** !
+ *  Get the total size of the elements in a byte budgeted circular buffer,
+ *  without taking the lock
+ *
+ * @param p_circular_buffer the byte budgeted circular buffer
+ *
+ * @return the total size in bytes, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_budget_used ( circular_buffer *const p_circular_buffer );
+
+/** !
+ *  Get the quantity of elements evicted to make room for a push
+ *
+ * @param p_circular_buffer the byte budgeted circular buffer
+ *
+ * @return the quantity of evicted elements, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_budget_evicted ( circular_buffer *const p_circular_buffer );
+
+// Mutators
+/** !
+ *  Push an element with an explicit size, evicting the oldest elements
+ *  until it fits
+ *
+ * @param p_circular_buffer the byte budgeted circular buffer
+ * @param p_data            the element
+ * @param size              the size of the element in bytes. Must not exceed the budget.
+ *
+ * @sa circular_buffer_push
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_push_sized ( circular_buffer *const p_circular_buffer, void *p_data, size_t size );
@@ -0,0 +1,160 @@
+/** !
+ * Include header for byte circular buffers
+ *
+ * A byte circular buffer stores raw bytes instead of pointers. Unlike a
+ * pointer circular buffer, writes never overwrite unread data; they are
+ * truncated to the free space instead.
+ *
+ * @file circular_buffer/bytes.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Platform dependent includes
+#ifndef _WIN64
+	#include <sys/types.h>
+#endif
+
+// Constructors
+/** !
+ *  Construct a byte circular buffer
+ *
+ * @param pp_circular_buffer return
+ * @param size               the capacity in bytes
+ *
+ * @sa circular_buffer_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_construct_bytes ( circular_buffer **const pp_circular_buffer, size_t size );
+
+// Accessors
+/** !
+ *  Get the quantity of unread bytes in a byte circular buffer
+ *
+ * @param p_circular_buffer the byte circular buffer
+ *
+ * @sa circular_buffer_bytes_free
+ *
+ * @return the quantity of unread bytes, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_bytes_used ( circular_buffer *const p_circular_buffer );
+
+/** !
+ *  Get the quantity of free bytes in a byte circular buffer
+ *
+ * @param p_circular_buffer the byte circular buffer
+ *
+ * @sa circular_buffer_bytes_used
+ *
+ * @return the quantity of free bytes, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_bytes_free ( circular_buffer *const p_circular_buffer );
+
+/** !
+ *  Find the oldest unread occurrence of a byte, without reading anything
+ *
+ * @param p_circular_buffer the byte circular buffer
+ * @param value             the byte
+ * @param p_index           result. The position of the byte, where 0 is the oldest unread byte. May be null.
+ *
+ * @sa circular_buffer_bytes_count
+ *
+ * @return 1 if the byte is unread, 0 if not or on error
+ */
+DLLEXPORT int circular_buffer_bytes_find ( circular_buffer *const p_circular_buffer, unsigned char value, size_t *p_index );
+
+/** !
+ *  Count the unread occurrences of a byte, without reading anything
+ *
+ * @param p_circular_buffer the byte circular buffer
+ * @param value             the byte
+ *
+ * @sa circular_buffer_bytes_find
+ *
+ * @return the quantity of occurrences, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_bytes_count ( circular_buffer *const p_circular_buffer, unsigned char value );
+
+// Mutators
+/** !
+ * Copy bytes into a byte circular buffer
+ *
+ * @param p_circular_buffer the byte circular buffer
+ * @param p_data            the bytes
+ * @param size              the quantity of bytes
+ *
+ * @sa circular_buffer_read
+ *
+ * @return the quantity of bytes written, which is less than size if the buffer fills
+ */
+DLLEXPORT size_t circular_buffer_write ( circular_buffer *const p_circular_buffer, const void *p_data, size_t size );
+
+/** !
+ * Copy bytes into a byte circular buffer only if they all fit, so that
+ * concurrent writers never interleave partial records
+ *
+ * @param p_circular_buffer the byte circular buffer
+ * @param p_data            the bytes
+ * @param size              the quantity of bytes
+ *
+ * @sa circular_buffer_write
+ *
+ * @return 1 if every byte was written, 0 if they do not fit or on error
+ */
+DLLEXPORT int circular_buffer_write_all ( circular_buffer *const p_circular_buffer, const void *p_data, size_t size );
+
+/** !
+ * Copy bytes out of a byte circular buffer
+ *
+ * @param p_circular_buffer the byte circular buffer
+ * @param p_data            result
+ * @param size              the maximum quantity of bytes
+ *
+ * @sa circular_buffer_write
+ *
+ * @return the quantity of bytes read
+ */
+DLLEXPORT size_t circular_buffer_read ( circular_buffer *const p_circular_buffer, void *p_data, size_t size );
+
+#ifndef _WIN64
+
+/** !
+ * Fill a byte circular buffer from a file descriptor with one readv call
+ * over the free space on both sides of the wrap point. The lock is not
+ * held during the system call, so at most one thread may fill a given
+ * buffer at a time. Draining concurrently is safe.
+ *
+ * @param p_circular_buffer the byte circular buffer
+ * @param fd                the file descriptor
+ * @param max               the maximum quantity of bytes to read
+ *
+ * @sa circular_buffer_write_fd
+ *
+ * @return the quantity of bytes read, 0 on end of file, -1 on error with errno set, which is ENOBUFS if the buffer is full
+ */
+DLLEXPORT ssize_t circular_buffer_read_fd ( circular_buffer *const p_circular_buffer, int fd, size_t max );
+
+/** !
+ * Drain a byte circular buffer to a file descriptor with one writev call
+ * over the unread bytes on both sides of the wrap point. The lock is not
+ * held during the system call, so at most one thread may drain a given
+ * buffer at a time. Filling concurrently is safe.
+ *
+ * @param p_circular_buffer the byte circular buffer
+ * @param fd                the file descriptor
+ * @param max               the maximum quantity of bytes to write
+ *
+ * @sa circular_buffer_read_fd
+ *
+ * @return the quantity of bytes written, 0 if the buffer is empty, -1 on error with errno set
+ */
+DLLEXPORT ssize_t circular_buffer_write_fd ( circular_buffer *const p_circular_buffer, int fd, size_t max );
+
+#endif
@@ -25,19 +25,65 @@
 #define DLLEXPORT
 #endif
 
+// circular buffer atomics
+#include <circular_buffer/atomic.h>
+
+// circular buffer lock
+#include <circular_buffer/lock.h>
+
 // Memory management macro
 #ifndef CIRCULAR_BUFFER_REALLOC
 #define CIRCULAR_BUFFER_REALLOC(p, sz) realloc(p,sz)
 #endif
 
+// The read index, the write index and the full flag are only written
+// under the lock, but observers read them without it, so both go through
+// CIRCULAR_BUFFER_LOAD and CIRCULAR_BUFFER_STORE from circular_buffer/atomic.h
+
+// Bytes of storage for a circular buffer with a specific number of entries
+#define CIRCULAR_BUFFER_STORAGE_SIZE(size) ( (size_t) (size) * sizeof(void *) )
+
+// Feature flags. Any set flag routes inline operations to the library.
+#define CIRCULAR_BUFFER_FEATURE_TIMED     0x1
+#define CIRCULAR_BUFFER_FEATURE_BYTES     0x2
+#define CIRCULAR_BUFFER_FEATURE_SPILL     0x4
+#define CIRCULAR_BUFFER_FEATURE_EVENT     0x8
+#define CIRCULAR_BUFFER_FEATURE_CONSUMER  0x10
+#define CIRCULAR_BUFFER_FEATURE_LATENCY   0x20
+#define CIRCULAR_BUFFER_FEATURE_COMBINING 0x40
+#define CIRCULAR_BUFFER_FEATURE_WATERMARK 0x80
+#define CIRCULAR_BUFFER_FEATURE_COALESCE  0x100
+#define CIRCULAR_BUFFER_FEATURE_BUDGET    0x200
+
 // Forward declarations
+struct circular_buffer_spill_s;
+struct circular_buffer_consumer_s;
+struct circular_buffer_latency_s;
+struct circular_buffer_combining_s;
+struct circular_buffer_coalesce_s;
+struct circular_buffer_budget_s;
+
 // Structure definitions
 struct circular_buffer_s
 {
-	bool full;
+	bool full, allocated;
+	unsigned features;
 	size_t read, write, length;
-	mutex _lock;
-	void *_p_data[];
+	timestamp ttl, *_p_timestamps;
+	struct circular_buffer_spill_s *_p_spill;
+	int _event_fd;
+	size_t _event_watermark;
+	struct circular_buffer_consumer_s *_p_consumer;
+	struct circular_buffer_latency_s *_p_latency;
+	struct circular_buffer_combining_s *_p_combining;
+	struct circular_buffer_coalesce_s *_p_coalesce;
+	struct circular_buffer_budget_s *_p_budget;
+	size_t _high_watermark, _low_watermark;
+	bool _pressure;
+	void (*_pfn_watermark)( struct circular_buffer_s *p_circular_buffer, bool pressure, void *p_context );
+	void *_p_watermark_context;
+	circular_buffer_lock _lock;
+	void **_p_data, **_p_spare, **_p_drain;
 };
 
 // Type definitions
@@ -60,6 +106,27 @@ typedef struct circular_buffer_s circular_buffer;
  */
 DLLEXPORT int circular_buffer_construct ( circular_buffer **const pp_circular_buffer, size_t size );
 
+/** !
+ *  Initialize a circular buffer in caller provided memory. Nothing is allocated,
+ *  so circular buffers can live in static memory, on the stack, or inside other
+ *  structs. The storage is zeroed here, so the hot path never takes a first touch
+ *  page fault. circular_buffer_destroy releases the lock but not the memory.
+ *
+ *  static circular_buffer ring;
+ *  static void           *ring_storage[64];
+ *  circular_buffer_init(&ring, ring_storage, 64);
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param p_storage         at least CIRCULAR_BUFFER_STORAGE_SIZE(size) bytes, aligned for void *
+ * @param size              the maximum quantity of elements
+ *
+ * @sa circular_buffer_construct
+ * @sa circular_buffer_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_init ( circular_buffer *const p_circular_buffer, void *const p_storage, size_t size );
+
 /** !
  * TODO:
  *  Construct a circular buffer from a void pointer array
@@ -75,9 +142,30 @@ DLLEXPORT int circular_buffer_construct ( circular_buffer **const pp_circular_bu
  */
 DLLEXPORT int circular_buffer_from_contents ( circular_buffer **const pp_circular_buffer, const void *const *pp_contents, size_t size );
 
+/** !
+ *  Construct a time windowed circular buffer. Each push records a monotonic
+ *  timestamp, and entries older than ttl are lazily discarded by reads and
+ *  by circular_buffer_expire.
+ *
+ * @param pp_circular_buffer return
+ * @param size               the maximum quantity of elements
+ * @param ttl                the lifetime of an element, in timer_high_precision units.
+ *                           Use timer_seconds_divisor to convert from seconds.
+ *
+ * @sa circular_buffer_construct
+ * @sa circular_buffer_expire
+ * @sa circular_buffer_count_since
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_construct_timed ( circular_buffer **const pp_circular_buffer, size_t size, timestamp ttl );
+
 // Accessors
 /** !
- *  Check if a circular buffer is empty
+ *  Check if a circular buffer is empty, without taking the lock. The
+ *  result is approximate while other threads push or pop. Elements in the
+ *  spill log count, so a circular buffer with spilled elements is not
+ *  empty.
  *
  * @param p_circular_buffer the circular buffer
  *
@@ -88,7 +176,8 @@ DLLEXPORT int circular_buffer_from_contents ( circular_buffer **const pp_circula
 DLLEXPORT bool circular_buffer_empty ( circular_buffer *const p_circular_buffer );
 
 /** !
- *  Check if a circular buffer is full
+ *  Check if a circular buffer is full, without taking the lock. The
+ *  result is approximate while other threads push or pop.
  *
  * @param p_circular_buffer the circular buffer
  *
@@ -98,7 +187,61 @@ DLLEXPORT bool circular_buffer_empty ( circular_buffer *const p_circular_buffer
  */
 DLLEXPORT bool circular_buffer_full ( circular_buffer *const p_circular_buffer );
 
+/** !
+ *  Get the quantity of values in a circular buffer without taking the lock.
+ *  While other threads push or pop, the result is approximate: it may be
+ *  stale, or mix indices from before and after a concurrent operation.
+ *  Spilled values are included, so the result can exceed the capacity when
+ *  a spill log is attached; otherwise it is between 0 and the capacity.
+ *  Expired values that have not been evicted yet are not reflected.
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @sa circular_buffer_capacity
+ *
+ * @return the quantity of values, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_size ( circular_buffer *const p_circular_buffer );
+
+/** !
+ *  Get the maximum quantity of values in a circular buffer
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @sa circular_buffer_size
+ *
+ * @return the capacity, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_capacity ( circular_buffer *const p_circular_buffer );
+
+/** !
+ *  Count the elements of a time windowed circular buffer that were pushed at
+ *  or after a point in time. Timestamps are monotonic from the oldest to the
+ *  newest element, so this is a binary search.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param t                 the point in time, in timer_high_precision units
+ *
+ * @sa circular_buffer_construct_timed
+ *
+ * @return the quantity of elements pushed at or after t, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_count_since ( circular_buffer *const p_circular_buffer, timestamp t );
+
 // Mutators
+/** !
+ * Set how many times a thread that finds the circular buffer locked spins
+ * before it parks. Spinning pays off when critical sections are short and
+ * threads have their own cores. Set 0 to park immediately, like a mutex.
+ * Only change this while no other thread is using the circular buffer.
+ * 
+ * @param p_circular_buffer the circular buffer
+ * @param spin              pause iterations before parking. Default CIRCULAR_BUFFER_LOCK_DEFAULT_SPIN.
+ * 
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_set_spin ( circular_buffer *const p_circular_buffer, unsigned spin );
+
 /** !
  * Add a value to a circular buffer
  * 
@@ -112,6 +255,19 @@ DLLEXPORT bool circular_buffer_full ( circular_buffer *const p_circular_buffer )
  */
 DLLEXPORT int circular_buffer_push ( circular_buffer *const p_circular_buffer, void  *p_data );
 
+/** !
+ * Add values to a circular buffer with one lock acquisition
+ * 
+ * @param p_circular_buffer the circular buffer
+ * @param pp_data           the values. Null values are skipped.
+ * @param count             the quantity of values
+ * 
+ * @sa circular_buffer_push
+ * 
+ * @return the quantity of values added, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_push_batch ( circular_buffer *const p_circular_buffer, void *const *pp_data, size_t count );
+
 /** !
  * Get the last value in the circular buffer
  * 
@@ -125,6 +281,77 @@ DLLEXPORT int circular_buffer_push ( circular_buffer *const p_circular_buffer, v
  */
 DLLEXPORT int circular_buffer_peek ( circular_buffer *const p_circular_buffer, void **pp_data );
 
+/** !
+ *  Get a value by its position from the oldest, without removing it
+ * 
+ * @param p_circular_buffer the circular buffer
+ * @param index             the position. 0 is the oldest value.
+ * @param pp_data           result
+ * 
+ * @sa circular_buffer_latest
+ * 
+ * @return 1 on success, 0 if out of bounds or on error
+ */
+DLLEXPORT int circular_buffer_at ( circular_buffer *const p_circular_buffer, size_t index, void **pp_data );
+
+/** !
+ *  Get a value by its position from the newest, without removing it
+ * 
+ * @param p_circular_buffer the circular buffer
+ * @param k                 the position. 0 is the newest value.
+ * @param pp_data           result
+ * 
+ * @sa circular_buffer_at
+ * 
+ * @return 1 on success, 0 if out of bounds or on error
+ */
+DLLEXPORT int circular_buffer_latest ( circular_buffer *const p_circular_buffer, size_t k, void **pp_data );
+
+/** !
+ *  Copy a range of values, without removing them
+ * 
+ * @param p_circular_buffer the circular buffer
+ * @param index             the position of the first value. 0 is the oldest value.
+ * @param pp_data           result. Must have room for count values.
+ * @param count             the maximum quantity of values
+ * 
+ * @sa circular_buffer_at
+ * 
+ * @return the quantity of values copied, 0 if out of bounds or on error
+ */
+DLLEXPORT size_t circular_buffer_copy_range ( circular_buffer *const p_circular_buffer, size_t index, void **pp_data, size_t count );
+
+/** !
+ *  Find the oldest occurrence of a value, without removing anything. Both
+ *  sides of the wrap point are scanned with the widest compare the
+ *  processor supports. Like pop, a drained circular buffer is refilled from
+ *  its spill log first; elements that stay on disk are not searched.
+ * 
+ * @param p_circular_buffer the circular buffer
+ * @param p_value           the value
+ * @param p_index           result. The position of the value, where 0 is the oldest value. May be null.
+ * 
+ * @sa circular_buffer_count
+ * @sa circular_buffer_at
+ * 
+ * @return 1 if the value is in the circular buffer, 0 if not or on error
+ */
+DLLEXPORT int circular_buffer_find ( circular_buffer *const p_circular_buffer, const void *p_value, size_t *p_index );
+
+/** !
+ *  Count the occurrences of a value, without removing anything. Like pop,
+ *  a drained circular buffer is refilled from its spill log first;
+ *  elements that stay on disk are not counted.
+ * 
+ * @param p_circular_buffer the circular buffer
+ * @param p_value           the value
+ * 
+ * @sa circular_buffer_find
+ * 
+ * @return the quantity of occurrences, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_count ( circular_buffer *const p_circular_buffer, const void *p_value );
+
 /** !
  * Remove a value from a circular buffer
  * 
@@ -138,6 +365,32 @@ DLLEXPORT int circular_buffer_peek ( circular_buffer *const p_circular_buffer, v
  */
 DLLEXPORT int circular_buffer_pop  ( circular_buffer *const p_circular_buffer, void **pp_data );
 
+/** !
+ * Remove up to max values from a circular buffer with one lock acquisition
+ * 
+ * @param p_circular_buffer the circular buffer
+ * @param pp_data           result. Must have room for max values.
+ * @param max               the maximum quantity of values
+ * 
+ * @sa circular_buffer_pop
+ * 
+ * @return the quantity of values removed, 0 if empty or on error
+ */
+DLLEXPORT size_t circular_buffer_pop_batch ( circular_buffer *const p_circular_buffer, void **pp_data, size_t max );
+
+/** !
+ * Discard every element of a time windowed circular buffer that has outlived
+ * its ttl. Pop and peek do this implicitly.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param now               the current time, in timer_high_precision units
+ *
+ * @sa circular_buffer_construct_timed
+ *
+ * @return the quantity of discarded elements, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_expire ( circular_buffer *const p_circular_buffer, timestamp now );
+
 // Destructors
 /** !
  *  Destroy and deallocate a circular buffer
@@ -149,3 +402,8 @@ DLLEXPORT int circular_buffer_pop  ( circular_buffer *const p_circular_buffer, v
  * @return 1 on success, 0 on error
  */
 DLLEXPORT int circular_buffer_destroy ( circular_buffer **const pp_circular_buffer );
+
+// Inline hot path
+#ifdef CIRCULAR_BUFFER_INLINE
+	#include <circular_buffer/inline.h>
+#endif
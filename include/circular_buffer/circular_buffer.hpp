@@ -0,0 +1,521 @@
+/** !
+ * Header only C++ circular buffers
+ *
+ * cb::ring<T, N> stores up to N values of type T inline, with no heap
+ * allocation and no casts through void *. When N is a power of two, indices
+ * wrap with a constexpr mask. cb::dynamic_ring<T> takes its capacity at run
+ * time, and masks whenever the capacity happens to be a power of two. A
+ * capacity of zero throws std::invalid_argument. A moved from dynamic_ring
+ * is empty, has capacity zero, and refuses every push.
+ *
+ * Both follow the C library. A push to a full circular buffer overwrites
+ * the oldest value, a pop from an empty circular buffer fails, and values
+ * come out oldest first. Values are constructed in place by emplace and
+ * moved out by pop, so move only types work.
+ *
+ * The last template parameter chooses the synchronization
+ *
+ *   cb::policy::none   no synchronization, for one thread
+ *   cb::policy::mutex  a std::mutex around each operation
+ *   cb::policy::mpmc   a spin then yield lock, for many producers and consumers
+ *   cb::policy::spsc   lock free, for one producer thread and one consumer
+ *                      thread. The producer can not overwrite a value the
+ *                      consumer may be reading, so a push to a full
+ *                      circular buffer fails instead.
+ *
+ * Iterators, operator[] and segments are not synchronized. Use them from
+ * one thread, or with the policy none.
+ *
+ * @file circular_buffer/circular_buffer.hpp
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// Standard library
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace cb
+{
+
+	// Synchronization policies
+	namespace policy
+	{
+
+		/** !
+		 *  @brief No synchronization
+		 */
+		struct none
+		{
+			static constexpr bool lock_free = false;
+			void lock   ( void ) noexcept { }
+			void unlock ( void ) noexcept { }
+		};
+
+		/** !
+		 *  @brief A std::mutex around each operation
+		 */
+		struct mutex
+		{
+			static constexpr bool lock_free = false;
+			void lock   ( void ) { _mutex.lock(); }
+			void unlock ( void ) { _mutex.unlock(); }
+			std::mutex _mutex;
+		};
+
+		/** !
+		 *  @brief A lock that spins while the holder is likely to finish
+		 *         soon, then yields, like the lock of the C library
+		 */
+		struct mpmc
+		{
+			static constexpr bool     lock_free = false;
+			static constexpr unsigned spin      = 128;
+
+			void lock ( void ) noexcept
+			{
+
+				// Take the lock, or wait until it looks free and try again
+				for (unsigned i = 0; _state.exchange(true, std::memory_order_acquire); )
+					while ( _state.load(std::memory_order_relaxed) )
+						if ( ++i > spin ) std::this_thread::yield();
+			}
+
+			void unlock ( void ) noexcept { _state.store(false, std::memory_order_release); }
+
+			std::atomic<bool> _state { false };
+		};
+
+		/** !
+		 *  @brief Lock free, for one producer thread and one consumer thread
+		 */
+		struct spsc
+		{
+			static constexpr bool lock_free = true;
+			void lock   ( void ) noexcept { }
+			void unlock ( void ) noexcept { }
+		};
+	}
+
+	/** !
+	 *  @brief A contiguous run of values, oldest first
+	 */
+	template <typename T>
+	struct span
+	{
+		T           *p_data;
+		std::size_t  count;
+
+		constexpr T           *data  ( void ) const noexcept { return p_data; }
+		constexpr std::size_t  size  ( void ) const noexcept { return count; }
+		constexpr bool         empty ( void ) const noexcept { return count == 0; }
+		constexpr T           *begin ( void ) const noexcept { return p_data; }
+		constexpr T           *end   ( void ) const noexcept { return p_data + count; }
+		constexpr T           &operator[] ( std::size_t i ) const noexcept { return p_data[i]; }
+	};
+
+	namespace detail
+	{
+
+		/** !
+		 *  @brief Inline storage for a capacity known at compile time
+		 */
+		template <typename T, std::size_t N>
+		class static_storage
+		{
+			static_assert(N > 0, "capacity must be greater than zero");
+
+			public:
+				static constexpr std::size_t capacity ( void ) noexcept { return N; }
+
+				static constexpr std::size_t index ( std::size_t i ) noexcept
+				{
+
+					// Mask when the capacity is a power of two
+					if constexpr ( ( N & ( N - 1 ) ) == 0 ) return i & ( N - 1 );
+					else                                     return i % N;
+				}
+
+				T       *slots ( void )       noexcept { return std::launder(reinterpret_cast<T *>(_storage)); }
+				const T *slots ( void ) const noexcept { return std::launder(reinterpret_cast<const T *>(_storage)); }
+
+			private:
+				alignas(T) unsigned char _storage[N * sizeof(T)];
+		};
+
+		/** !
+		 *  @brief Heap storage for a capacity known at run time
+		 */
+		template <typename T>
+		class dynamic_storage
+		{
+			public:
+				explicit dynamic_storage ( std::size_t capacity )
+					: _capacity(checked(capacity)),
+					  _mask(capacity - 1),
+					  _masked(( capacity & ( capacity - 1 ) ) == 0),
+					  _p_slots(static_cast<T *>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T)))))
+				{ }
+
+				// The moved from storage has capacity zero, and every index is zero
+				dynamic_storage ( dynamic_storage &&other ) noexcept
+					: _capacity(std::exchange(other._capacity, 0)),
+					  _mask(std::exchange(other._mask, 0)),
+					  _masked(std::exchange(other._masked, true)),
+					  _p_slots(std::exchange(other._p_slots, nullptr))
+				{ }
+
+				dynamic_storage ( const dynamic_storage & )            = delete;
+				dynamic_storage &operator= ( const dynamic_storage & ) = delete;
+				dynamic_storage &operator= ( dynamic_storage && )      = delete;
+
+				~dynamic_storage ( void ) { if ( _p_slots ) ::operator delete(_p_slots, std::align_val_t(alignof(T))); }
+
+				std::size_t capacity ( void ) const noexcept { return _capacity; }
+
+				std::size_t index ( std::size_t i ) const noexcept
+				{
+
+					// Mask when the capacity is a power of two
+					return _masked ? i & _mask : i % _capacity;
+				}
+
+				T       *slots ( void )       noexcept { return _p_slots; }
+				const T *slots ( void ) const noexcept { return _p_slots; }
+
+			private:
+				static std::size_t checked ( std::size_t capacity )
+				{
+
+					// A ring needs at least one slot
+					if ( capacity == 0 ) throw std::invalid_argument("cb::dynamic_ring capacity must be greater than zero");
+
+					// Success
+					return capacity;
+				}
+
+				std::size_t  _capacity, _mask;
+				bool         _masked;
+				T           *_p_slots;
+		};
+
+		/** !
+		 *  @brief The circular buffer, over either kind of storage
+		 */
+		template <typename T, typename Storage, typename Policy>
+		class basic_ring
+		{
+			public:
+				using value_type = T;
+				using size_type  = std::size_t;
+
+				/** !
+				 *  @brief Iterates values oldest first
+				 */
+				template <typename Ring, typename Value>
+				class basic_iterator
+				{
+					public:
+						using iterator_category = std::forward_iterator_tag;
+						using value_type        = std::remove_const_t<Value>;
+						using difference_type   = std::ptrdiff_t;
+						using pointer           = Value *;
+						using reference         = Value &;
+
+						basic_iterator ( void ) = default;
+						basic_iterator ( Ring *p_ring, std::size_t position ) noexcept : _p_ring(p_ring), _position(position) { }
+
+						reference       operator*  ( void ) const noexcept { return _p_ring->_storage.slots()[_p_ring->_storage.index(_position)]; }
+						pointer         operator-> ( void ) const noexcept { return &**this; }
+						basic_iterator &operator++ ( void ) noexcept { _position++; return *this; }
+						basic_iterator  operator++ ( int )  noexcept { basic_iterator ret = *this; _position++; return ret; }
+
+						friend bool operator== ( const basic_iterator &a, const basic_iterator &b ) noexcept { return a._position == b._position; }
+						friend bool operator!= ( const basic_iterator &a, const basic_iterator &b ) noexcept { return a._position != b._position; }
+
+					private:
+						Ring        *_p_ring   = nullptr;
+						std::size_t  _position = 0;
+				};
+
+				using iterator       = basic_iterator<basic_ring, T>;
+				using const_iterator = basic_iterator<const basic_ring, const T>;
+
+				// Inline storage
+				basic_ring ( void ) = default;
+
+				// Heap storage. Throws std::invalid_argument if the capacity is zero.
+				explicit basic_ring ( std::size_t capacity ) : _storage(capacity) { }
+
+				basic_ring ( basic_ring &&other ) noexcept(std::is_nothrow_move_constructible_v<T>)
+					: basic_ring(std::move(other), std::is_default_constructible<Storage>())
+				{ }
+
+				basic_ring ( const basic_ring & )            = delete;
+				basic_ring &operator= ( const basic_ring & ) = delete;
+				basic_ring &operator= ( basic_ring && )      = delete;
+
+				~basic_ring ( void ) { clear(); }
+
+				// Accessors
+				size_type capacity ( void ) const noexcept { return _storage.capacity(); }
+
+				/** !
+				 *  Get the quantity of values. While other threads push or pop,
+				 *  the result is approximate, but always between 0 and the capacity.
+				 *
+				 * @return the quantity of values
+				 */
+				size_type size ( void ) const noexcept
+				{
+
+					// Initialized data. The read index is loaded first, so the
+					// write index can only be newer, and never behind it.
+					std::size_t read  = _read.load(std::memory_order_acquire),
+					            write = _write.load(std::memory_order_acquire),
+					            count = write - read;
+
+					// The consumer may have moved on since the read index was loaded
+					return ( count < capacity() ) ? count : capacity();
+				}
+
+				bool      empty    ( void ) const noexcept { return size() == 0; }
+				bool      full     ( void ) const noexcept { return size() == capacity(); }
+
+				/** !
+				 *  Copy the oldest value without removing it
+				 *
+				 * @param value result
+				 *
+				 * @return true on success, false if the circular buffer is empty
+				 */
+				template <typename U = T, typename = std::enable_if_t<std::is_copy_assignable_v<U>>>
+				bool peek ( U &value )
+				{
+
+					// Initialized data
+					std::lock_guard<Policy> guard(_policy);
+					std::size_t             read = _read.load(std::memory_order_relaxed);
+
+					// Empty
+					if ( read == _write.load(std::memory_order_acquire) ) return false;
+
+					// Copy the value
+					value = _storage.slots()[_storage.index(read)];
+
+					// Success
+					return true;
+				}
+
+				// Unsynchronized access, oldest first
+				T       &operator[] ( size_type i )       noexcept { return _storage.slots()[_storage.index(_read.load(std::memory_order_relaxed) + i)]; }
+				const T &operator[] ( size_type i ) const noexcept { return _storage.slots()[_storage.index(_read.load(std::memory_order_relaxed) + i)]; }
+
+				iterator       begin ( void )       noexcept { return iterator(this, _read.load(std::memory_order_relaxed)); }
+				iterator       end   ( void )       noexcept { return iterator(this, _write.load(std::memory_order_relaxed)); }
+				const_iterator begin ( void ) const noexcept { return const_iterator(this, _read.load(std::memory_order_relaxed)); }
+				const_iterator end   ( void ) const noexcept { return const_iterator(this, _write.load(std::memory_order_relaxed)); }
+
+				/** !
+				 *  Get the values as two contiguous runs, on either side of the
+				 *  wrap point. The second run is empty unless the values wrap.
+				 *
+				 * @return the oldest run, then the newest run
+				 */
+				std::pair<span<T>, span<T>> segments ( void ) noexcept
+				{
+
+					// Initialized data
+					std::size_t read  = _read.load(std::memory_order_relaxed),
+					            count = _write.load(std::memory_order_relaxed) - read,
+					            start = _storage.index(read),
+					            first = ( capacity() - start < count ) ? capacity() - start : count;
+
+					// Success
+					return { span<T> { _storage.slots() + start, first }, span<T> { _storage.slots(), count - first } };
+				}
+
+				std::pair<span<const T>, span<const T>> segments ( void ) const noexcept
+				{
+
+					// Initialized data
+					auto ret = const_cast<basic_ring *>(this)->segments();
+
+					// Success
+					return { span<const T> { ret.first.p_data, ret.first.count }, span<const T> { ret.second.p_data, ret.second.count } };
+				}
+
+				// Mutators
+				/** !
+				 *  Construct a value in place as the newest value. A full
+				 *  circular buffer overwrites its oldest value, except with the
+				 *  policy spsc, where the push fails.
+				 *
+				 * @param arguments passed to the constructor of T
+				 *
+				 * @return true on success, false if the policy is spsc and the circular buffer is full,
+				 *         or if the circular buffer was moved from
+				 */
+				template <typename... Arguments>
+				bool emplace ( Arguments &&...arguments )
+				{
+
+					// Initialized data
+					std::lock_guard<Policy> guard(_policy);
+					std::size_t             write = _write.load(std::memory_order_relaxed),
+					                        read  = _read.load(std::memory_order_acquire);
+					T                      *p     = &_storage.slots()[_storage.index(write)];
+
+					// A moved from dynamic_ring has no storage
+					if ( capacity() == 0 ) return false;
+
+					// Full
+					if ( write - read == capacity() )
+					{
+
+						// The consumer may be reading the oldest value
+						if constexpr ( Policy::lock_free ) return false;
+
+						// Overwrite the oldest value
+						p->~T();
+						_read.store(read + 1, std::memory_order_release);
+					}
+
+					// Construct the value, then publish it
+					::new (static_cast<void *>(p)) T(std::forward<Arguments>(arguments)...);
+					_write.store(write + 1, std::memory_order_release);
+
+					// Success
+					return true;
+				}
+
+				bool push ( const T &value ) { return emplace(value); }
+				bool push ( T &&value )      { return emplace(std::move(value)); }
+
+				/** !
+				 *  Move the oldest value out
+				 *
+				 * @param value result
+				 *
+				 * @return true on success, false if the circular buffer is empty
+				 */
+				bool pop ( T &value )
+				{
+
+					// Initialized data
+					std::lock_guard<Policy> guard(_policy);
+					std::size_t             read = _read.load(std::memory_order_relaxed);
+					T                      *p    = &_storage.slots()[_storage.index(read)];
+
+					// Empty
+					if ( read == _write.load(std::memory_order_acquire) ) return false;
+
+					// Move the value out, then release the slot
+					value = std::move(*p);
+					p->~T();
+					_read.store(read + 1, std::memory_order_release);
+
+					// Success
+					return true;
+				}
+
+				/** !
+				 *  Move the oldest value out
+				 *
+				 * @return the value, or nothing if the circular buffer is empty
+				 */
+				std::optional<T> pop ( void )
+				{
+
+					// Initialized data
+					std::lock_guard<Policy> guard(_policy);
+					std::size_t             read = _read.load(std::memory_order_relaxed);
+					T                      *p    = &_storage.slots()[_storage.index(read)];
+
+					// Empty
+					if ( read == _write.load(std::memory_order_acquire) ) return std::nullopt;
+
+					// Move the value out, then release the slot
+					std::optional<T> ret(std::move(*p));
+					p->~T();
+					_read.store(read + 1, std::memory_order_release);
+
+					// Success
+					return ret;
+				}
+
+				/** !
+				 *  Destroy every value
+				 *
+				 * @return void
+				 */
+				void clear ( void )
+				{
+
+					// Initialized data
+					std::lock_guard<Policy> guard(_policy);
+					std::size_t             read  = _read.load(std::memory_order_relaxed),
+					                        write = _write.load(std::memory_order_relaxed);
+
+					// Destroy each value
+					for (; read != write; read++) _storage.slots()[_storage.index(read)].~T();
+
+					// Empty
+					_read.store(write, std::memory_order_release);
+				}
+
+			private:
+
+				// Move the values of a ring with inline storage one at a time
+				basic_ring ( basic_ring &&other, std::true_type )
+				{
+					for (T &value : other) emplace(std::move(value));
+					other.clear();
+				}
+
+				// Take the storage of a ring with heap storage
+				basic_ring ( basic_ring &&other, std::false_type ) noexcept
+					: _storage(std::move(other._storage)),
+					  _read(other._read.load(std::memory_order_relaxed)),
+					  _write(other._write.load(std::memory_order_relaxed))
+				{
+					other._read.store(0, std::memory_order_relaxed);
+					other._write.store(0, std::memory_order_relaxed);
+				}
+
+				// The read and write counters only grow, and wrap through the
+				// storage index. The consumer owns the read counter and the
+				// producer owns the write counter, so with the policy spsc each
+				// is written by one thread and read by the other.
+				Storage                              _storage;
+				alignas(64) std::atomic<std::size_t> _read  { 0 };
+				alignas(64) std::atomic<std::size_t> _write { 0 };
+				Policy                               _policy;
+		};
+	}
+
+	/** !
+	 *  @brief A circular buffer of N values of type T, stored inline
+	 */
+	template <typename T, std::size_t N, typename Policy = policy::none>
+	using ring = detail::basic_ring<T, detail::static_storage<T, N>, Policy>;
+
+	/** !
+	 *  @brief A circular buffer of values of type T, with a capacity chosen at
+	 *         run time
+	 */
+	template <typename T, typename Policy = policy::none>
+	using dynamic_ring = detail::basic_ring<T, detail::dynamic_storage<T>, Policy>;
+}
@@ -0,0 +1,69 @@
+/** !
+ * Include header for coalescing circular buffers
+ *
+ * In a coalescing circular buffer, each element carries a key, and a push
+ * for a key that is still waiting replaces that element in place instead
+ * of adding another. Elements keep the position of the first push for
+ * their key, so the order is first arrival, and a consumer sees at most one
+ * element per distinct key no matter how fast updates arrive. This suits
+ * state streams, such as the latest price per symbol, where only the
+ * newest value matters.
+ *
+ * Keys are found through an open addressed index with at least twice as
+ * many entries as the circular buffer, so a push probes a few adjacent
+ * entries. Elements pushed without a key, and elements sent to a spill
+ * tier, are never coalesced.
+ *
+ * @file circular_buffer/coalesce.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// Standard library
+#include <stdint.h>
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Constructors
+/** !
+ *  Construct a coalescing circular buffer with a specific number of entries
+ *
+ * @param pp_circular_buffer return
+ * @param size               the maximum quantity of elements, and of distinct pending keys
+ *
+ * @sa circular_buffer_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_construct_coalescing ( circular_buffer **const pp_circular_buffer, size_t size );
+
+// Accessors
+/** !
+ *  Get the quantity of pushes that replaced a pending element
+ *
+ * @param p_circular_buffer the coalescing circular buffer
+ *
+ * @return the quantity of coalesced pushes, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_coalesced ( circular_buffer *const p_circular_buffer );
+
+// Mutators
+/** !
+ *  Push an element with a key. If an element with the same key is still in
+ *  the circular buffer, it is replaced in place, and handed back so the
+ *  caller can free it.
+ *
+ * @param p_circular_buffer the coalescing circular buffer
+ * @param key               the key
+ * @param p_data            the element
+ * @param pp_replaced       result. The element that was replaced, or null if none was. May be null.
+ *
+ * @sa circular_buffer_push
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_push_keyed ( circular_buffer *const p_circular_buffer, uint64_t key, void *p_data, void **pp_replaced );
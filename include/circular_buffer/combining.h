@@ -0,0 +1,42 @@
+/** !
+ * Include header for flat combining circular buffers
+ *
+ * In a flat combining circular buffer, a producer publishes its push in a
+ * slot instead of waiting for the lock. Whichever producer gets the lock
+ * applies every published push in one pass while the others spin on their
+ * own slot, so the indices and the storage stay in one core's cache
+ * instead of moving between sockets on every push. This pays off when
+ * many producers push to one circular buffer at once; with few producers
+ * the plain lock is cheaper.
+ *
+ * Threads map to slots by a per thread number. Threads that share a slot
+ * with a busy thread fall back to the lock, so any quantity of threads is
+ * correct, but give each producer its own slot for the best throughput.
+ *
+ * @file circular_buffer/combining.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Preprocessor definitions
+#define CIRCULAR_BUFFER_COMBINING_DEFAULT_SLOTS 64
+
+// Constructors
+/** !
+ *  Construct a flat combining circular buffer with a specific number of entries
+ *
+ * @param pp_circular_buffer return
+ * @param size               the maximum quantity of elements
+ * @param slots              the quantity of publication slots, or 0 for CIRCULAR_BUFFER_COMBINING_DEFAULT_SLOTS
+ *
+ * @sa circular_buffer_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_construct_combining ( circular_buffer **const pp_circular_buffer, size_t size, size_t slots );
@@ -0,0 +1,75 @@
+/** !
+ * Include header for circular buffer consumer threads
+ *
+ * A consumer thread drains a circular buffer in batches and hands each
+ * batch to a callback. The thread sleeps while the circular buffer is
+ * empty. Once an element arrives it lingers until either a full batch is
+ * available or the linger time elapses, then pops the batch with one lock
+ * acquisition and calls the callback without holding any lock.
+ *
+ * Only available on POSIX platforms.
+ *
+ * @file circular_buffer/consumer.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Preprocessor definitions
+#define CIRCULAR_BUFFER_CONSUMER_DEFAULT_BATCH 64
+
+// Forward declarations
+struct circular_buffer_consumer_options_s;
+
+// Type definitions
+/** !
+ *  @brief The type definition of a consumer options struct
+ */
+typedef struct circular_buffer_consumer_options_s circular_buffer_consumer_options;
+
+/** !
+ *  @brief The type definition of a function that consumes a batch of elements.
+ *         The array is only valid for the duration of the call.
+ */
+typedef void (fn_circular_buffer_consumer)( void **pp_elements, size_t count, void *p_context );
+
+// Structure definitions
+struct circular_buffer_consumer_options_s
+{
+	size_t     max_batch;  // The most elements per callback. 0 selects CIRCULAR_BUFFER_CONSUMER_DEFAULT_BATCH.
+	timestamp  max_linger; // The longest a partial batch waits, in timer_high_precision units. 0 selects one millisecond.
+	void      *p_context;  // Passed to the callback
+};
+
+// Mutators
+/** !
+ *  Start a thread that drains a circular buffer and passes batches to a callback
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param pfn_consumer      the callback
+ * @param p_options         the batch size, linger time and context, or null for defaults
+ *
+ * @sa circular_buffer_detach_consumer
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_attach_consumer ( circular_buffer *const p_circular_buffer, fn_circular_buffer_consumer *pfn_consumer, const circular_buffer_consumer_options *p_options );
+
+/** !
+ *  Stop the consumer thread. Elements still in the circular buffer are
+ *  delivered to the callback before the thread exits. Producers must be
+ *  stopped first, and this must not be called from the callback.
+ *  circular_buffer_destroy calls this automatically.
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @sa circular_buffer_attach_consumer
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_detach_consumer ( circular_buffer *const p_circular_buffer );
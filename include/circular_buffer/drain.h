@@ -0,0 +1,88 @@
+/** !
+ * Include header for double buffered drains
+ *
+ * A drain takes every element of a circular buffer at once. Under the lock,
+ * the storage holding the elements is swapped with a spare block of the
+ * same capacity, and the circular buffer is left empty. Producers continue
+ * into the spare block straight away, while the consumer reads the old
+ * block at its leisure, then hands it back to be the next spare. The lock
+ * is held for a few stores, however many elements are drained.
+ *
+ * The spare block is allocated by the first drain, outside the lock, and
+ * freed with the circular buffer. Only one batch can be out at a time.
+ * Drains apply to circular buffers without features, since features such as
+ * timestamps, byte budgets and spill logs keep state for each entry that
+ * would not follow the swap.
+ *
+ * @file circular_buffer/drain.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Structure definitions
+struct circular_buffer_batch_s
+{
+	size_t count, read, length;
+	void **_p_data;
+};
+
+// Type definitions
+/** !
+ *  @brief The type definition of a batch of drained elements
+ */
+typedef struct circular_buffer_batch_s circular_buffer_batch;
+
+// Accessors
+/** !
+ *  Get an element of a batch, oldest first
+ *
+ * @param p_batch the batch
+ * @param index   the index of the element, less than p_batch->count
+ *
+ * @return the element
+ */
+static inline void *circular_buffer_batch_at ( const circular_buffer_batch *const p_batch, size_t index )
+{
+
+	// Initialized data
+	size_t i = p_batch->read + index;
+
+	// Wrap without a division
+	if ( i >= p_batch->length ) i -= p_batch->length;
+
+	// Success
+	return p_batch->_p_data[i];
+}
+
+// Mutators
+/** !
+ *  Take every element of a circular buffer, in constant time. Release the
+ *  batch with circular_buffer_batch_release before the next drain.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param p_batch           return
+ *
+ * @sa circular_buffer_batch_release
+ *
+ * @return the quantity of drained elements, 0 if the circular buffer is empty or on error
+ */
+DLLEXPORT size_t circular_buffer_drain_all ( circular_buffer *const p_circular_buffer, circular_buffer_batch *const p_batch );
+
+/** !
+ *  Hand the storage of a drained batch back to its circular buffer, to be
+ *  the spare block of the next drain
+ *
+ * @param p_circular_buffer the circular buffer the batch was drained from
+ * @param p_batch           the batch
+ *
+ * @sa circular_buffer_drain_all
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_batch_release ( circular_buffer *const p_circular_buffer, circular_buffer_batch *const p_batch );
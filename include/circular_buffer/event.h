@@ -0,0 +1,52 @@
+/** !
+ * Include header for circular buffer event file descriptors
+ *
+ * A circular buffer can expose an eventfd that becomes readable when the
+ * circular buffer goes from empty to non empty, and optionally when its
+ * occupancy reaches a watermark. Signals are coalesced: there is one write
+ * per transition, not one per push. The circular buffer consumes the
+ * signal itself when it drains, so the descriptor is not left readable
+ * while the circular buffer is empty. Elements waiting in a spill log keep
+ * the descriptor readable until they have been popped too. Consumers should pop until empty
+ * each time the descriptor becomes readable.
+ *
+ * Only available on Linux.
+ *
+ * @file circular_buffer/event.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Accessors
+/** !
+ *  Get the event file descriptor of a circular buffer, creating it on first
+ *  use. Register it with epoll for EPOLLIN. It is closed when the circular
+ *  buffer is destroyed.
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @sa circular_buffer_set_fd_watermark
+ *
+ * @return the file descriptor on success, -1 on error
+ */
+DLLEXPORT int circular_buffer_get_fd ( circular_buffer *const p_circular_buffer );
+
+// Mutators
+/** !
+ *  Also signal the event file descriptor when the occupancy of a circular
+ *  buffer reaches a watermark
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param watermark         the occupancy, or 0 to only signal on empty to non empty
+ *
+ * @sa circular_buffer_get_fd
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_set_fd_watermark ( circular_buffer *const p_circular_buffer, size_t watermark );
@@ -0,0 +1,123 @@
+/** !
+ * Include header for work stealing executors
+ *
+ * An executor runs tasks on a pool of worker threads. Each worker owns a
+ * Chase-Lev deque, a power of two ring that only its owner pushes to and
+ * takes from at the bottom, without a lock. Idle workers steal from the top
+ * of the other deques with one compare and swap, so workers only contend
+ * when one runs dry. Tasks submitted from outside the pool go to a shared
+ * injection circular buffer, which workers drain in batches into their own
+ * deques. Tasks submitted from a worker, such as the subtasks of a task, go
+ * to that worker's deque and run most recent first, while they are still
+ * in cache.
+ *
+ * A task is a pointer, and every task runs the same function. Workers that
+ * find nothing to run or steal spin briefly, then park until a submission
+ * wakes them.
+ *
+ * Only available on POSIX platforms.
+ *
+ * @file circular_buffer/executor.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Preprocessor definitions
+#define CIRCULAR_BUFFER_EXECUTOR_DEFAULT_SIZE 1024
+
+// Forward declarations
+struct circular_buffer_executor_s;
+
+// Type definitions
+/** !
+ *  @brief The type definition of an executor struct
+ */
+typedef struct circular_buffer_executor_s circular_buffer_executor;
+
+/** !
+ *  @brief The type definition of a function that runs a task
+ */
+typedef void (fn_circular_buffer_task)( void *p_task, void *p_context );
+
+// Constructors
+/** !
+ *  Construct an executor and start its workers
+ *
+ * @param pp_executor return
+ * @param workers     the quantity of worker threads
+ * @param size        the capacity of each deque and of the injection circular buffer, rounded up to a
+ *                    power of two, or 0 for CIRCULAR_BUFFER_EXECUTOR_DEFAULT_SIZE
+ * @param pfn_task    runs each task
+ * @param p_context   passed to pfn_task
+ *
+ * @sa circular_buffer_executor_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_executor_construct ( circular_buffer_executor **const pp_executor, size_t workers, size_t size, fn_circular_buffer_task *pfn_task, void *p_context );
+
+// Accessors
+/** !
+ *  Get the quantity of tasks workers have stolen from each other
+ *
+ * @param p_executor the executor
+ *
+ * @return the quantity of steals, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_executor_steals ( circular_buffer_executor *const p_executor );
+
+// Mutators
+/** !
+ *  Submit a task. From a worker, the task goes to that worker's deque,
+ *  otherwise to the injection circular buffer.
+ *
+ * @param p_executor the executor
+ * @param p_task     the task
+ *
+ * @sa circular_buffer_executor_submit_batch
+ *
+ * @return 1 on success, 0 if the queue is full or on error
+ */
+DLLEXPORT int circular_buffer_executor_submit ( circular_buffer_executor *const p_executor, void *p_task );
+
+/** !
+ *  Submit many tasks at once. From outside the pool, the injection circular
+ *  buffer is locked once for the whole batch.
+ *
+ * @param p_executor the executor
+ * @param pp_tasks   the tasks
+ * @param count      the quantity of tasks
+ *
+ * @sa circular_buffer_executor_submit
+ *
+ * @return the quantity of tasks submitted, which is less than count if the queue filled
+ */
+DLLEXPORT size_t circular_buffer_executor_submit_batch ( circular_buffer_executor *const p_executor, void *const *pp_tasks, size_t count );
+
+/** !
+ *  Wait until every submitted task, including tasks submitted by tasks, has
+ *  run. Must not be called from a worker.
+ *
+ * @param p_executor the executor
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_executor_wait ( circular_buffer_executor *const p_executor );
+
+// Destructors
+/** !
+ *  Run every submitted task, then stop the workers and destroy the executor
+ *
+ * @param pp_executor pointer to the executor
+ *
+ * @sa circular_buffer_executor_construct
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_executor_destroy ( circular_buffer_executor **const pp_executor );
@@ -0,0 +1,254 @@
+/** !
+ * Inline hot path for the circular buffer library.
+ *
+ * Define CIRCULAR_BUFFER_INLINE before including circular_buffer.h to
+ * replace calls to push, pop, peek, empty and full with static inline
+ * definitions. Buffers with any feature flag set fall back to the
+ * library. The *_unchecked variants skip argument validation entirely.
+ *
+ * @file circular_buffer/inline.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Static tracepoints
+#include <circular_buffer/probes.h>
+
+// Compiler dependent macros
+#if defined(__GNUC__) || defined(__clang__)
+	#define CIRCULAR_BUFFER_LIKELY(x)   __builtin_expect(!!(x), 1)
+	#define CIRCULAR_BUFFER_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+	#define CIRCULAR_BUFFER_LIKELY(x)   (x)
+	#define CIRCULAR_BUFFER_UNLIKELY(x) (x)
+#endif
+
+// Unchecked operations
+/** !
+ * Get the quantity of values in a circular buffer. The caller must hold
+ * the lock.
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return the quantity of values
+ */
+static inline size_t circular_buffer_occupancy_unchecked ( const circular_buffer *const p_circular_buffer )
+{
+
+	// Success
+	return ( p_circular_buffer->full ) ? p_circular_buffer->length : ( p_circular_buffer->write + p_circular_buffer->length - p_circular_buffer->read ) % p_circular_buffer->length;
+}
+
+/** !
+ * Add a value to a circular buffer without validating arguments
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param p_data            the value
+ *
+ * @sa circular_buffer_push
+ *
+ * @return 1 on success, 0 on error
+ */
+static inline int circular_buffer_push_unchecked ( circular_buffer *const p_circular_buffer, void *p_data )
+{
+
+	// Slow path
+	if ( CIRCULAR_BUFFER_UNLIKELY(p_circular_buffer->features) ) return (circular_buffer_push)(p_circular_buffer, p_data);
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// Trace the overwrite
+	if ( p_circular_buffer->full ) CIRCULAR_BUFFER_PROBE3(overflow, p_circular_buffer, p_circular_buffer->_p_data[p_circular_buffer->write], p_circular_buffer->length);
+
+	// Store the element
+	p_circular_buffer->_p_data[p_circular_buffer->write] = p_data;
+
+	// Update the write index
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->write, p_circular_buffer->write + 1 == p_circular_buffer->length ? 0 : p_circular_buffer->write + 1);
+
+	// Handle overflows
+	if ( p_circular_buffer->full )
+		CIRCULAR_BUFFER_STORE(p_circular_buffer->read, p_circular_buffer->write);
+
+	// Update the full flag
+	else
+		CIRCULAR_BUFFER_STORE(p_circular_buffer->full, p_circular_buffer->read == p_circular_buffer->write);
+
+	// Trace the push
+	CIRCULAR_BUFFER_PROBE3(push, p_circular_buffer, circular_buffer_occupancy_unchecked(p_circular_buffer), p_circular_buffer->length);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return 1;
+}
+
+/** !
+ * Get the oldest value in a circular buffer without validating arguments
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param pp_data           result
+ *
+ * @sa circular_buffer_peek
+ *
+ * @return 1 on success, 0 on error
+ */
+static inline int circular_buffer_peek_unchecked ( circular_buffer *const p_circular_buffer, void **pp_data )
+{
+
+	// Slow path
+	if ( CIRCULAR_BUFFER_UNLIKELY(p_circular_buffer->features) ) return (circular_buffer_peek)(p_circular_buffer, pp_data);
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// State check
+	if ( CIRCULAR_BUFFER_UNLIKELY(p_circular_buffer->full == false && p_circular_buffer->read == p_circular_buffer->write) )
+	{
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Return data to the caller
+	*pp_data = p_circular_buffer->_p_data[p_circular_buffer->read];
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return 1;
+}
+
+/** !
+ * Remove a value from a circular buffer without validating arguments
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param pp_data           result
+ *
+ * @sa circular_buffer_pop
+ *
+ * @return 1 on success, 0 on error
+ */
+static inline int circular_buffer_pop_unchecked ( circular_buffer *const p_circular_buffer, void **pp_data )
+{
+
+	// Slow path
+	if ( CIRCULAR_BUFFER_UNLIKELY(p_circular_buffer->features) ) return (circular_buffer_pop)(p_circular_buffer, pp_data);
+
+	// Lock
+	circular_buffer_lock_acquire(&p_circular_buffer->_lock);
+
+	// State check
+	if ( CIRCULAR_BUFFER_UNLIKELY(p_circular_buffer->full == false && p_circular_buffer->read == p_circular_buffer->write) )
+	{
+
+		// Unlock
+		circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+		// Error
+		return 0;
+	}
+
+	// Return data to the caller
+	*pp_data = p_circular_buffer->_p_data[p_circular_buffer->read];
+
+	// Update the read index
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->read, p_circular_buffer->read + 1 == p_circular_buffer->length ? 0 : p_circular_buffer->read + 1);
+
+	// Clear the full flag
+	CIRCULAR_BUFFER_STORE(p_circular_buffer->full, false);
+
+	// Trace the pop
+	CIRCULAR_BUFFER_PROBE3(pop, p_circular_buffer, circular_buffer_occupancy_unchecked(p_circular_buffer), p_circular_buffer->length);
+
+	// Unlock
+	circular_buffer_lock_release(&p_circular_buffer->_lock);
+
+	// Success
+	return 1;
+}
+
+/** !
+ * Check if a circular buffer is empty without validating arguments
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @sa circular_buffer_empty
+ *
+ * @return true if circular buffer is empty else false
+ */
+static inline bool circular_buffer_empty_unchecked ( circular_buffer *const p_circular_buffer )
+{
+
+	// Slow path, so spilled elements count
+	if ( CIRCULAR_BUFFER_UNLIKELY(p_circular_buffer->features) ) return (circular_buffer_empty)(p_circular_buffer);
+
+	// Success
+	return CIRCULAR_BUFFER_LOAD(p_circular_buffer->full) == false && CIRCULAR_BUFFER_LOAD(p_circular_buffer->read) == CIRCULAR_BUFFER_LOAD(p_circular_buffer->write);
+}
+
+/** !
+ * Check if a circular buffer is full without validating arguments
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @sa circular_buffer_full
+ *
+ * @return true if circular buffer is full else false
+ */
+static inline bool circular_buffer_full_unchecked ( circular_buffer *const p_circular_buffer )
+{
+
+	// Success
+	return CIRCULAR_BUFFER_LOAD(p_circular_buffer->full);
+}
+
+// Checked operations. Null arguments take the library path, which logs the error.
+static inline int circular_buffer_push_inline ( circular_buffer *const p_circular_buffer, void *p_data )
+{
+	if ( CIRCULAR_BUFFER_UNLIKELY(p_circular_buffer == (void *) 0 || p_data == (void *) 0) ) return (circular_buffer_push)(p_circular_buffer, p_data);
+	return circular_buffer_push_unchecked(p_circular_buffer, p_data);
+}
+
+static inline int circular_buffer_peek_inline ( circular_buffer *const p_circular_buffer, void **pp_data )
+{
+	if ( CIRCULAR_BUFFER_UNLIKELY(p_circular_buffer == (void *) 0 || pp_data == (void *) 0) ) return (circular_buffer_peek)(p_circular_buffer, pp_data);
+	return circular_buffer_peek_unchecked(p_circular_buffer, pp_data);
+}
+
+static inline int circular_buffer_pop_inline ( circular_buffer *const p_circular_buffer, void **pp_data )
+{
+	if ( CIRCULAR_BUFFER_UNLIKELY(p_circular_buffer == (void *) 0 || pp_data == (void *) 0) ) return (circular_buffer_pop)(p_circular_buffer, pp_data);
+	return circular_buffer_pop_unchecked(p_circular_buffer, pp_data);
+}
+
+static inline bool circular_buffer_empty_inline ( circular_buffer *const p_circular_buffer )
+{
+	if ( CIRCULAR_BUFFER_UNLIKELY(p_circular_buffer == (void *) 0) ) return (circular_buffer_empty)(p_circular_buffer);
+	return circular_buffer_empty_unchecked(p_circular_buffer);
+}
+
+static inline bool circular_buffer_full_inline ( circular_buffer *const p_circular_buffer )
+{
+	if ( CIRCULAR_BUFFER_UNLIKELY(p_circular_buffer == (void *) 0) ) return (circular_buffer_full)(p_circular_buffer);
+	return circular_buffer_full_unchecked(p_circular_buffer);
+}
+
+// Replace calls to the library with the inline definitions
+#define circular_buffer_push(p_circular_buffer, p_data)  circular_buffer_push_inline(p_circular_buffer, p_data)
+#define circular_buffer_peek(p_circular_buffer, pp_data) circular_buffer_peek_inline(p_circular_buffer, pp_data)
+#define circular_buffer_pop(p_circular_buffer, pp_data)  circular_buffer_pop_inline(p_circular_buffer, pp_data)
+#define circular_buffer_empty(p_circular_buffer)         circular_buffer_empty_inline(p_circular_buffer)
+#define circular_buffer_full(p_circular_buffer)          circular_buffer_full_inline(p_circular_buffer)
@@ -0,0 +1,74 @@
+/** !
+ * Include header for circular buffer latency histograms
+ *
+ * When the library is built with CIRCULAR_BUFFER_LATENCY defined, a
+ * circular buffer can stamp sampled elements on push and record how long
+ * each one waited before it was popped. Residence times are kept in a
+ * log-linear histogram with a relative error of about 6%, so percentiles
+ * are cheap to read and the memory cost is fixed. Without the definition,
+ * the push and pop paths carry no latency code at all, and these
+ * functions fail.
+ *
+ * @file circular_buffer/latency.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Preprocessor definitions
+#define CIRCULAR_BUFFER_LATENCY_SUB_BITS 5
+#define CIRCULAR_BUFFER_LATENCY_BUCKETS  ( ( 66 - CIRCULAR_BUFFER_LATENCY_SUB_BITS ) << ( CIRCULAR_BUFFER_LATENCY_SUB_BITS - 1 ) )
+
+// Mutators
+/** !
+ *  Start recording enqueue to dequeue latency. One in every 2^sample_shift
+ *  pushes is stamped, so a sample_shift of 0 records every element.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param sample_shift      the base two logarithm of the sampling interval
+ *
+ * @sa circular_buffer_latency_percentile
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_latency_enable ( circular_buffer *const p_circular_buffer, unsigned sample_shift );
+
+/** !
+ *  Discard the recorded samples
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_latency_reset ( circular_buffer *const p_circular_buffer );
+
+// Accessors
+/** !
+ *  Get the quantity of recorded samples
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param p_count           result
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_latency_count ( circular_buffer *const p_circular_buffer, size_t *p_count );
+
+/** !
+ *  Get a percentile of the recorded residence times, in timer_high_precision
+ *  units. The result is the upper bound of the bucket holding the
+ *  percentile, clamped to the largest recorded sample.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param percentile        the percentile, from 0 to 100. For example 50, 99 or 99.9.
+ * @param p_result          result
+ *
+ * @sa circular_buffer_latency_count
+ *
+ * @return 1 on success, 0 on error or if nothing was recorded
+ */
+DLLEXPORT int circular_buffer_latency_percentile ( circular_buffer *const p_circular_buffer, double percentile, timestamp *p_result );
@@ -0,0 +1,154 @@
+/** !
+ * Include header for the circular buffer lock
+ *
+ * The critical sections of a circular buffer are a handful of instructions,
+ * so a contended thread is usually better off spinning briefly than
+ * sleeping in the kernel. This lock spins with a pause instruction up to a
+ * per lock limit, then parks on a futex. Uncontended acquire and release
+ * are a single atomic instruction each and never enter the kernel. A spin
+ * limit of 0 parks immediately, like a mutex.
+ *
+ * Parking uses a futex on Linux. Other platforms yield the processor
+ * instead.
+ *
+ * @file circular_buffer/lock.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// Standard library
+#include <stdbool.h>
+
+// sync module
+#include <sync/sync.h>
+
+// circular buffer atomics
+#include <circular_buffer/atomic.h>
+
+// Platform dependent macros
+#ifndef DLLEXPORT
+	#ifdef _WIN64
+		#define DLLEXPORT extern __declspec(dllexport)
+	#else
+		#define DLLEXPORT
+	#endif
+#endif
+
+// Preprocessor definitions
+#define CIRCULAR_BUFFER_LOCK_DEFAULT_SPIN 128
+
+// Structure definitions
+struct circular_buffer_lock_s
+{
+	unsigned state; // 0 is unlocked, 1 is locked, 2 is locked with parked waiters
+	unsigned spin;  // Pause iterations before parking
+};
+
+// Type definitions
+/** !
+ *  @brief The type definition of a circular buffer lock struct
+ */
+typedef struct circular_buffer_lock_s circular_buffer_lock;
+
+// Function declarations
+/** !
+ * Acquire a contended lock. Spins, then parks.
+ *
+ * @param p_lock the lock
+ *
+ * @sa circular_buffer_lock_acquire
+ *
+ * @return void
+ */
+DLLEXPORT void circular_buffer_lock_wait ( circular_buffer_lock *const p_lock );
+
+/** !
+ * Wake one parked waiter
+ *
+ * @param p_lock the lock
+ *
+ * @sa circular_buffer_lock_release
+ *
+ * @return void
+ */
+DLLEXPORT void circular_buffer_lock_wake ( circular_buffer_lock *const p_lock );
+
+// Function definitions
+/** !
+ * Initialize an unlocked lock
+ *
+ * @param p_lock the lock
+ * @param spin   pause iterations before parking
+ *
+ * @return void
+ */
+static inline void circular_buffer_lock_init ( circular_buffer_lock *const p_lock, unsigned spin )
+{
+
+	// Populate the lock
+	p_lock->state = 0;
+	p_lock->spin  = spin;
+
+	// Done
+	return;
+}
+
+/** !
+ * Acquire a lock
+ *
+ * @param p_lock the lock
+ *
+ * @sa circular_buffer_lock_release
+ *
+ * @return void
+ */
+static inline void circular_buffer_lock_acquire ( circular_buffer_lock *const p_lock )
+{
+
+	// Fast path
+	if ( circular_buffer_atomic_compare_exchange_acquire(&p_lock->state, 0, 1) ) return;
+
+	// Contended
+	circular_buffer_lock_wait(p_lock);
+
+	// Done
+	return;
+}
+
+/** !
+ * Acquire a lock if it is free, without waiting
+ *
+ * @param p_lock the lock
+ *
+ * @sa circular_buffer_lock_acquire
+ *
+ * @return true if the lock was acquired, else false
+ */
+static inline bool circular_buffer_lock_try ( circular_buffer_lock *const p_lock )
+{
+
+	// Success
+	return circular_buffer_atomic_compare_exchange_acquire(&p_lock->state, 0, 1);
+}
+
+/** !
+ * Release a lock
+ *
+ * @param p_lock the lock
+ *
+ * @sa circular_buffer_lock_acquire
+ *
+ * @return void
+ */
+static inline void circular_buffer_lock_release ( circular_buffer_lock *const p_lock )
+{
+
+	// Unlock, and wake a waiter if any parked
+	if ( circular_buffer_atomic_exchange_release(&p_lock->state, 0) == 2 ) circular_buffer_lock_wake(p_lock);
+
+	// Done
+	return;
+}
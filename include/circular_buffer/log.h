@@ -0,0 +1,134 @@
+/** !
+ * Include header for asynchronous logs
+ *
+ * An asynchronous log moves formatting output and write system calls off
+ * the calling thread. Each thread that logs gets its own byte circular
+ * buffer on its first line, so callers only ever share a lock with the
+ * writer thread, never with each other. A writer thread drains every
+ * circular buffer in large batches with one write per batch, and keeps the
+ * most recent lines in memory so they can be dumped after a crash.
+ *
+ * A line is copied whole or not at all. Lines from one thread keep their
+ * order; lines from different threads are written one circular buffer at
+ * a time. When the writer falls behind and a circular buffer is full,
+ * lines are dropped and counted instead of blocking the caller. The
+ * circular buffer of an exited thread is drained, then reused by the next
+ * thread that logs.
+ *
+ * Only available on POSIX platforms.
+ *
+ * @file circular_buffer/log.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Preprocessor definitions
+#define CIRCULAR_BUFFER_LOG_DEFAULT_SIZE (1 << 20)
+#define CIRCULAR_BUFFER_LOG_LINE_MAX     512
+
+// Forward declarations
+struct circular_buffer_log_s;
+
+// Type definitions
+/** !
+ *  @brief The type definition of an asynchronous log struct
+ */
+typedef struct circular_buffer_log_s circular_buffer_log;
+
+#ifndef _WIN64
+
+// Constructors
+/** !
+ *  Open an asynchronous log and start its writer thread
+ *
+ * @param pp_log  return
+ * @param fd      the file descriptor to write to
+ * @param size    the capacity of the circular buffer of each thread in bytes, or 0 for CIRCULAR_BUFFER_LOG_DEFAULT_SIZE
+ * @param history the quantity of recent lines to keep for circular_buffer_log_dump, or 0 for none
+ *
+ * @sa circular_buffer_log_close
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_log_open ( circular_buffer_log **const pp_log, int fd, size_t size, size_t history );
+
+// Mutators
+/** !
+ *  Format a line into an asynchronous log. Lines longer than
+ *  CIRCULAR_BUFFER_LOG_LINE_MAX are truncated, keeping the trailing
+ *  newline of the format.
+ *
+ * @param p_log  the asynchronous log
+ * @param format the printf format string
+ * @param ...    the arguments
+ *
+ * @sa circular_buffer_log_write
+ *
+ * @return 1 on success, 0 if the line was dropped or on error
+ */
+DLLEXPORT int circular_buffer_log_printf ( circular_buffer_log *const p_log, const char *const format, ... );
+
+/** !
+ *  Copy a preformatted line into an asynchronous log
+ *
+ * @param p_log  the asynchronous log
+ * @param p_line the line
+ * @param size   the length of the line in bytes
+ *
+ * @sa circular_buffer_log_printf
+ *
+ * @return 1 on success, 0 if the line was dropped or on error
+ */
+DLLEXPORT int circular_buffer_log_write ( circular_buffer_log *const p_log, const char *const p_line, size_t size );
+
+/** !
+ *  Wait until every line logged before this call has been written
+ *
+ * @param p_log the asynchronous log
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_log_flush ( circular_buffer_log *const p_log );
+
+// Accessors
+/** !
+ *  Get the quantity of lines dropped because the circular buffer was full
+ *
+ * @param p_log the asynchronous log
+ *
+ * @return the quantity of dropped lines, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_log_dropped ( circular_buffer_log *const p_log );
+
+/** !
+ *  Write the most recent lines, oldest first. This takes no locks and only
+ *  calls write, so it may be called from a signal handler after a crash.
+ *  Lines still waiting in the circular buffer are not included.
+ *
+ * @param p_log the asynchronous log
+ * @param fd    the file descriptor to write to
+ *
+ * @return the quantity of lines written, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_log_dump ( circular_buffer_log *const p_log, int fd );
+
+// Destructors
+/** !
+ *  Write every remaining line, stop the writer thread and close an
+ *  asynchronous log. The file descriptor is not closed.
+ *
+ * @param pp_log pointer to the asynchronous log
+ *
+ * @sa circular_buffer_log_open
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_log_close ( circular_buffer_log **const pp_log );
+
+#endif
@@ -0,0 +1,64 @@
+/** !
+ * Include header for static tracepoints
+ *
+ * When CIRCULAR_BUFFER_PROBES is defined, the library carries USDT probes
+ * under the provider "circular_buffer", which bpftrace, perf and SystemTap
+ * can attach to by name. An unattached probe is a single nop, and its
+ * arguments are read from registers and memory already in use. Without
+ * CIRCULAR_BUFFER_PROBES, or where <sys/sdt.h> is missing, every probe
+ * compiles to nothing. The inline hot path fires the same probes from the
+ * program that includes it, so programs built with CIRCULAR_BUFFER_INLINE
+ * carry them only when they define CIRCULAR_BUFFER_PROBES too.
+ *
+ * Probes
+ *   push           (circular_buffer *, size_t count, size_t capacity)
+ *   pop            (circular_buffer *, size_t count, size_t capacity)
+ *   pop_batch      (circular_buffer *, size_t popped, size_t count)
+ *   overflow       (circular_buffer *, void *p_overwritten, size_t capacity)
+ *   spill          (circular_buffer *, size_t spilled)
+ *   evict          (circular_buffer *, void *p_evicted, size_t size, size_t bytes)
+ *   drain          (circular_buffer *, size_t drained)
+ *   write          (circular_buffer *, size_t written, size_t used)
+ *   read           (circular_buffer *, size_t read, size_t used)
+ *   lock_contended (circular_buffer_lock *, unsigned spin)
+ *   lock_park      (circular_buffer_lock *)
+ *
+ * The count is the occupancy after the operation, and spilled is the
+ * quantity of elements already in the spill log. Byte circular buffers
+ * fire write and read with the bytes moved and the bytes in use after.
+ * Lock probes carry the address of the lock, which is the _lock member of
+ * its circular buffer.
+ *
+ * @file circular_buffer/probes.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// Fall back to no-ops where the header is missing
+#if defined(CIRCULAR_BUFFER_PROBES) && defined(__has_include)
+	#if !__has_include(<sys/sdt.h>)
+		#undef CIRCULAR_BUFFER_PROBES
+	#endif
+#endif
+
+#ifdef CIRCULAR_BUFFER_PROBES
+
+	// Platform dependent includes
+	#include <sys/sdt.h>
+
+	// Probes
+	#define CIRCULAR_BUFFER_PROBE1(name, a)          DTRACE_PROBE1(circular_buffer, name, a)
+	#define CIRCULAR_BUFFER_PROBE2(name, a, b)       DTRACE_PROBE2(circular_buffer, name, a, b)
+	#define CIRCULAR_BUFFER_PROBE3(name, a, b, c)    DTRACE_PROBE3(circular_buffer, name, a, b, c)
+	#define CIRCULAR_BUFFER_PROBE4(name, a, b, c, d) DTRACE_PROBE4(circular_buffer, name, a, b, c, d)
+#else
+
+	// No-ops. The arguments are not evaluated.
+	#define CIRCULAR_BUFFER_PROBE1(name, a)          ( (void) 0 )
+	#define CIRCULAR_BUFFER_PROBE2(name, a, b)       ( (void) 0 )
+	#define CIRCULAR_BUFFER_PROBE3(name, a, b, c)    ( (void) 0 )
+	#define CIRCULAR_BUFFER_PROBE4(name, a, b, c, d) ( (void) 0 )
+#endif
@@ -0,0 +1,85 @@
+/** !
+ * Include header for circular buffer producer handles
+ *
+ * A producer handle stages pushes in a small private array and moves them
+ * into the shared circular buffer with one lock acquisition when the
+ * array fills, when the oldest staged value has waited max_delay, or on
+ * an explicit flush. This trades a bounded delay for far less traffic on
+ * the shared lock and indices.
+ *
+ * A handle belongs to one thread. The delay is only checked when that
+ * thread pushes, so a producer that goes idle should flush.
+ *
+ * @file circular_buffer/producer.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Preprocessor definitions
+#define CIRCULAR_BUFFER_PRODUCER_DEFAULT_SIZE 32
+
+// Forward declarations
+struct circular_buffer_producer_s;
+
+// Type definitions
+/** !
+ *  @brief The type definition of a circular buffer producer struct
+ */
+typedef struct circular_buffer_producer_s circular_buffer_producer;
+
+// Constructors
+/** !
+ *  Open a producer handle on a circular buffer
+ *
+ * @param pp_producer       return
+ * @param p_circular_buffer the shared circular buffer
+ * @param size              the quantity of values to stage, or 0 for CIRCULAR_BUFFER_PRODUCER_DEFAULT_SIZE
+ * @param max_delay         the longest a value may be staged, in timer_high_precision units, or 0 for no limit
+ *
+ * @sa circular_buffer_producer_close
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_producer_open ( circular_buffer_producer **const pp_producer, circular_buffer *const p_circular_buffer, size_t size, timestamp max_delay );
+
+// Mutators
+/** !
+ *  Stage a value, flushing if the stage fills or its oldest value is due
+ *
+ * @param p_producer the producer handle
+ * @param p_data     the value
+ *
+ * @sa circular_buffer_producer_flush
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_producer_push ( circular_buffer_producer *const p_producer, void *p_data );
+
+/** !
+ *  Move every staged value into the shared circular buffer
+ *
+ * @param p_producer the producer handle
+ *
+ * @sa circular_buffer_push_batch
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_producer_flush ( circular_buffer_producer *const p_producer );
+
+// Destructors
+/** !
+ *  Flush and close a producer handle
+ *
+ * @param pp_producer the producer handle
+ *
+ * @sa circular_buffer_producer_open
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_producer_close ( circular_buffer_producer **const pp_producer );
@@ -0,0 +1,161 @@
+/** !
+ * Include header for sample circular buffers
+ *
+ * A sample circular buffer is a delay line for a stream of numbers. It
+ * stores float, double or int16_t samples by value instead of as pointers,
+ * and writes each sample twice, once in each half of a storage block twice
+ * the size of the window. The most recent samples are therefore always one
+ * contiguous span, oldest first, with no wrap point, so the window kernels
+ * below run straight vector loops over it.
+ *
+ * Kernels take a width, the quantity of most recent samples to cover. A
+ * width of 0 covers every sample in the window. Results are returned as
+ * double regardless of the sample type.
+ *
+ * @file circular_buffer/samples.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// Standard library
+#include <stdint.h>
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Enumeration definitions
+enum circular_buffer_sample_type_e
+{
+	CIRCULAR_BUFFER_SAMPLE_FLOAT  = 1,
+	CIRCULAR_BUFFER_SAMPLE_DOUBLE = 2,
+	CIRCULAR_BUFFER_SAMPLE_INT16  = 3
+};
+
+// Forward declarations
+struct circular_buffer_samples_s;
+
+// Type definitions
+/** !
+ *  @brief The type definition of a sample type
+ */
+typedef enum circular_buffer_sample_type_e circular_buffer_sample_type;
+
+/** !
+ *  @brief The type definition of a sample circular buffer struct
+ */
+typedef struct circular_buffer_samples_s circular_buffer_samples;
+
+// Constructors
+/** !
+ *  Construct a sample circular buffer
+ *
+ * @param pp_samples return
+ * @param type       the sample type
+ * @param size       the quantity of samples in the window
+ *
+ * @sa circular_buffer_samples_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_samples_construct ( circular_buffer_samples **const pp_samples, circular_buffer_sample_type type, size_t size );
+
+// Accessors
+/** !
+ *  Get the quantity of samples in the window
+ *
+ * @param p_samples the sample circular buffer
+ *
+ * @return the quantity of samples, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_samples_count ( circular_buffer_samples *const p_samples );
+
+/** !
+ *  Get the most recent samples as one contiguous span, oldest first. The
+ *  span is only valid until the next push.
+ *
+ * @param p_samples  the sample circular buffer
+ * @param width      the quantity of most recent samples, or 0 for every sample
+ * @param pp_samples result
+ *
+ * @return 1 on success, 0 if the window holds fewer than width samples or on error
+ */
+DLLEXPORT int circular_buffer_samples_window ( circular_buffer_samples *const p_samples, size_t width, const void **pp_samples );
+
+/** !
+ *  Apply FIR taps to the most recent samples. Taps are given oldest first,
+ *  which is the impulse response reversed, so taps[width - 1] weights the
+ *  newest sample. Taps have the same type as the samples.
+ *
+ * @param p_samples the sample circular buffer
+ * @param p_taps    the taps
+ * @param width     the quantity of taps
+ * @param p_result  result
+ *
+ * @return 1 on success, 0 if the window holds fewer than width samples or on error
+ */
+DLLEXPORT int circular_buffer_samples_dot ( circular_buffer_samples *const p_samples, const void *p_taps, size_t width, double *p_result );
+
+/** !
+ *  Get the moving average of the most recent samples
+ *
+ * @param p_samples the sample circular buffer
+ * @param width     the quantity of most recent samples, or 0 for every sample
+ * @param p_result  result
+ *
+ * @sa circular_buffer_samples_rms
+ *
+ * @return 1 on success, 0 if the window holds fewer than width samples, is empty, or on error
+ */
+DLLEXPORT int circular_buffer_samples_mean ( circular_buffer_samples *const p_samples, size_t width, double *p_result );
+
+/** !
+ *  Get the root mean square of the most recent samples
+ *
+ * @param p_samples the sample circular buffer
+ * @param width     the quantity of most recent samples, or 0 for every sample
+ * @param p_result  result
+ *
+ * @sa circular_buffer_samples_mean
+ *
+ * @return 1 on success, 0 if the window holds fewer than width samples, is empty, or on error
+ */
+DLLEXPORT int circular_buffer_samples_rms ( circular_buffer_samples *const p_samples, size_t width, double *p_result );
+
+/** !
+ *  Get the smallest and largest of the most recent samples
+ *
+ * @param p_samples the sample circular buffer
+ * @param width     the quantity of most recent samples, or 0 for every sample
+ * @param p_min     result. May be null.
+ * @param p_max     result. May be null.
+ *
+ * @return 1 on success, 0 if the window holds fewer than width samples, is empty, or on error
+ */
+DLLEXPORT int circular_buffer_samples_min_max ( circular_buffer_samples *const p_samples, size_t width, double *p_min, double *p_max );
+
+// Mutators
+/** !
+ *  Append samples, evicting the oldest samples once the window is full
+ *
+ * @param p_samples the sample circular buffer
+ * @param p_data    the samples, of the sample type
+ * @param count     the quantity of samples
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_samples_push ( circular_buffer_samples *const p_samples, const void *p_data, size_t count );
+
+// Destructors
+/** !
+ *  Destroy a sample circular buffer
+ *
+ * @param pp_samples pointer to the sample circular buffer
+ *
+ * @sa circular_buffer_samples_construct
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_samples_destroy ( circular_buffer_samples **const pp_samples );
@@ -0,0 +1,77 @@
+/** !
+ * Include header for the circular buffer spill tier
+ *
+ * Once a spill log is attached, pushes to a full circular buffer are
+ * serialized to a sequential on disk log instead of overwriting the oldest
+ * element. Every later push also goes to the log until it drains, so
+ * elements are always popped in the order they were pushed. When the
+ * circular buffer empties, pop and peek read the log back in a batch. The
+ * log is read and deserialized without the lock, so producers are not held
+ * up by disk reads. Elements the deserializer returns a null pointer for
+ * are dropped and counted.
+ *
+ * @file circular_buffer/spill.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Type definitions
+/** !
+ *  @brief Serialize an element into a buffer. Return the quantity of bytes
+ *         the element needs; if that exceeds size, the function is called
+ *         again with a larger buffer.
+ */
+typedef size_t (fn_circular_buffer_serialize)( void *p_element, void *p_buffer, size_t size, void *p_context );
+
+/** !
+ *  @brief Rebuild an element from the bytes written by the serializer
+ */
+typedef void *(fn_circular_buffer_deserialize)( const void *p_buffer, size_t size, void *p_context );
+
+// Mutators
+/** !
+ *  Attach a spill log to a circular buffer. The log is removed when the
+ *  circular buffer is destroyed. Byte budgeted circular buffers evict
+ *  instead, and can not have a spill log.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param p_path            the path of the log file. It is truncated.
+ * @param pfn_serialize     serializes an element
+ * @param pfn_deserialize   deserializes an element
+ * @param p_context         passed to the serializer and deserializer
+ *
+ * @sa circular_buffer_spill_count
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_spill_attach ( circular_buffer *const p_circular_buffer, const char *p_path, fn_circular_buffer_serialize *pfn_serialize, fn_circular_buffer_deserialize *pfn_deserialize, void *p_context );
+
+// Accessors
+/** !
+ *  Get the quantity of elements in the spill log
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @sa circular_buffer_spill_attach
+ *
+ * @return the quantity of elements on disk, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_spill_count ( circular_buffer *const p_circular_buffer );
+
+/** !
+ *  Get the quantity of spilled elements the deserializer returned a null
+ *  pointer for. Those elements are dropped instead of being popped.
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @sa circular_buffer_spill_attach
+ *
+ * @return the quantity of dropped elements, 0 on error
+ */
+DLLEXPORT size_t circular_buffer_spill_dropped ( circular_buffer *const p_circular_buffer );
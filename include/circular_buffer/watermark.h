@@ -0,0 +1,58 @@
+/** !
+ * Include header for circular buffer watermarks
+ *
+ * A circular buffer can report when its occupancy reaches a high watermark
+ * and when it falls back to a low watermark, so producers can slow down
+ * before values are overwritten. The gap between the watermarks is the
+ * hysteresis: after the high watermark is reached, nothing more is
+ * reported until the occupancy falls to the low watermark, and the other
+ * way around. Byte circular buffers count bytes.
+ *
+ * @file circular_buffer/watermark.h
+ *
+ * @author Jacob Smith
+ */
+
+// Include guard
+#pragma once
+
+// circular buffer
+#include <circular_buffer/circular_buffer.h>
+
+// Type definitions
+/** !
+ *  @brief The type definition of a function called when a watermark is
+ *         crossed. It runs with the lock held, so it must not call into the
+ *         same circular buffer; record the state and act on it afterwards.
+ */
+typedef void (fn_circular_buffer_watermark)( circular_buffer *p_circular_buffer, bool pressure, void *p_context );
+
+// Mutators
+/** !
+ *  Set the high and low watermarks of a circular buffer. The pressure state
+ *  starts clear, and is reevaluated on the next push or pop.
+ *
+ * @param p_circular_buffer the circular buffer
+ * @param high              pressure starts when the occupancy reaches this. 0 removes the watermarks.
+ * @param low               pressure ends when the occupancy falls to this. Must be less than high.
+ * @param pfn_watermark     called with true at the high watermark and false at the low watermark, or null
+ * @param p_context         passed to pfn_watermark
+ *
+ * @sa circular_buffer_under_pressure
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int circular_buffer_set_watermarks ( circular_buffer *const p_circular_buffer, size_t high, size_t low, fn_circular_buffer_watermark *pfn_watermark, void *p_context );
+
+// Accessors
+/** !
+ *  Check if a circular buffer has reached its high watermark and not yet
+ *  fallen back to its low watermark, without taking the lock
+ *
+ * @param p_circular_buffer the circular buffer
+ *
+ * @sa circular_buffer_set_watermarks
+ *
+ * @return true if under pressure, else false
+ */
+DLLEXPORT bool circular_buffer_under_pressure ( circular_buffer *const p_circular_buffer );
@@ -8,12 +8,23 @@
 
 // Standard library
 #include <stdio.h>
-
-// log module
-#include <log/log.h>
+#include <stdlib.h>
 
 // circular buffer 
 #include <circular_buffer/circular_buffer.h>
+#include <circular_buffer/log.h>
+
+// Platform dependent includes
+#ifndef _WIN64
+	#include <unistd.h>
+#endif
+
+// Preprocessor definitions
+#ifndef _WIN64
+	#define example_printf(p_log, ...) circular_buffer_log_printf(p_log, __VA_ARGS__)
+#else
+	#define example_printf(p_log, ...) printf(__VA_ARGS__)
+#endif
 
 // Entry point
 int main ( int argc, const char *argv[] )
@@ -24,17 +35,23 @@ int main ( int argc, const char *argv[] )
 	(void) argv;
 
 	// Initialized data
-	circular_buffer   *p_circular_buffer = 0;
-	const void *const  _p_contents[]     = { "First!", "Second!", "Third!", "Fourth!", "Fifth!", "Sixth!" };
+	circular_buffer     *p_circular_buffer = 0;
+	circular_buffer_log *p_log             = 0;
+	const void *const    _p_contents[]     = { "First!", "Second!", "Third!", "Fourth!", "Fifth!", "Sixth!" };
+
+	// Write output from a background thread
+	#ifndef _WIN64
+		if ( circular_buffer_log_open(&p_log, STDOUT_FILENO, 0, 0) == 0 ) return EXIT_FAILURE;
+	#endif
 
 	// Log
-	log_info("Creating a circular buffer\n");
+	example_printf(p_log, "Creating a circular buffer\n");
 
 	// Construct a circular buffer
 	circular_buffer_from_contents(&p_circular_buffer, _p_contents, (sizeof(_p_contents) / sizeof(char *)));
 	
 	// Log
-	log_info("\nDumping contents of circular buffer\n\n");
+	example_printf(p_log, "\nDumping contents of circular buffer\n\n");
 
 	// Dump the contents of the circular buffer
 	while ( circular_buffer_empty(p_circular_buffer) == false )
@@ -47,9 +64,16 @@ int main ( int argc, const char *argv[] )
 		circular_buffer_pop(p_circular_buffer, &p_data);
 
 		// Print the value to standard out
-		printf("\"%s\"\n", (const char *)p_data);
+		example_printf(p_log, "\"%s\"\n", (const char *)p_data);
 	}
 
+	// Write the remaining output
+	#ifndef _WIN64
+		circular_buffer_log_close(&p_log);
+	#else
+		(void) p_log;
+	#endif
+
 	// Success
 	return EXIT_SUCCESS;
 }
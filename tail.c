@@ -1,57 +1,669 @@
 /** !
- * tail - output the last part of a file
- * 
+ * tail - output the last part of files
+ *
+ * tail [-n lines] [-j threads] [-m] [file ...]
+ *
+ * Files are processed concurrently by a pool of threads. With no file, or
+ * where a file is -, standard input is read. Seekable files, including a
+ * redirected standard input, are scanned backward from the end in large
+ * blocks, so only the tail is ever read. Pipes and terminals keep the most
+ * recent lines in a circular buffer. With -m, the tails of every file are merged into one
+ * stream ordered by the first field of each line, compared as text, which
+ * orders ISO 8601 and other fixed width timestamps. Output goes out in
+ * large buffered writes.
+ *
  * @file tail.c
- * 
+ *
  * @author Jacob Smith
  */
 
+// Feature test macros
+#define _POSIX_C_SOURCE 200809L
+
 // Standard library
+#include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Platform dependent includes
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // log module
 #include <log/log.h>
 
-// circular buffer 
+// circular buffer
 #include <circular_buffer/circular_buffer.h>
+#include <circular_buffer/log.h>
+
+// Preprocessor definitions
+#define TAIL_DEFAULT_LINES 10
+#define TAIL_BLOCK_SIZE    65536
+#define TAIL_OUTPUT_SIZE   ( 1 << 20 )
+
+// Structure definitions
+struct tail_file_s
+{
+	const char *p_path;
+	char       *p_text;
+	size_t      size, lines, cursor;
+	size_t     *_p_starts, *_p_lengths;
+	bool        failed, terminated;
+};
+
+struct tail_s
+{
+	struct tail_file_s  *_p_files;
+	size_t               files, lines, next;
+	circular_buffer_log *p_log;
+};
+
+// Function declarations
+/** !
+ * Read the last lines of a seekable file by scanning backward for newlines
+ *
+ * @param p_file the file
+ * @param fd     the file descriptor
+ * @param size   the size of the file in bytes
+ * @param lines  the quantity of lines
+ *
+ * @return 1 on success, 0 on error
+ */
+int tail_scan ( struct tail_file_s *p_file, int fd, off_t size, size_t lines );
+
+/** !
+ * Read the last lines of a stream by keeping them in a circular buffer
+ *
+ * @param p_file the file
+ * @param p_f    the stream
+ * @param lines  the quantity of lines
+ *
+ * @return 1 on success, 0 on error
+ */
+int tail_ring ( struct tail_file_s *p_file, FILE *p_f, size_t lines );
+
+/** !
+ * Find the start and length of each line of text
+ *
+ * @param p_file the file
+ *
+ * @return 1 on success, 0 on error
+ */
+int tail_split ( struct tail_file_s *p_file );
+
+/** !
+ * Read the last lines of a file
+ *
+ * @param p_file the file
+ * @param lines  the quantity of lines
+ *
+ * @return 1 on success, 0 on error
+ */
+int tail_file ( struct tail_file_s *p_file, size_t lines );
+
+/** !
+ * Take files from the shared index until none are left
+ *
+ * @param p_parameter the tail
+ *
+ * @return null
+ */
+void *tail_worker ( void *p_parameter );
+
+/** !
+ * Order two lines by their first field
+ *
+ * @param p_a the first file, at its cursor
+ * @param p_b the second file, at its cursor
+ *
+ * @return true if the line of the first file goes first, else false
+ */
+bool tail_before ( const struct tail_file_s *p_a, const struct tail_file_s *p_b );
+
+/** !
+ * Write the tails of every file, merged into one stream with a heap
+ *
+ * @param p_tail the tail
+ *
+ * @return void
+ */
+void tail_merge ( struct tail_s *p_tail );
+
+/** !
+ * Print a usage message
+ *
+ * @param p_program the name of the program
+ *
+ * @return void
+ */
+void tail_usage ( const char *p_program );
 
 // Entry point
 int main ( int argc, const char *argv[] )
 {
 
-	// Supress compiler warnings
-	(void) argc;
-	(void) argv;
+	// Initialized data
+	struct tail_s       _tail     = { .lines = TAIL_DEFAULT_LINES };
+	struct tail_file_s  _stdin    = { .p_path = "-" };
+	pthread_t          *_p_pool   = (void *) 0;
+	size_t              threads   = 0,
+	                    started   = 1,
+	                    first     = 0;
+	bool                merge     = false,
+	                    failed    = false;
+	static char         _output[TAIL_OUTPUT_SIZE];
+
+	// Parse the options
+	for (first = 1; first < (size_t) argc && argv[first][0] == '-' && argv[first][1]; first++)
+	{
+
+		// Initialized data
+		const char *p_option = argv[first];
+		const char *p_value  = (void *) 0;
+		char       *p_end    = (void *) 0;
+		size_t      value    = 0;
+
+		// End of options
+		if ( strcmp(p_option, "--") == 0 ) { first++; break; }
+
+		// Merge
+		if ( strcmp(p_option, "-m") == 0 ) { merge = true; continue; }
+
+		// Options with a value, either attached or in the next argument
+		if ( ( p_option[1] == 'n' || p_option[1] == 'j' ) )
+		{
+			p_value = ( p_option[2] ) ? &p_option[2] : ( first + 1 < (size_t) argc ) ? argv[++first] : (void *) 0;
+			if ( p_value == (void *) 0 ) goto bad_usage;
+
+			// Only digits. strtoull would skip spaces and wrap a leading minus.
+			if ( *p_value < '0' || *p_value > '9' ) goto bad_usage;
+			errno = 0;
+			value = strtoull(p_value, &p_end, 10);
+			if ( *p_end != '\0' || errno == ERANGE ) goto bad_usage;
+
+			// Store the value
+			if ( p_option[1] == 'n' ) _tail.lines = value;
+			else                      threads     = value;
+			continue;
+		}
+
+		// Unknown option
+		goto bad_usage;
+	}
+
+	// Large buffered writes
+	setvbuf(stdout, _output, _IOFBF, sizeof(_output));
+
+	// Nothing to do
+	if ( _tail.lines == 0 ) return EXIT_SUCCESS;
+
+	// No files, so read standard input
+	if ( first == (size_t) argc )
+	{
+
+		// Read the last lines
+		if ( tail_file(&_stdin, _tail.lines) == 0 ) return EXIT_FAILURE;
+
+		// Write them
+		for (size_t i = 0; i < _stdin.lines; i++)
+		{
+			fwrite(_stdin.p_text + _stdin._p_starts[i], 1, _stdin._p_lengths[i], stdout);
+			if ( i + 1 < _stdin.lines || _stdin.terminated ) fputc('\n', stdout);
+		}
+
+		// Success
+		return EXIT_SUCCESS;
+	}
+
+	// Allocate the files
+	_tail.files    = (size_t) argc - first;
+	_tail._p_files = calloc(_tail.files, sizeof(struct tail_file_s));
+	if ( _tail._p_files == (void *) 0 ) goto no_mem;
+	for (size_t i = 0; i < _tail.files; i++) _tail._p_files[i].p_path = argv[first + i];
+
+	// Report failures from a background thread
+	if ( circular_buffer_log_open(&_tail.p_log, STDERR_FILENO, 0, 0) == 0 ) goto failed_to_open_log;
+
+	// Default to one thread per processor
+	if ( threads == 0 ) threads = (size_t) sysconf(_SC_NPROCESSORS_ONLN);
+	if ( threads == 0 ) threads = 1;
+	if ( threads > _tail.files ) threads = _tail.files;
+
+	// Start the pool
+	_p_pool = calloc(threads, sizeof(pthread_t));
+	if ( _p_pool == (void *) 0 ) goto no_mem;
+	for (; started < threads; started++)
+		if ( pthread_create(&_p_pool[started], (void *) 0, tail_worker, &_tail) ) break;
+
+	// Work alongside the pool. If some threads failed to start, the rest
+	// take their share of the files.
+	tail_worker(&_tail);
+
+	// Wait for the threads that started
+	for (size_t i = 1; i < started; i++) pthread_join(_p_pool[i], (void *) 0);
+
+	// Write the failures reported by the pool
+	circular_buffer_log_close(&_tail.p_log);
+
+	// Any failure fails the whole run
+	for (size_t i = 0; i < _tail.files; i++) failed |= _tail._p_files[i].failed;
+
+	// Merge by timestamp
+	if ( merge ) tail_merge(&_tail);
+
+	// Or write each file in turn
+	else for (size_t i = 0; i < _tail.files; i++)
+	{
+
+		// Initialized data
+		struct tail_file_s *p_file = &_tail._p_files[i];
+
+		// Skip files that failed
+		if ( p_file->failed ) continue;
+
+		// Header
+		if ( _tail.files > 1 ) printf("%s==> %s <==\n", ( i ) ? "\n" : "", ( strcmp(p_file->p_path, "-") ) ? p_file->p_path : "standard input");
+
+		// Lines
+		for (size_t j = 0; j < p_file->lines; j++)
+		{
+			fwrite(p_file->p_text + p_file->_p_starts[j], 1, p_file->_p_lengths[j], stdout);
+			if ( j + 1 < p_file->lines || p_file->terminated ) fputc('\n', stdout);
+		}
+	}
+
+	// Flush
+	fflush(stdout);
+
+	// Clean up
+	for (size_t i = 0; i < _tail.files; i++)
+	{
+		free(_tail._p_files[i].p_text);
+		free(_tail._p_files[i]._p_starts);
+		free(_tail._p_files[i]._p_lengths);
+	}
+	free(_tail._p_files);
+	free(_p_pool);
+
+	// Done
+	return ( failed ) ? EXIT_FAILURE : EXIT_SUCCESS;
+
+	// Error handling
+	{
+
+		// Argument errors
+		{
+			bad_usage:
+
+				// Print a usage message
+				tail_usage(argv[0]);
+
+				// Error
+				return EXIT_FAILURE;
+		}
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return EXIT_FAILURE;
+
+			failed_to_open_log:
+				#ifndef NDEBUG
+					log_error("[tail] Failed to open log in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Error
+				return EXIT_FAILURE;
+		}
+	}
+}
+
+int tail_scan ( struct tail_file_s *p_file, int fd, off_t size, size_t lines )
+{
+
+	// Initialized data
+	static _Thread_local char _block[TAIL_BLOCK_SIZE];
+	off_t                     end     = size,
+	                          start   = 0;
+	size_t                    found   = 0;
+	bool                      located = false;
+
+	// A final newline ends the last line rather than starting another, so
+	// the scan starts before it. It is still read, so tail_split sees it.
+	if ( size > 0 && pread(fd, _block, 1, size - 1) == 1 && _block[0] == '\n' ) end--;
+
+	// Scan backward for the newline before the first wanted line
+	for (off_t pos = end; pos > 0 && located == false; )
+	{
+
+		// Initialized data
+		size_t  length = ( pos < TAIL_BLOCK_SIZE ) ? (size_t) pos : TAIL_BLOCK_SIZE;
+		ssize_t got    = 0;
+
+		// Read the block before the position
+		pos -= (off_t) length;
+		got  = pread(fd, _block, length, pos);
+		if ( got != (ssize_t) length ) return 0;
+
+		// Count newlines from the end of the block
+		for (size_t i = length; i-- > 0; )
+		{
+			if ( _block[i] != '\n' ) continue;
+			if ( ++found < lines ) continue;
+			start   = pos + (off_t) i + 1;
+			located = true;
+			break;
+		}
+	}
+
+	// Allocate memory for the tail
+	p_file->size   = (size_t) ( size - start );
+	p_file->p_text = malloc(p_file->size + 1);
+	if ( p_file->p_text == (void *) 0 ) return 0;
+
+	// Read the tail in one go
+	for (size_t done = 0; done < p_file->size; )
+	{
+
+		// Initialized data
+		ssize_t got = pread(fd, p_file->p_text + done, p_file->size - done, start + (off_t) done);
+
+		// Error check
+		if ( got <= 0 ) return 0;
+
+		// Advance
+		done += (size_t) got;
+	}
+
+	// Success
+	return tail_split(p_file);
+}
+
+int tail_ring ( struct tail_file_s *p_file, FILE *p_f, size_t lines )
+{
 
 	// Initialized data
-	circular_buffer *p_circular_buffer = 0;
+	circular_buffer *p_circular_buffer = (void *) 0;
+	char            *p_line            = (void *) 0,
+	                *p_oldest          = (void *) 0;
+	size_t           capacity          = 0,
+	                 total             = 0;
+	ssize_t          length            = 0;
 
 	// Construct a circular buffer
-	circular_buffer_construct(&p_circular_buffer, 10);
+	if ( circular_buffer_construct(&p_circular_buffer, lines) == 0 ) return 0;
 
-    
-	while ( !feof(stdin) )
+	// Keep the most recent lines
+	while ( ( length = getline(&p_line, &capacity, p_f) ) > 0 )
 	{
-		
 
-		// Pop the value
-		// /circular_buffer_push(p_circular_buffer, &p_data);
+		// Drop the oldest line before it is overwritten
+		if ( circular_buffer_full(p_circular_buffer) && circular_buffer_pop(p_circular_buffer, (void **) &p_oldest) )
+			total -= strlen(p_oldest), free(p_oldest);
+
+		// Keep the line
+		circular_buffer_push(p_circular_buffer, p_line);
+		total += (size_t) length;
+
+		// The circular buffer owns the line now
+		p_line   = (void *) 0;
+		capacity = 0;
+	}
+	free(p_line);
+
+	// Allocate memory for the tail, with room for a final newline
+	p_file->p_text = malloc(total + 1);
+	if ( p_file->p_text == (void *) 0 ) goto no_mem;
+
+	// Join the lines
+	while ( circular_buffer_pop(p_circular_buffer, (void **) &p_oldest) )
+	{
+		size_t size = strlen(p_oldest);
+		memcpy(p_file->p_text + p_file->size, p_oldest, size);
+		p_file->size += size;
+		free(p_oldest);
+	}
+
+	// Destroy the circular buffer
+	circular_buffer_destroy(&p_circular_buffer);
+
+	// Success
+	return tail_split(p_file);
+
+	// Error handling
+	{
+
+		// Standard library errors
+		{
+			no_mem:
+				#ifndef NDEBUG
+					log_error("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+				#endif
+
+				// Free every line still in the circular buffer
+				while ( circular_buffer_pop(p_circular_buffer, (void **) &p_oldest) ) free(p_oldest);
+
+				// Destroy the circular buffer
+				circular_buffer_destroy(&p_circular_buffer);
+
+				// Error
+				return 0;
+		}
 	}
+}
+
+int tail_split ( struct tail_file_s *p_file )
+{
+
+	// Initialized data
+	size_t count = ( p_file->size ) ? 1 : 0;
+
+	// A final newline ends the last line rather than starting another.
+	// Remember it, so the output only ends with a newline if the input did.
+	p_file->terminated = ( p_file->size && p_file->p_text[p_file->size - 1] == '\n' );
+	if ( p_file->terminated ) p_file->size--;
 
-	// Dump the contents of the circular buffer
-	while ( circular_buffer_empty(p_circular_buffer) == false )
+	// Count the lines
+	for (const char *p = p_file->p_text, *p_end = p_file->p_text + p_file->size; ( p = memchr(p, '\n', (size_t) ( p_end - p )) ); p++) count++;
+
+	// Allocate memory for the lines
+	p_file->_p_starts  = malloc(( count + 1 ) * sizeof(size_t));
+	p_file->_p_lengths = malloc(( count + 1 ) * sizeof(size_t));
+	if ( p_file->_p_starts == (void *) 0 || p_file->_p_lengths == (void *) 0 ) return 0;
+
+	// Record each line
+	for (size_t start = 0; p_file->lines < count; )
 	{
-		
+
 		// Initialized data
-		void *p_data = (void *) 0;
+		const char *p_newline = memchr(p_file->p_text + start, '\n', p_file->size - start);
+		size_t      end       = ( p_newline ) ? (size_t) ( p_newline - p_file->p_text ) : p_file->size;
 
-		// Pop the value
-		circular_buffer_pop(p_circular_buffer, &p_data);
+		// Store the line
+		p_file->_p_starts [p_file->lines] = start;
+		p_file->_p_lengths[p_file->lines] = end - start;
+		p_file->lines++;
 
-		// Print the value to standard out
-		printf("\"%s\"\n", (const char *)p_data);
+		// Next line
+		start = end + 1;
 	}
 
 	// Success
-	return EXIT_SUCCESS;
+	return 1;
+}
+
+int tail_file ( struct tail_file_s *p_file, size_t lines )
+{
+
+	// Initialized data
+	struct stat  _stat = { 0 };
+	int          fd    = ( strcmp(p_file->p_path, "-") == 0 ) ? dup(STDIN_FILENO) : open(p_file->p_path, O_RDONLY),
+	             ret   = 0;
+	FILE        *p_f   = (void *) 0;
+
+	// Error check
+	if ( fd == -1 ) return 0;
+
+	// Seekable files are scanned backward
+	if ( fstat(fd, &_stat) == 0 && S_ISREG(_stat.st_mode) )
+	{
+		ret = tail_scan(p_file, fd, _stat.st_size, lines);
+		close(fd);
+		return ret;
+	}
+
+	// Everything else goes through the circular buffer
+	p_f = fdopen(fd, "r");
+	if ( p_f == (void *) 0 ) return close(fd), 0;
+	ret = tail_ring(p_file, p_f, lines);
+	fclose(p_f);
+
+	// Done
+	return ret;
+}
+
+void *tail_worker ( void *p_parameter )
+{
+
+	// Initialized data
+	struct tail_s *p_tail = p_parameter;
+	size_t         i      = 0;
+
+	// Take the next file
+	while ( ( i = __atomic_fetch_add(&p_tail->next, 1, __ATOMIC_RELAXED) ) < p_tail->files )
+	{
+
+		// Read the last lines
+		p_tail->_p_files[i].failed = ( tail_file(&p_tail->_p_files[i], p_tail->lines) == 0 );
+
+		// Report the failure without stopping for a write
+		if ( p_tail->_p_files[i].failed ) circular_buffer_log_printf(p_tail->p_log, "[tail] Failed to read \"%s\"\n", p_tail->_p_files[i].p_path);
+	}
+
+	// Done
+	return (void *) 0;
+}
+
+bool tail_before ( const struct tail_file_s *p_a, const struct tail_file_s *p_b )
+{
+
+	// Initialized data
+	const char *p_x = p_a->p_text + p_a->_p_starts[p_a->cursor],
+	           *p_y = p_b->p_text + p_b->_p_starts[p_b->cursor];
+	size_t      x   = 0,
+	            y   = 0;
+	int         c   = 0;
+
+	// Length of the first field of each line
+	while ( x < p_a->_p_lengths[p_a->cursor] && p_x[x] != ' ' && p_x[x] != '\t' ) x++;
+	while ( y < p_b->_p_lengths[p_b->cursor] && p_y[y] != ' ' && p_y[y] != '\t' ) y++;
+
+	// Compare the fields as text
+	c = memcmp(p_x, p_y, ( x < y ) ? x : y);
+	if ( c ) return c < 0;
+
+	// A shorter field goes first, and ties keep the order of the files
+	if ( x != y ) return x < y;
+	return p_a < p_b;
+}
+
+void tail_merge ( struct tail_s *p_tail )
+{
+
+	// Initialized data
+	struct tail_file_s **_pp_heap = malloc(p_tail->files * sizeof(struct tail_file_s *));
+	size_t               count    = 0;
+
+	// Error check
+	if ( _pp_heap == (void *) 0 ) return;
+
+	// Add every file that has lines, keeping the heap ordered
+	for (size_t i = 0; i < p_tail->files; i++)
+	{
+
+		// Initialized data
+		struct tail_file_s *p_file = &p_tail->_p_files[i];
+		size_t              child  = count++;
+
+		// Skip empty files
+		if ( p_file->failed || p_file->lines == 0 ) { count--; continue; }
+
+		// Sift up
+		for (; child && tail_before(p_file, _pp_heap[( child - 1 ) / 2]); child = ( child - 1 ) / 2)
+			_pp_heap[child] = _pp_heap[( child - 1 ) / 2];
+		_pp_heap[child] = p_file;
+	}
+
+	// Write the earliest line until every file is exhausted
+	while ( count )
+	{
+
+		// Initialized data
+		struct tail_file_s *p_file = _pp_heap[0];
+		size_t              parent = 0;
+
+		// Write the line
+		fwrite(p_file->p_text + p_file->_p_starts[p_file->cursor], 1, p_file->_p_lengths[p_file->cursor], stdout);
+
+		// Separate it from the next line. Only the very last line keeps the
+		// missing newline of an unterminated file.
+		if ( count > 1 || p_file->cursor + 1 < p_file->lines || p_file->terminated ) fputc('\n', stdout);
+
+		// Advance the file, or remove it once exhausted
+		if ( ++p_file->cursor == p_file->lines ) p_file = _pp_heap[--count];
+		if ( count == 0 ) break;
+
+		// Sift down
+		for (;;)
+		{
+
+			// Initialized data
+			size_t child = 2 * parent + 1;
+
+			// No children
+			if ( child >= count ) break;
+
+			// The earlier child
+			if ( child + 1 < count && tail_before(_pp_heap[child + 1], _pp_heap[child]) ) child++;
+
+			// In order
+			if ( tail_before(p_file, _pp_heap[child]) ) break;
+
+			// Move the child up
+			_pp_heap[parent] = _pp_heap[child];
+			parent           = child;
+		}
+		_pp_heap[parent] = p_file;
+	}
+
+	// Clean up
+	free(_pp_heap);
+
+	// Done
+	return;
+}
+
+void tail_usage ( const char *p_program )
+{
+
+	// Print a usage message
+	fprintf(stderr,
+		"Usage: %s [-n lines] [-j threads] [-m] [file ...]\n"
+		"  -n lines    output the last lines of each file, default %d\n"
+		"  -j threads  read this many files at once, default one per processor\n"
+		"  -m          merge every file into one stream, ordered by the first field of each line\n"
+		"With no file, or when a file is -, read standard input.\n",
+		p_program, TAIL_DEFAULT_LINES
+	);
+
+	// Done
+	return;
 }